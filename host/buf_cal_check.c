@@ -0,0 +1,91 @@
+/*
+ * buf_cal_check.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host side check for the smart buffer speed calibration (bufCalStart).
+ *
+ *      Reads the packets received for one calibration step (raw 64-bit little
+ *      endian words, as written by the acquisition software) and checks:
+ *
+ *      -> the number of packets matches the one announced by the firmware.
+ *      -> the 4-bit packet counter (bits 63-60) increments by one each packet.
+ *      -> channel id (bits 59-56) is smart buffer channel A (0100).
+ *      -> data (bits 17-0) equals the A/D test pattern, if given (hex).
+ *
+ *      Prints the command to send back to the board and returns 0 if there
+ *      was no loss, 1 otherwise.
+ *
+ *      Build: gcc -O2 -o buf_cal_check buf_cal_check.c
+ *      Usage: buf_cal_check <file> <packets> [pattern]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#define CH_ID_SB_CHA		0x4
+#define DATA_MASK			0x3FFFF
+
+int main(int argc, char *argv[])
+{
+	if (argc != 3 && argc != 4)
+	{
+		fprintf(stderr, "Usage: %s <file> <packets> [pattern]\n", argv[0]);
+		return 2;
+	}
+
+	FILE *f = fopen(argv[1], "rb");
+	if (f == NULL)
+	{
+		perror(argv[1]);
+		return 2;
+	}
+
+	long expected = atol(argv[2]);
+	long pattern = (argc == 4) ? strtol(argv[3], NULL, 16) : -1;
+	long n = 0;
+	long gaps = 0;
+	long bad_id = 0;
+	long bad_data = 0;
+	int last = -1;
+	uint8_t b[8];
+
+	while (fread(b, 1, 8, f) == 8)
+	{
+		uint64_t w = 0;
+		for (int i=7; i>=0; i--)
+		{
+			w = (w << 8) | b[i];
+		}
+
+		int cnt 		= (w >> 60) & 0xF;
+		int id 			= (w >> 56) & 0xF;
+		uint32_t data 	= w & DATA_MASK;
+
+		if (last >= 0 && cnt != ((last + 1) & 0xF))
+		{
+			gaps++;
+		}
+		if (id != CH_ID_SB_CHA)
+		{
+			bad_id++;
+		}
+		if (pattern >= 0 && data != (uint32_t)pattern)
+		{
+			bad_data++;
+		}
+
+		last = cnt;
+		n++;
+	}
+	fclose(f);
+
+	printf("packets %ld/%ld, counter gaps %ld, bad id %ld, bad data %ld\n", n, expected, gaps, bad_id, bad_data);
+
+	int ok = (n == expected) && (gaps == 0) && (bad_id == 0) && (bad_data == 0);
+	printf("set bufCalRes %d\n", ok);
+
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,295 @@
+/*
+ * cds_filter_bench.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Benchmark of weighted CDS filters against box-car.
+ *
+ *      Takes a raw trace of empty pixels captured with the smart buffer (as
+ *      cds_optimize) and, for every number of samples N in the grid, runs the
+ *      box-car model (the core as it is) and the weighted model with each of
+ *      the given filters. SAMPLE_P = SAMPLE_S = N and every coefficient table
+ *      adds up to N, so all outputs have gain N and noise is comparable.
+ *
+ *      Filters:
+ *      -> exponential, w[i] = exp(-i/tau), one per value in -e. Index 0 is the
+ *         sample closest to the charge transfer (see cds_model.h).
+ *      -> table from a text file (-w), one "wp ws" pair per line. Evaluated only
+ *         at N = number of lines, after scaling each column to add up to N.
+ *
+ *      Noise is computed as in cds_optimize (consecutive pixel differences over
+ *      sqrt(2), divided by N). The ratio column is filter noise over box-car
+ *      noise for the same N: below 1 the filter is better at the same pixel
+ *      time, and 1/ratio^2 is the pixel time box-car would need to match it
+ *      when the noise is white.
+ *
+ *      Build: gcc -O2 -o cds_filter_bench cds_filter_bench.c cds_model.c trace.c -lm
+ *      Usage: cds_filter_bench [options] <trace>
+ *        -f raw|text     input format (raw).
+ *        -u              samples are unsigned (default two's complement).
+ *        -T -O -a -A -b -B   pixel timing, as in cds_ref.
+ *        -p n -s n       DELAY_P and DELAY_S (0).
+ *        -n min:max:step N grid.
+ *        -e t1,t2,...    exponential filter time constants in samples.
+ *        -w file         coefficient table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "cds_model.h"
+#include "trace.h"
+
+#define MAX_TAUS		16
+
+/*
+ * Noise from consecutive differences of the valid outputs, -1 if there are not
+ * enough of them.
+ */
+static double noise_diff(const double *out, const uint8_t *valid, uint32_t npix)
+{
+	double s = 0, s2 = 0;
+	uint32_t n = 0;
+	int have_last = 0;
+	double last = 0;
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		if (!valid[k])
+		{
+			continue;
+		}
+		if (have_last)
+		{
+			double d = out[k] - last;
+			s += d;
+			s2 += d*d;
+			n++;
+		}
+		last = out[k];
+		have_last = 1;
+	}
+
+	if (n < 2)
+	{
+		return -1;
+	}
+
+	double var = (s2 - s*s/n) / (n - 1);
+	return sqrt(var / 2.0);
+}
+
+/*
+ * Loads a coefficient table. Returns the number of lines, 0 on error. wp and ws
+ * are malloc'ed and scaled to add up to the number of lines.
+ */
+static uint32_t load_table(const char *fname, double **wp, double **ws)
+{
+	FILE *f = fopen(fname, "r");
+	if (f == NULL)
+	{
+		fprintf(stderr, "Cannot open %s\n", fname);
+		return 0;
+	}
+
+	uint32_t n = 0, cap = 256;
+	double a, b, sa = 0, sb = 0;
+	*wp = malloc(cap * sizeof(double));
+	*ws = malloc(cap * sizeof(double));
+	while (*wp != NULL && *ws != NULL && fscanf(f, "%lf %lf", &a, &b) == 2)
+	{
+		if (n == cap)
+		{
+			cap *= 2;
+			*wp = realloc(*wp, cap * sizeof(double));
+			*ws = realloc(*ws, cap * sizeof(double));
+			if (*wp == NULL || *ws == NULL)
+			{
+				break;
+			}
+		}
+		(*wp)[n] = a;
+		(*ws)[n] = b;
+		sa += a;
+		sb += b;
+		n++;
+	}
+	fclose(f);
+
+	if (*wp == NULL || *ws == NULL || n == 0 || sa == 0 || sb == 0)
+	{
+		fprintf(stderr, "Bad coefficient table %s\n", fname);
+		return 0;
+	}
+
+	for (uint32_t i=0; i<n; i++)
+	{
+		(*wp)[i] *= n / sa;
+		(*ws)[i] *= n / sb;
+	}
+
+	return n;
+}
+
+static double run(	const cds_model_params_t *p, const cds_model_weights_t *w,
+					const int32_t *x, uint32_t n, const cds_model_window_t *win, uint32_t npix,
+					double *out, uint8_t *valid)
+{
+	cds_model_weighted_batch(p, w, x, n, win, npix, out, valid);
+	double sigma = noise_diff(out, valid, npix);
+	return (sigma < 0) ? -1 : sigma / p->sample_p;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t period = 0, offset = 0;
+	uint32_t ped_start = 0, ped_len = 0, sig_start = 0, sig_len = 0;
+	uint32_t dp = 0, ds = 0;
+	uint32_t nmin = 1, nmax = 1, nstep = 1;
+	double taus[MAX_TAUS];
+	int ntaus = 0;
+	const char *table = NULL;
+	int raw = 1, is_unsigned = 0;
+	int c;
+
+	while ((c = getopt(argc, argv, "f:uT:O:a:A:b:B:p:s:n:e:w:")) != -1)
+	{
+		switch (c)
+		{
+		case 'f': raw = (strcmp(optarg, "text") != 0); break;
+		case 'u': is_unsigned = 1; break;
+		case 'T': period = atoi(optarg); break;
+		case 'O': offset = atoi(optarg); break;
+		case 'a': ped_start = atoi(optarg); break;
+		case 'A': ped_len = atoi(optarg); break;
+		case 'b': sig_start = atoi(optarg); break;
+		case 'B': sig_len = atoi(optarg); break;
+		case 'p': dp = atoi(optarg); break;
+		case 's': ds = atoi(optarg); break;
+		case 'w': table = optarg; break;
+		case 'n':
+			nstep = 1;
+			if (sscanf(optarg, "%u:%u:%u", &nmin, &nmax, &nstep) < 2 || nstep == 0 || nmax < nmin)
+			{
+				fprintf(stderr, "Bad range %s\n", optarg);
+				return 1;
+			}
+			break;
+		case 'e':
+			for (char *tok = strtok(optarg, ","); tok != NULL && ntaus < MAX_TAUS; tok = strtok(NULL, ","))
+			{
+				taus[ntaus++] = atof(tok);
+			}
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [options] <trace>\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc || period == 0 || nmin == 0)
+	{
+		fprintf(stderr, "Usage: %s [options] <trace> (pixel period -T is required, N >= 1)\n", argv[0]);
+		return 1;
+	}
+
+	uint32_t n;
+	int32_t *x = trace_load(argv[optind], raw, is_unsigned, &n);
+	if (x == NULL)
+	{
+		return 1;
+	}
+
+	uint32_t npix = (n > offset) ? (n - offset) / period : 0;
+	if (npix < 3)
+	{
+		fprintf(stderr, "Trace too short: %u pixels\n", npix);
+		return 1;
+	}
+
+	double *wtp = NULL, *wts = NULL;
+	uint32_t ntable = 0;
+	if (table != NULL && (ntable = load_table(table, &wtp, &wts)) == 0)
+	{
+		return 1;
+	}
+
+	uint32_t wmax = (nmax > ntable) ? nmax : ntable;
+	cds_model_window_t *win = malloc(npix * sizeof(cds_model_window_t));
+	double *out = malloc(npix * sizeof(double));
+	uint8_t *valid = malloc(npix);
+	double *box = malloc(wmax * sizeof(double));
+	double *wexp = malloc(wmax * sizeof(double));
+	if (win == NULL || out == NULL || valid == NULL || box == NULL || wexp == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		uint32_t base 		= offset + k*period;
+		win[k].ped_start 	= base + ped_start;
+		win[k].ped_len 		= ped_len;
+		win[k].sig_start 	= base + sig_start;
+		win[k].sig_len 		= sig_len;
+	}
+	cds_model_weights_exp(box, wmax, 0);
+
+	printf("%u pixels, pinit %u, sinit %u\n\n", npix, dp, ds);
+	printf("N\tfilter\t\tnoise[ADU]\tratio\n");
+
+	uint32_t ped_avail = (ped_len > CDS_MODEL_BUFFER_LENGTH) ? CDS_MODEL_BUFFER_LENGTH : ped_len;
+	for (uint32_t ns=nmin; ns<=nmax; ns+=nstep)
+	{
+		// Must fit in the windows, otherwise the core truncates.
+		if (dp + ns > ped_avail || ds + ns > sig_len)
+		{
+			continue;
+		}
+
+		cds_model_params_t p = { dp, ds, ns, ns, CDS_MODEL_OUTSEL_SIG_m_PED };
+		cds_model_weights_t w = { box, box };
+
+		double nbox = run(&p, &w, x, n, win, npix, out, valid);
+		if (nbox <= 0)
+		{
+			continue;
+		}
+		printf("%u\tbox-car\t\t%.3f\t\t1.000\n", ns, nbox);
+
+		for (int t=0; t<ntaus; t++)
+		{
+			cds_model_weights_exp(wexp, ns, taus[t]);
+			w.wp = wexp;
+			w.ws = wexp;
+			double nf = run(&p, &w, x, n, win, npix, out, valid);
+			printf("%u\texp %.1f\t%.3f\t\t%.3f\n", ns, taus[t], nf, nf / nbox);
+		}
+	}
+
+	if (ntable > 0)
+	{
+		if (dp + ntable > ped_avail || ds + ntable > sig_len)
+		{
+			fprintf(stderr, "Coefficient table does not fit in the windows\n");
+			return 1;
+		}
+
+		cds_model_params_t p = { dp, ds, ntable, ntable, CDS_MODEL_OUTSEL_SIG_m_PED };
+		cds_model_weights_t w = { box, box };
+		double nbox = run(&p, &w, x, n, win, npix, out, valid);
+
+		w.wp = wtp;
+		w.ws = wts;
+		double nf = run(&p, &w, x, n, win, npix, out, valid);
+		printf("%u\tbox-car\t\t%.3f\t\t1.000\n", ntable, nbox);
+		printf("%u\ttable\t\t%.3f\t\t%.3f\n", ntable, nf, nf / nbox);
+	}
+
+	return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * cds_model.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <math.h>
+
+#include "cds_model.h"
+
+static int32_t cds_model_out(const cds_model_params_t *p, uint32_t acc_p, uint32_t acc_s)
+{
+	// 32-bit wrap around, as the hardware.
+	switch (p->outsel & 0x3)
+	{
+	case CDS_MODEL_OUTSEL_PED:
+		return (int32_t)acc_p;
+	case CDS_MODEL_OUTSEL_SIG:
+		return (int32_t)acc_s;
+	case CDS_MODEL_OUTSEL_SIG_m_PED:
+		return (int32_t)(acc_s - acc_p);
+	default:
+		return (int32_t)(acc_p - acc_s);
+	}
+}
+
+// Number of pedestal samples actually accumulated.
+static uint32_t cds_model_np(const cds_model_params_t *p, uint32_t nped)
+{
+	uint32_t m = (nped > CDS_MODEL_BUFFER_LENGTH) ? CDS_MODEL_BUFFER_LENGTH : nped;
+	if (p->delay_p >= m)
+	{
+		return 0;
+	}
+	uint32_t avail = m - p->delay_p;
+	return (p->sample_p < avail) ? p->sample_p : avail;
+}
+
+// Number of signal samples actually accumulated.
+static uint32_t cds_model_ns(const cds_model_params_t *p, uint32_t nsig)
+{
+	if (p->delay_s >= nsig)
+	{
+		return 0;
+	}
+	uint32_t avail = nsig - p->delay_s;
+	return (p->sample_s < avail) ? p->sample_s : avail;
+}
+
+int cds_model_pixel(const cds_model_params_t *p,
+					const int32_t *ped, uint32_t nped,
+					const int32_t *sig, uint32_t nsig,
+					int32_t *out)
+{
+	uint32_t acc_p = 0;
+	uint32_t acc_s = 0;
+	uint32_t i;
+
+	// Pedestal: newest samples first discarded, then accumulated.
+	uint32_t np = cds_model_np(p, nped);
+	uint32_t end = nped - p->delay_p;
+	for (i=end-np; i<end; i++)
+	{
+		acc_p += (uint32_t)ped[i];
+	}
+
+	// Signal: first samples discarded, then accumulated.
+	uint32_t ns = cds_model_ns(p, nsig);
+	for (i=p->delay_s; i<p->delay_s+ns; i++)
+	{
+		acc_s += (uint32_t)sig[i];
+	}
+
+	if (np == 0)
+	{
+		return 0;
+	}
+
+	*out = cds_model_out(p, acc_p, acc_s);
+	return 1;
+}
+
+void cds_model_prefix(const int32_t *x, uint32_t n, int64_t *ps)
+{
+	ps[0] = 0;
+	for (uint32_t i=0; i<n; i++)
+	{
+		ps[i+1] = ps[i] + x[i];
+	}
+}
+
+// Clips window [start, start+len) to a trace of n samples, returns length.
+static uint32_t cds_model_clip(uint32_t start, uint32_t len, uint32_t n)
+{
+	if (start >= n)
+	{
+		return 0;
+	}
+	return (len > n - start) ? n - start : len;
+}
+
+uint32_t cds_model_batch(	const cds_model_params_t *p,
+							const int64_t *ps, uint32_t n,
+							const cds_model_window_t *win, uint32_t npix,
+							int32_t *out, uint8_t *valid)
+{
+	uint32_t nvalid = 0;
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		uint32_t nped = cds_model_clip(win[k].ped_start, win[k].ped_len, n);
+		uint32_t nsig = cds_model_clip(win[k].sig_start, win[k].sig_len, n);
+
+		uint32_t np = cds_model_np(p, nped);
+		uint32_t ns = cds_model_ns(p, nsig);
+
+		uint32_t pend = win[k].ped_start + nped - p->delay_p;
+		uint32_t sbeg = win[k].sig_start + p->delay_s;
+
+		// Low 32 bits of the exact sum are the wrapped accumulator.
+		uint32_t acc_p = (np > 0) ? (uint32_t)(ps[pend] - ps[pend-np]) : 0;
+		uint32_t acc_s = (ns > 0) ? (uint32_t)(ps[sbeg+ns] - ps[sbeg]) : 0;
+
+		valid[k] = (np > 0);
+		out[k] = valid[k] ? cds_model_out(p, acc_p, acc_s) : 0;
+		nvalid += valid[k];
+	}
+
+	return nvalid;
+}
+
+uint32_t cds_model_weighted_batch(	const cds_model_params_t *p,
+									const cds_model_weights_t *w,
+									const int32_t *x, uint32_t n,
+									const cds_model_window_t *win, uint32_t npix,
+									double *out, uint8_t *valid)
+{
+	uint32_t nvalid = 0;
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		uint32_t nped = cds_model_clip(win[k].ped_start, win[k].ped_len, n);
+		uint32_t nsig = cds_model_clip(win[k].sig_start, win[k].sig_len, n);
+
+		uint32_t np = cds_model_np(p, nped);
+		uint32_t ns = cds_model_ns(p, nsig);
+
+		// Newest accumulated pedestal sample and first accumulated signal sample.
+		uint32_t pend = win[k].ped_start + nped - p->delay_p;
+		uint32_t sbeg = win[k].sig_start + p->delay_s;
+
+		double acc_p = 0;
+		double acc_s = 0;
+		uint32_t i;
+
+		for (i=0; i<np; i++)
+		{
+			acc_p += w->wp[i] * x[pend-1-i];
+		}
+		for (i=0; i<ns; i++)
+		{
+			acc_s += w->ws[i] * x[sbeg+i];
+		}
+
+		valid[k] = (np > 0);
+		switch (p->outsel & 0x3)
+		{
+		case CDS_MODEL_OUTSEL_PED:
+			out[k] = acc_p;
+			break;
+		case CDS_MODEL_OUTSEL_SIG:
+			out[k] = acc_s;
+			break;
+		case CDS_MODEL_OUTSEL_SIG_m_PED:
+			out[k] = acc_s - acc_p;
+			break;
+		default:
+			out[k] = acc_p - acc_s;
+			break;
+		}
+		if (!valid[k])
+		{
+			out[k] = 0;
+		}
+		nvalid += valid[k];
+	}
+
+	return nvalid;
+}
+
+void cds_model_weights_exp(double *w, uint32_t n, double tau)
+{
+	double sum = 0;
+	uint32_t i;
+
+	for (i=0; i<n; i++)
+	{
+		w[i] = (tau > 0) ? exp(-(double)i / tau) : 1.0;
+		sum += w[i];
+	}
+	for (i=0; i<n; i++)
+	{
+		w[i] *= n / sum;
+	}
+}
+
+int32_t cds_model_sext18(uint32_t raw)
+{
+	raw &= 0x3FFFF;
+	return (raw & 0x20000) ? (int32_t)raw - 0x40000 : (int32_t)raw;
+}
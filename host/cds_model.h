@@ -0,0 +1,118 @@
+/*
+ * cds_model.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Bit-exact reference model of the CDS core (see inc/cds_core.h).
+ *
+ *      Pedestal: the core keeps the newest CDS_MODEL_BUFFER_LENGTH samples of the
+ *      pedestal window. DELAY_P newest samples are discarded and the previous
+ *      SAMPLE_P samples are accumulated. If there are not enough samples, only
+ *      the available ones are accumulated:
+ *
+ *      Np_actual = min(SAMPLE_P, min(N, 4096) - DELAY_P), 0 if negative.
+ *
+ *      If Np_actual is 0 the core does not generate an output packet.
+ *
+ *      Signal: DELAY_S first samples are discarded and the next SAMPLE_S samples
+ *      are accumulated. Samples beyond the end of the signal window are not
+ *      accumulated, extra samples are ignored.
+ *
+ *      Accumulators and output are 32-bit two's complement and wrap around like
+ *      the hardware does.
+ *
+ *      The batch function uses prefix sums, so each pixel costs O(1) regardless
+ *      of the window lengths.
+ *
+ *      Weighted CDS: same windows, truncation and output selection as the core,
+ *      but every accumulated sample is multiplied by a coefficient. This mode is
+ *      not in the hardware, it is here to evaluate filters before moving them
+ *      to the FPGA. wp[i] applies to the i-th accumulated pedestal sample counted
+ *      back from the newest one, ws[i] to the i-th accumulated signal sample
+ *      counted from the first one. Index 0 is always the sample closest to the
+ *      charge transfer, and truncated windows drop the far end of the tables.
+ */
+
+#ifndef CDS_MODEL_H_
+#define CDS_MODEL_H_
+
+#include <stdint.h>
+
+#define CDS_MODEL_BUFFER_LENGTH		4096
+
+// Same values as CDS_CORE_OUTSEL_*.
+#define CDS_MODEL_OUTSEL_PED			0
+#define CDS_MODEL_OUTSEL_SIG			1
+#define CDS_MODEL_OUTSEL_SIG_m_PED		2
+#define CDS_MODEL_OUTSEL_PED_m_SIG		3
+
+typedef struct {
+	uint16_t delay_p;
+	uint16_t delay_s;
+	uint16_t sample_p;
+	uint16_t sample_s;
+	uint8_t outsel;
+} cds_model_params_t;
+
+// Pedestal and signal windows of one pixel, as sample indexes in a trace.
+typedef struct {
+	uint32_t ped_start;
+	uint32_t ped_len;
+	uint32_t sig_start;
+	uint32_t sig_len;
+} cds_model_window_t;
+
+/*
+ * Straightforward model of one pixel. Returns 1 if the core generates an output,
+ * 0 otherwise.
+ */
+int cds_model_pixel(const cds_model_params_t *p,
+					const int32_t *ped, uint32_t nped,
+					const int32_t *sig, uint32_t nsig,
+					int32_t *out);
+
+/*
+ * Prefix sum of a trace: ps[0] = 0, ps[i+1] = ps[i] + x[i]. ps must hold n+1
+ * values.
+ */
+void cds_model_prefix(const int32_t *x, uint32_t n, int64_t *ps);
+
+/*
+ * Batch model over npix pixels of a trace, given its prefix sum (n+1 values).
+ * valid[i] is set to 1 if pixel i generates an output. Windows falling outside
+ * the trace are truncated at its end. Returns the number of valid outputs.
+ */
+uint32_t cds_model_batch(	const cds_model_params_t *p,
+							const int64_t *ps, uint32_t n,
+							const cds_model_window_t *win, uint32_t npix,
+							int32_t *out, uint8_t *valid);
+
+// Coefficient tables for the weighted model, SAMPLE_P and SAMPLE_S values.
+typedef struct {
+	const double *wp;
+	const double *ws;
+} cds_model_weights_t;
+
+/*
+ * Weighted model over npix pixels of a trace. valid[i] is set as in
+ * cds_model_batch. Returns the number of valid outputs.
+ */
+uint32_t cds_model_weighted_batch(	const cds_model_params_t *p,
+									const cds_model_weights_t *w,
+									const int32_t *x, uint32_t n,
+									const cds_model_window_t *win, uint32_t npix,
+									double *out, uint8_t *valid);
+
+/*
+ * Exponential coefficients, w[i] = exp(-i/tau), scaled so that they add up to
+ * n (same gain as box-car). tau <= 0 gives box-car (all ones).
+ */
+void cds_model_weights_exp(double *w, uint32_t n, double tau);
+
+/*
+ * Sign extends an 18-bit raw A/D sample.
+ */
+int32_t cds_model_sext18(uint32_t raw);
+
+#endif /* CDS_MODEL_H_ */
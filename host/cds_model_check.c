@@ -0,0 +1,304 @@
+/*
+ * cds_model_check.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Checks of the CDS reference model (cds_model.c) against the behavior
+ *      documented in inc/cds_core.h:
+ *
+ *      -> the worked example of the header.
+ *      -> pedestal and signal truncation when there are too few samples.
+ *      -> pedestal longer than the 4096 samples of the buffer, only the
+ *         newest ones are kept.
+ *      -> no output when no pedestal sample is accumulated.
+ *      -> the four OUTSEL modes and the 32-bit wrap around.
+ *      -> cds_model_batch gives the same as cds_model_pixel on random
+ *         parameters and windows, windows past the end of the trace included.
+ *
+ *      Build: gcc -O2 -o cds_model_check cds_model_check.c cds_model.c -lm
+ *      Usage: cds_model_check [seed]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "cds_model.h"
+
+#define CHECK_TRACE_LENGTH		200000
+#define CHECK_NPIX				5000
+#define CHECK_RUNS				100
+
+static int errors;
+
+static void check(const char *what, int64_t got, int64_t expected)
+{
+	if (got != expected)
+	{
+		printf("%s: got %lld, expected %lld\n", what, (long long) got, (long long) expected);
+		errors++;
+	}
+}
+
+// Runs the pixel model, 0x7FFFFFFF as output if there is none.
+static int32_t pixel(const cds_model_params_t *p, const int32_t *ped, uint32_t nped,
+					const int32_t *sig, uint32_t nsig, int *valid)
+{
+	int32_t out = 0x7FFFFFFF;
+	*valid = cds_model_pixel(p, ped, nped, sig, nsig, &out);
+	return out;
+}
+
+// DELAY_P = 1, SAMPLE_P = 3, DELAY_S = 2, SAMPLE_S = 4, 11 pedestal and 9
+// signal samples: acc_p = p[7] + p[8] + p[9], acc_s = s[2] + ... + s[5].
+static void check_example(void)
+{
+	cds_model_params_t p = {1, 2, 3, 4, CDS_MODEL_OUTSEL_SIG_m_PED};
+	int32_t x[20];
+	int64_t ps[21];
+	int valid;
+
+	// One bit per sample, the result tells which ones were added.
+	for (int i=0; i<20; i++)
+	{
+		x[i] = 1 << i;
+	}
+	int32_t acc_p = x[7] + x[8] + x[9];
+	int32_t acc_s = x[11+2] + x[11+3] + x[11+4] + x[11+5];
+
+	check("example", pixel(&p, x, 11, x + 11, 9, &valid), acc_s - acc_p);
+	check("example valid", valid, 1);
+
+	cds_model_window_t win = {0, 11, 11, 9};
+	int32_t out;
+	uint8_t v;
+	cds_model_prefix(x, 20, ps);
+	check("example batch", cds_model_batch(&p, ps, 20, &win, 1, &out, &v), 1);
+	check("example batch", out, acc_s - acc_p);
+}
+
+static void check_truncation(void)
+{
+	int32_t x[16];
+	int valid;
+
+	for (int i=0; i<16; i++)
+	{
+		x[i] = 1 << i;
+	}
+
+	// 5 pedestal samples, 2 discarded: the 3 oldest are accumulated.
+	cds_model_params_t p = {2, 0, 10, 1, CDS_MODEL_OUTSEL_PED};
+	check("short pedestal", pixel(&p, x, 5, x, 1, &valid), x[0] + x[1] + x[2]);
+	check("short pedestal valid", valid, 1);
+
+	// 6 signal samples, 3 discarded: only the last 3 are accumulated.
+	p = (cds_model_params_t) {0, 3, 1, 10, CDS_MODEL_OUTSEL_SIG};
+	check("short signal", pixel(&p, x, 1, x, 6, &valid), x[3] + x[4] + x[5]);
+	check("short signal valid", valid, 1);
+
+	// Signal all discarded: still an output, with acc_s = 0.
+	p = (cds_model_params_t) {0, 8, 1, 10, CDS_MODEL_OUTSEL_SIG_m_PED};
+	check("no signal", pixel(&p, x + 4, 1, x, 6, &valid), -x[4]);
+	check("no signal valid", valid, 1);
+
+	// Extra signal samples are ignored.
+	p = (cds_model_params_t) {0, 1, 1, 2, CDS_MODEL_OUTSEL_SIG};
+	check("long signal", pixel(&p, x, 1, x, 16, &valid), x[1] + x[2]);
+}
+
+// More pedestal samples than the buffer holds: only the newest 4096 are left.
+static void check_buffer(void)
+{
+	uint32_t nped = CDS_MODEL_BUFFER_LENGTH + 904;
+	int32_t *x = malloc(nped * sizeof(int32_t));
+	int valid;
+
+	for (uint32_t i=0; i<nped; i++)
+	{
+		x[i] = i;
+	}
+
+	// Everything in the buffer.
+	cds_model_params_t p = {0, 0, 65535, 1, CDS_MODEL_OUTSEL_PED};
+	int64_t sum = 0;
+	for (uint32_t i=nped-CDS_MODEL_BUFFER_LENGTH; i<nped; i++)
+	{
+		sum += x[i];
+	}
+	check("buffer overflow", pixel(&p, x, nped, x, 1, &valid), sum);
+
+	// Delay comes out of the 4096 too.
+	p.delay_p = 10;
+	sum = 0;
+	for (uint32_t i=nped-CDS_MODEL_BUFFER_LENGTH; i<nped-10; i++)
+	{
+		sum += x[i];
+	}
+	check("buffer overflow, delay", pixel(&p, x, nped, x, 1, &valid), sum);
+
+	// Delay as long as the buffer: nothing left, even with more samples.
+	p.delay_p = CDS_MODEL_BUFFER_LENGTH;
+	pixel(&p, x, nped, x, 1, &valid);
+	check("buffer overflow, delay 4096 valid", valid, 0);
+
+	free(x);
+}
+
+static void check_no_pedestal(void)
+{
+	int32_t x[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+	int64_t ps[9];
+	int valid;
+
+	cds_model_params_t p = {4, 0, 2, 2, CDS_MODEL_OUTSEL_SIG};
+	pixel(&p, x, 4, x, 8, &valid);
+	check("delay_p = npedestal valid", valid, 0);
+	pixel(&p, x, 0, x, 8, &valid);
+	check("no pedestal samples valid", valid, 0);
+	p = (cds_model_params_t) {0, 0, 0, 2, CDS_MODEL_OUTSEL_SIG};
+	pixel(&p, x, 4, x, 8, &valid);
+	check("sample_p = 0 valid", valid, 0);
+
+	// Batch: pedestal window past the end of the trace.
+	cds_model_window_t win = {8, 4, 0, 8};
+	int32_t out = 1;
+	uint8_t v = 1;
+	cds_model_prefix(x, 8, ps);
+	p.sample_p = 2;
+	check("batch no pedestal", cds_model_batch(&p, ps, 8, &win, 1, &out, &v), 0);
+	check("batch no pedestal valid", v, 0);
+	check("batch no pedestal out", out, 0);
+}
+
+static void check_outsel(void)
+{
+	int32_t ped[4] = {10, 20, 30, 40};
+	int32_t sig[4] = {1, 2, 3, 4};
+	cds_model_params_t p = {0, 0, 4, 4, 0};
+	int valid;
+
+	int32_t expected[4] = {100, 10, 10 - 100, 100 - 10};
+	for (int o=0; o<4; o++)
+	{
+		p.outsel = o;
+		check("outsel", pixel(&p, ped, 4, sig, 4, &valid), expected[o]);
+	}
+
+	// Largest 18-bit samples over a long signal window wrap the 32-bit
+	// accumulator.
+	uint32_t n = 40000;
+	int32_t *x = malloc(n * sizeof(int32_t));
+	for (uint32_t i=0; i<n; i++)
+	{
+		x[i] = cds_model_sext18(0x1FFFF);
+	}
+	uint32_t acc = 0x1FFFF * n;
+	p = (cds_model_params_t) {0, 0, 4, 40000, CDS_MODEL_OUTSEL_SIG};
+	check("wrap sig", pixel(&p, ped, 4, x, n, &valid), (int32_t) acc);
+	p.outsel = CDS_MODEL_OUTSEL_SIG_m_PED;
+	check("wrap sig - ped", pixel(&p, ped, 4, x, n, &valid), (int32_t) (acc - 100));
+	p.outsel = CDS_MODEL_OUTSEL_PED_m_SIG;
+	check("wrap ped - sig", pixel(&p, ped, 4, x, n, &valid), (int32_t) (100 - acc));
+
+	// Same with the most negative sample.
+	for (uint32_t i=0; i<n; i++)
+	{
+		x[i] = cds_model_sext18(0x20000);
+	}
+	check("sext18", x[0], -131072);
+	acc = (uint32_t) -131072 * n;
+	p.outsel = CDS_MODEL_OUTSEL_SIG;
+	check("wrap negative sig", pixel(&p, ped, 4, x, n, &valid), (int32_t) acc);
+
+	free(x);
+}
+
+// Batch against pixel on random parameters and windows.
+static void check_batch(void)
+{
+	int32_t *x = malloc(CHECK_TRACE_LENGTH * sizeof(int32_t));
+	int64_t *ps = malloc((CHECK_TRACE_LENGTH + 1) * sizeof(int64_t));
+	cds_model_window_t *win = malloc(CHECK_NPIX * sizeof(cds_model_window_t));
+	int32_t *out = malloc(CHECK_NPIX * sizeof(int32_t));
+	uint8_t *valid = malloc(CHECK_NPIX);
+	uint32_t nvalid = 0;
+
+	if (x == NULL || ps == NULL || win == NULL || out == NULL || valid == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		exit(1);
+	}
+
+	for (uint32_t i=0; i<CHECK_TRACE_LENGTH; i++)
+	{
+		x[i] = cds_model_sext18(rand() & 0x3FFFF);
+	}
+	cds_model_prefix(x, CHECK_TRACE_LENGTH, ps);
+
+	for (int run=0; run<CHECK_RUNS && errors == 0; run++)
+	{
+		// Long delays too, now and then.
+		uint32_t max_delay = (run % 4 == 3) ? 5000 : 64;
+		cds_model_params_t p;
+		p.delay_p 	= rand() % max_delay;
+		p.delay_s 	= rand() % max_delay;
+		p.sample_p 	= rand() % 6000;
+		p.sample_s 	= rand() % 6000;
+		p.outsel 	= rand() % 4;
+
+		// Some windows run past the end of the trace, some past the buffer.
+		for (uint32_t k=0; k<CHECK_NPIX; k++)
+		{
+			win[k].ped_start 	= rand() % CHECK_TRACE_LENGTH;
+			win[k].ped_len 		= rand() % 6000;
+			win[k].sig_start 	= rand() % CHECK_TRACE_LENGTH;
+			win[k].sig_len 		= rand() % 6000;
+		}
+
+		nvalid += cds_model_batch(&p, ps, CHECK_TRACE_LENGTH, win, CHECK_NPIX, out, valid);
+
+		for (uint32_t k=0; k<CHECK_NPIX; k++)
+		{
+			uint32_t nped = CHECK_TRACE_LENGTH - win[k].ped_start;
+			uint32_t nsig = CHECK_TRACE_LENGTH - win[k].sig_start;
+			nped = (win[k].ped_len < nped) ? win[k].ped_len : nped;
+			nsig = (win[k].sig_len < nsig) ? win[k].sig_len : nsig;
+
+			int v;
+			int32_t o = pixel(&p, x + win[k].ped_start, nped, x + win[k].sig_start, nsig, &v);
+			if (v != valid[k] || (v && o != out[k]))
+			{
+				printf("batch: pixel %u (%u %u %u %u), batch %d/%d, pixel %d/%d\n",
+						k, p.delay_p, p.sample_p, p.delay_s, p.sample_s, valid[k], out[k], v, o);
+				errors++;
+				break;
+			}
+		}
+	}
+
+	printf("batch: %u valid outputs compared\n", nvalid);
+
+	free(x);
+	free(ps);
+	free(win);
+	free(out);
+	free(valid);
+}
+
+int main(int argc, char *argv[])
+{
+	srand((argc > 1) ? atoi(argv[1]) : 1);
+
+	check_example();
+	check_truncation();
+	check_buffer();
+	check_no_pedestal();
+	check_outsel();
+	check_batch();
+
+	printf("%s\n", errors ? "FAILED" : "OK");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,269 @@
+/*
+ * cds_optimize.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      CDS window optimizer.
+ *
+ *      Takes a raw trace of empty pixels (e.g. overscan) captured with the smart
+ *      buffer through the packer (packSource 4, RAW from Smart Buffer) and runs
+ *      the CDS reference model over a grid of DELAY_P, DELAY_S and number of
+ *      samples N (SAMPLE_P = SAMPLE_S = N, so the output gain is N).
+ *
+ *      For each setting:
+ *      -> noise : standard deviation of the difference between consecutive
+ *                 pixels over sqrt(2), divided by N. This is the readout noise
+ *                 in ADU, and slow drifts in the baseline do not affect it.
+ *      -> time  : samples used by the setting in one pixel,
+ *                 DELAY_P + N + DELAY_S + N + overhead.
+ *      -> merit : noise^2 * time. For white noise this stays constant, so a
+ *                 lower value means less noise for the same readout time.
+ *
+ *      Settings that do not fit in the pedestal/signal windows of the trace are
+ *      skipped, as the core would truncate them. The best settings are listed,
+ *      followed by the commands that program the best one on the board (each
+ *      "set" ends in cds_core_change_var_value).
+ *
+ *      Build: gcc -O2 -o cds_optimize cds_optimize.c cds_model.c trace.c -lm
+ *      Usage: cds_optimize [options] <trace>
+ *        -f raw|text     input format (raw).
+ *        -u              samples are unsigned (default two's complement).
+ *        -T -O -a -A -b -B   pixel timing, as in cds_ref.
+ *        -p min:max:step DELAY_P grid.
+ *        -s min:max:step DELAY_S grid.
+ *        -n min:max:step N grid.
+ *        -F n            fixed overhead per pixel in samples (0).
+ *        -t n            maximum time per pixel in samples (no limit).
+ *        -k n            number of settings listed (10).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "cds_model.h"
+#include "trace.h"
+
+typedef struct {
+	uint32_t min;
+	uint32_t max;
+	uint32_t step;
+} range_t;
+
+typedef struct {
+	cds_model_params_t p;
+	double noise;
+	uint32_t time;
+	double merit;
+} result_t;
+
+static int parse_range(const char *str, range_t *r)
+{
+	unsigned int a, b, c = 1;
+	int n = sscanf(str, "%u:%u:%u", &a, &b, &c);
+	if (n < 2 || c == 0 || b < a)
+	{
+		return -1;
+	}
+	r->min = a;
+	r->max = b;
+	r->step = c;
+	return 0;
+}
+
+static int cmp_merit(const void *a, const void *b)
+{
+	const result_t *ra = a;
+	const result_t *rb = b;
+	return (ra->merit > rb->merit) - (ra->merit < rb->merit);
+}
+
+/*
+ * Noise from consecutive differences of the valid outputs.
+ */
+static double noise_diff(const int32_t *out, const uint8_t *valid, uint32_t npix, uint32_t *ndiff)
+{
+	double s = 0, s2 = 0;
+	uint32_t n = 0;
+	int have_last = 0;
+	int32_t last = 0;
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		if (!valid[k])
+		{
+			continue;
+		}
+		if (have_last)
+		{
+			double d = (double)out[k] - (double)last;
+			s += d;
+			s2 += d*d;
+			n++;
+		}
+		last = out[k];
+		have_last = 1;
+	}
+
+	*ndiff = n;
+	if (n < 2)
+	{
+		return -1;
+	}
+
+	double var = (s2 - s*s/n) / (n - 1);
+	return sqrt(var / 2.0);
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t period = 0, offset = 0;
+	uint32_t ped_start = 0, ped_len = 0, sig_start = 0, sig_len = 0;
+	uint32_t overhead = 0, tmax = 0, nlist = 10;
+	range_t rdp = { 0, 0, 1 };
+	range_t rds = { 0, 0, 1 };
+	range_t rn = { 1, 1, 1 };
+	int raw = 1, is_unsigned = 0;
+	int c;
+
+	while ((c = getopt(argc, argv, "f:uT:O:a:A:b:B:p:s:n:F:t:k:")) != -1)
+	{
+		switch (c)
+		{
+		case 'f': raw = (strcmp(optarg, "text") != 0); break;
+		case 'u': is_unsigned = 1; break;
+		case 'T': period = atoi(optarg); break;
+		case 'O': offset = atoi(optarg); break;
+		case 'a': ped_start = atoi(optarg); break;
+		case 'A': ped_len = atoi(optarg); break;
+		case 'b': sig_start = atoi(optarg); break;
+		case 'B': sig_len = atoi(optarg); break;
+		case 'F': overhead = atoi(optarg); break;
+		case 't': tmax = atoi(optarg); break;
+		case 'k': nlist = atoi(optarg); break;
+		case 'p':
+			if (parse_range(optarg, &rdp)) { fprintf(stderr, "Bad range %s\n", optarg); return 1; }
+			break;
+		case 's':
+			if (parse_range(optarg, &rds)) { fprintf(stderr, "Bad range %s\n", optarg); return 1; }
+			break;
+		case 'n':
+			if (parse_range(optarg, &rn)) { fprintf(stderr, "Bad range %s\n", optarg); return 1; }
+			break;
+		default:
+			fprintf(stderr, "Usage: %s [options] <trace>\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc || period == 0 || rn.min == 0)
+	{
+		fprintf(stderr, "Usage: %s [options] <trace> (pixel period -T is required, N >= 1)\n", argv[0]);
+		return 1;
+	}
+
+	uint32_t n;
+	int32_t *x = trace_load(argv[optind], raw, is_unsigned, &n);
+	if (x == NULL)
+	{
+		return 1;
+	}
+
+	uint32_t npix = (n > offset) ? (n - offset) / period : 0;
+	if (npix < 3)
+	{
+		fprintf(stderr, "Trace too short: %u pixels\n", npix);
+		return 1;
+	}
+
+	int64_t *ps = malloc((n + 1) * sizeof(int64_t));
+	cds_model_window_t *win = malloc(npix * sizeof(cds_model_window_t));
+	int32_t *out = malloc(npix * sizeof(int32_t));
+	uint8_t *valid = malloc(npix);
+	size_t ngrid = (size_t)((rdp.max - rdp.min)/rdp.step + 1) *
+				   ((rds.max - rds.min)/rds.step + 1) *
+				   ((rn.max - rn.min)/rn.step + 1);
+	result_t *res = malloc(ngrid * sizeof(result_t));
+	if (ps == NULL || win == NULL || out == NULL || valid == NULL || res == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		uint32_t base 		= offset + k*period;
+		win[k].ped_start 	= base + ped_start;
+		win[k].ped_len 		= ped_len;
+		win[k].sig_start 	= base + sig_start;
+		win[k].sig_len 		= sig_len;
+	}
+	cds_model_prefix(x, n, ps);
+
+	// Grid search.
+	size_t nres = 0;
+	for (uint32_t dp=rdp.min; dp<=rdp.max; dp+=rdp.step)
+	{
+		for (uint32_t ds=rds.min; ds<=rds.max; ds+=rds.step)
+		{
+			for (uint32_t ns=rn.min; ns<=rn.max; ns+=rn.step)
+			{
+				// Must fit in the windows, otherwise the core truncates.
+				uint32_t ped_avail = (ped_len > CDS_MODEL_BUFFER_LENGTH) ? CDS_MODEL_BUFFER_LENGTH : ped_len;
+				if (dp + ns > ped_avail || ds + ns > sig_len)
+				{
+					continue;
+				}
+
+				uint32_t time = dp + ns + ds + ns + overhead;
+				if (tmax && time > tmax)
+				{
+					continue;
+				}
+
+				cds_model_params_t p = { dp, ds, ns, ns, CDS_MODEL_OUTSEL_SIG_m_PED };
+				cds_model_batch(&p, ps, n, win, npix, out, valid);
+
+				uint32_t ndiff;
+				double sigma = noise_diff(out, valid, npix, &ndiff);
+				if (sigma < 0)
+				{
+					continue;
+				}
+
+				res[nres].p 	= p;
+				res[nres].noise = sigma / ns;
+				res[nres].time 	= time;
+				res[nres].merit = res[nres].noise * res[nres].noise * time;
+				nres++;
+			}
+		}
+	}
+
+	if (nres == 0)
+	{
+		fprintf(stderr, "No setting fits in the given windows\n");
+		return 1;
+	}
+
+	qsort(res, nres, sizeof(result_t), cmp_merit);
+
+	printf("%u pixels, %zu settings evaluated\n\n", npix, nres);
+	printf("pinit\tsinit\tpsamp\tssamp\tnoise[ADU]\ttime[samples]\tmerit\n");
+	for (size_t i=0; i<nres && i<nlist; i++)
+	{
+		printf("%u\t%u\t%u\t%u\t%.3f\t\t%u\t\t%.3f\n",
+				res[i].p.delay_p, res[i].p.delay_s, res[i].p.sample_p, res[i].p.sample_s,
+				res[i].noise, res[i].time, res[i].merit);
+	}
+
+	printf("\nset pinit %u\n", res[0].p.delay_p);
+	printf("set sinit %u\n", res[0].p.delay_s);
+	printf("set psamp %u\n", res[0].p.sample_p);
+	printf("set ssamp %u\n", res[0].p.sample_s);
+
+	return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * cds_ref.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Runs the CDS reference model (cds_model.c) on a raw smart buffer trace.
+ *
+ *      The trace has no sequencer information, so the pixel timing is given in
+ *      samples: pixel k has its pedestal window at offset + k*period + ped_start
+ *      and its signal window at offset + k*period + sig_start.
+ *
+ *      Input formats:
+ *      -> raw  : 64-bit little endian packets from the packer (source RAW from
+ *                Smart Buffer), data in bits 17-0.
+ *      -> text : one sample per line.
+ *
+ *      With -c, the output is compared against the CDS packets sent by the board
+ *      (64-bit little endian, data in bits 31-0) and mismatches are reported.
+ *
+ *      Build: gcc -O2 -o cds_ref cds_ref.c cds_model.c trace.c -lm
+ *      Usage: cds_ref [options] <trace>
+ *        -f raw|text   input format (raw).
+ *        -u            samples are unsigned (default two's complement).
+ *        -p n -P n     DELAY_P, SAMPLE_P (pinit, psamp).
+ *        -s n -S n     DELAY_S, SAMPLE_S (sinit, ssamp).
+ *        -o n          OUTSEL (cdsout, default 2).
+ *        -T n          pixel period in samples.
+ *        -O n          offset of the first pixel in samples.
+ *        -a n -A n     pedestal window start and length within the pixel.
+ *        -b n -B n     signal window start and length within the pixel.
+ *        -c file       compare against board output.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cds_model.h"
+#include "trace.h"
+
+int main(int argc, char *argv[])
+{
+	cds_model_params_t p = { 1, 1, 1, 1, CDS_MODEL_OUTSEL_SIG_m_PED };
+	uint32_t period = 0, offset = 0;
+	uint32_t ped_start = 0, ped_len = 0, sig_start = 0, sig_len = 0;
+	int raw = 1, is_unsigned = 0;
+	const char *cmp = NULL;
+	int c;
+
+	while ((c = getopt(argc, argv, "f:up:P:s:S:o:T:O:a:A:b:B:c:")) != -1)
+	{
+		switch (c)
+		{
+		case 'f': raw = (strcmp(optarg, "text") != 0); break;
+		case 'u': is_unsigned = 1; break;
+		case 'p': p.delay_p = atoi(optarg); break;
+		case 'P': p.sample_p = atoi(optarg); break;
+		case 's': p.delay_s = atoi(optarg); break;
+		case 'S': p.sample_s = atoi(optarg); break;
+		case 'o': p.outsel = atoi(optarg); break;
+		case 'T': period = atoi(optarg); break;
+		case 'O': offset = atoi(optarg); break;
+		case 'a': ped_start = atoi(optarg); break;
+		case 'A': ped_len = atoi(optarg); break;
+		case 'b': sig_start = atoi(optarg); break;
+		case 'B': sig_len = atoi(optarg); break;
+		case 'c': cmp = optarg; break;
+		default:
+			fprintf(stderr, "Usage: %s [options] <trace>\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind >= argc || period == 0)
+	{
+		fprintf(stderr, "Usage: %s [options] <trace> (pixel period -T is required)\n", argv[0]);
+		return 1;
+	}
+
+	uint32_t n;
+	int32_t *x = trace_load(argv[optind], raw, is_unsigned, &n);
+	if (x == NULL)
+	{
+		return 1;
+	}
+
+	uint32_t npix = (n > offset) ? (n - offset) / period : 0;
+	int64_t *ps = malloc((n + 1) * sizeof(int64_t));
+	cds_model_window_t *win = malloc((npix + 1) * sizeof(cds_model_window_t));
+	int32_t *out = malloc((npix + 1) * sizeof(int32_t));
+	uint8_t *valid = malloc(npix + 1);
+	if (ps == NULL || win == NULL || out == NULL || valid == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	for (uint32_t k=0; k<npix; k++)
+	{
+		uint32_t base 		= offset + k*period;
+		win[k].ped_start 	= base + ped_start;
+		win[k].ped_len 		= ped_len;
+		win[k].sig_start 	= base + sig_start;
+		win[k].sig_len 		= sig_len;
+	}
+
+	cds_model_prefix(x, n, ps);
+	uint32_t nvalid = cds_model_batch(&p, ps, n, win, npix, out, valid);
+
+	if (cmp == NULL)
+	{
+		for (uint32_t k=0; k<npix; k++)
+		{
+			if (valid[k])
+			{
+				printf("%u %d\n", k, out[k]);
+			}
+		}
+		fprintf(stderr, "%u pixels, %u outputs\n", npix, nvalid);
+		return 0;
+	}
+
+	// Compare against the board. Only valid pixels generate packets.
+	uint32_t nb;
+	int32_t *y = trace_load_board(cmp, &nb);
+	if (y == NULL)
+	{
+		return 1;
+	}
+
+	uint32_t j = 0, errors = 0;
+	for (uint32_t k=0; k<npix && j<nb; k++)
+	{
+		if (!valid[k])
+		{
+			continue;
+		}
+		if (out[k] != y[j])
+		{
+			if (errors < 20)
+			{
+				printf("pixel %u: model %d board %d\n", k, out[k], y[j]);
+			}
+			errors++;
+		}
+		j++;
+	}
+
+	printf("%u compared, %u mismatches, model %u outputs, board %u packets\n", j, errors, nvalid, nb);
+
+	return (errors == 0 && j == nvalid && j == nb) ? 0 : 1;
+}
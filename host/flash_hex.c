@@ -0,0 +1,102 @@
+/*
+ * flash_hex.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Turns a binary file into the input of a flash_prog session: the
+ *      "flash_prog <addr> <length> <crc>" command followed by the data in hex,
+ *      in lines of -l bytes (default 64).
+ *
+ *      The board erases the whole range when it gets the command, which takes
+ *      up to a few hundred ms per 64 kB, and takes no data meanwhile. Send the
+ *      first line, wait for "### Flash: ... ready for data", then send the
+ *      rest (e.g. head -n 1 and tail -n +2 of the output). Over ethernet every
+ *      message is at most 255 characters, so use -l 120 or less and send one
+ *      line per message. The board answers with throughput and verify result
+ *      once the last byte is in.
+ *
+ *      Build: gcc -O2 -o flash_hex flash_hex.c
+ *      Usage: flash_hex [-l bytes] <addr> <file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+
+static uint32_t crc32(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for (uint32_t i=0; i<length; i++)
+	{
+		crc ^= data[i];
+		for (int j=0; j<8; j++)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+		}
+	}
+	return ~crc;
+}
+
+int main(int argc, char *argv[])
+{
+	uint32_t line = 64;
+	int c;
+
+	while ((c = getopt(argc, argv, "l:")) != -1)
+	{
+		switch (c)
+		{
+		case 'l': line = atoi(optarg); break;
+		default:
+			fprintf(stderr, "Usage: %s [-l bytes] <addr> <file>\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind != argc - 2 || line == 0)
+	{
+		fprintf(stderr, "Usage: %s [-l bytes] <addr> <file>\n", argv[0]);
+		return 1;
+	}
+
+	uint32_t addr = strtoul(argv[optind], NULL, 0);
+	if (addr & 0xFFF)
+	{
+		fprintf(stderr, "Address must be 4 kB aligned\n");
+		return 1;
+	}
+
+	FILE *f = fopen(argv[optind+1], "rb");
+	if (f == NULL)
+	{
+		perror(argv[optind+1]);
+		return 1;
+	}
+	fseek(f, 0, SEEK_END);
+	long n = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	uint8_t *data = malloc(n > 0 ? n : 1);
+	if (data == NULL || n <= 0 || fread(data, 1, n, f) != (size_t) n)
+	{
+		fprintf(stderr, "Cannot read %s\n", argv[optind+1]);
+		return 1;
+	}
+	fclose(f);
+
+	printf("flash_prog 0x%x %ld 0x%x\r\n", addr, n, crc32(data, n));
+	for (long i=0; i<n; i++)
+	{
+		printf("%02x", data[i]);
+		if ((i + 1) % line == 0 || i == n - 1)
+		{
+			printf("\r\n");
+		}
+	}
+
+	free(data);
+
+	return 0;
+}
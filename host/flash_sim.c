@@ -0,0 +1,437 @@
+/*
+ * flash_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host simulator of the configuration flash: builds src/flash.c against
+ *      the stand-in drivers in host/sim and a model of the N25Q command set.
+ *
+ *      Reads the same range with the way reads were done before
+ *      flash_readBuffer (write enable, enter 4-byte mode, READ 03h of less
+ *      than a page, exit 4-byte mode, for every call) and with
+ *      flash_readBuffer, checks both against the model contents and prints
+ *      the SPI transactions and bytes clocked on the bus for each.
+ *
+ *      Then programs a range that starts and ends in the middle of a sector
+ *      with the bulk programming functions (erase planning, page bursts, CRC)
+ *      and checks the result, including the data around it.
+ *
+ *      Every transfer also goes through src/spi_trace.c. After each step the
+ *      sim closes the command with spi_trace_command and checks with
+ *      spi_trace_get that the trace saw exactly the transfers and bytes of
+ *      the model, and that the step stays within its transaction budget: a
+ *      status read plus one fast read per FLASH_READ_CHUNK for
+ *      flash_readBuffer, 5 transfers per page and per erase for the bulk
+ *      program.
+ *
+ *      Flash model:
+ *      -> one command per transfer (slave select goes up at the end of every
+ *         XSpi_Transfer).
+ *      -> never busy, flag status always ready.
+ *      -> READ 03h takes 3 or 4 address bytes depending on the address mode,
+ *         FAST READ 0Bh the same plus one dummy byte, 4-BYTE FAST READ 0Ch
+ *         always 4 address bytes plus one dummy byte.
+ *      -> page program 12h wraps inside the page and can only clear bits,
+ *         erases DCh/21h set a sector/subsector to 0xFF.
+ *      -> contents start as a function of the address.
+ *
+ *      Build: gcc -O2 -fcommon -Ihost/sim -Iinc -o flash_sim host/flash_sim.c src/flash.c src/spi_trace.c
+ *      Usage: flash_sim [addr] [n]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "xspi.h"
+#include "io_func.h"
+#include "flash.h"
+#include "spi_trace.h"
+
+extern XSpi spi_flash_i;
+
+#define FLASH_SIZE		(64*1024*1024)
+
+// SPI budgets, the model is never busy. Status read before a command.
+#define FLASH_SIM_READY_TRANSFERS	1
+// Per page program and per erase: status, write enable, the command,
+// status and flag status.
+#define FLASH_SIM_BLOCK_TRANSFERS	5
+
+// Model state.
+static int addr4;
+static int write_enabled;
+static u8 *memory;
+static uint32_t nerase[2];
+
+// Bus statistics.
+static uint32_t transfers;
+static uint32_t bus_bytes;
+
+static u8 flash_pattern(u32 addr)
+{
+	return (u8) ((addr * 131) ^ (addr >> 8) ^ (addr >> 16));
+}
+
+static u8 flash_content(u32 addr)
+{
+	return memory[addr % FLASH_SIZE];
+}
+
+static u32 get_addr(const u8 *p)
+{
+	return ((u32)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+// Model of one command, send and recv can be the same buffer.
+static void flash_command(const u8 *send, u8 *recv, unsigned int n)
+{
+	u8 cmd = send[0];
+	unsigned int alen = addr4 ? 4 : 3;
+	unsigned int dummy = 0;
+	u32 addr = 0;
+
+	switch (cmd)
+	{
+	case COMMAND_WRITE_ENABLE:
+		write_enabled = 1;
+		return;
+	case COMMAND_WRITE_DISABLE:
+		write_enabled = 0;
+		return;
+	case COMMAND_ENTER_4BYTE_ADDRESS_MODE:
+		addr4 = write_enabled ? 1 : addr4;
+		return;
+	case COMMAND_EXIT_4BYTE_ADDRESS_MODE:
+		addr4 = write_enabled ? 0 : addr4;
+		return;
+	case COMMAND_STATUSREG_READ:
+		if (recv != NULL && n > 1)
+		{
+			recv[1] = write_enabled ? 0x02 : 0x00;
+		}
+		return;
+	case COMMAND_READ_FLAG_STATUS:
+		if (recv != NULL && n > 1)
+		{
+			recv[1] = FLASH_FLAG_IS_READY_MASK;
+		}
+		return;
+	case COMMAND_4BYTE_PAGE_PROGRAM:
+		if (write_enabled)
+		{
+			addr = get_addr(send + 1);
+			for (unsigned int k=5; k<n; k++)
+			{
+				u32 a = (addr & ~(PAGE_SIZE - 1)) | ((addr + k - 5) & (PAGE_SIZE - 1));
+				memory[a % FLASH_SIZE] &= send[k];
+			}
+		}
+		write_enabled = 0;
+		return;
+	case COMMAND_4BYTE_SECTOR_ERASE:
+	case COMMAND_4BYTE_SUBSECTOR_ERASE:
+		if (write_enabled)
+		{
+			u32 size = (cmd == COMMAND_4BYTE_SECTOR_ERASE) ? BYTE_PER_SECTOR : BYTE_PER_SUBSECTOR;
+			addr = get_addr(send + 1) & ~(size - 1);
+			memset(memory + (addr % FLASH_SIZE), 0xFF, size);
+			nerase[cmd == COMMAND_4BYTE_SECTOR_ERASE]++;
+		}
+		write_enabled = 0;
+		return;
+	case COMMAND_READ:
+		break;
+	case COMMAND_FAST_READ:
+		dummy = 1;
+		break;
+	case COMMAND_4BYTE_FAST_READ:
+		alen = 4;
+		dummy = 1;
+		break;
+	default:
+		return;
+	}
+
+	for (unsigned int k=0; k<alen; k++)
+	{
+		addr = (addr << 8) | send[1+k];
+	}
+
+	if (recv != NULL)
+	{
+		for (unsigned int k=1+alen+dummy; k<n; k++)
+		{
+			recv[k] = flash_content(addr++);
+		}
+	}
+}
+
+// Stand-in drivers.
+static XSpi_Config spi_cfg;
+
+int XSpi_Initialize(XSpi *spi, u16 device_id) { return XST_SUCCESS; }
+int XSpi_Stop(XSpi *spi) { return XST_SUCCESS; }
+int XSpi_Start(XSpi *spi) { return XST_SUCCESS; }
+XSpi_Config *XSpi_LookupConfig(u16 device_id) { return &spi_cfg; }
+int XSpi_CfgInitialize(XSpi *spi, XSpi_Config *cfg, UINTPTR base_addr) { return XST_SUCCESS; }
+int XSpi_SetOptions(XSpi *spi, u32 options) { return XST_SUCCESS; }
+void XSpi_IntrGlobalDisable(XSpi *spi) { }
+int XSpi_SetSlaveSelect(XSpi *spi, u32 mask) { spi->slave = mask; return XST_SUCCESS; }
+
+int XSpi_Transfer(XSpi *spi, u8 *send, u8 *recv, unsigned int n)
+{
+	transfers++;
+	bus_bytes += n;
+	flash_command(send, recv, n);
+	return XST_SUCCESS;
+}
+
+void tdelay_s(uint32_t t) { }
+uint32_t tget_ms(void) { return 0; }
+uint32_t perf_ticks(void) { return 0; }
+uint32_t perf_us(uint32_t t0, uint32_t t1) { return t1 - t0; }
+void mprint(const char *str) { fputs(str, stdout); }
+void io_put_bin(const char *title, const uint8_t *data, uint32_t length) { }
+
+void io_sprintf(char *str, char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	vsprintf(str, fmt, ap);
+	va_end(ap);
+}
+
+void io_padd(uint8_t n, char *str, char ch) { }
+
+uint32_t io_crc32(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	crc = ~crc;
+	for (uint32_t i=0; i<length; i++)
+	{
+		crc ^= data[i];
+		for (int j=0; j<8; j++)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+		}
+	}
+	return ~crc;
+}
+
+void io_put_u16(uint8_t *p, uint16_t val)
+{
+	p[0] = val & 0xFF;
+	p[1] = (val >> 8) & 0xFF;
+}
+
+void io_put_u32(uint8_t *p, uint32_t val)
+{
+	io_put_u16(p, val & 0xFFFF);
+	io_put_u16(p + 2, (val >> 16) & 0xFFFF);
+}
+
+// Reads as they were done before flash_readBuffer.
+static int legacy_read(u32 addr, u8 *data, u32 n)
+{
+	while (n > 0)
+	{
+		u32 len = (n > PAGE_SIZE - 1) ? PAGE_SIZE - 1 : n;
+
+		if (flash_writeEnable() != XST_SUCCESS ||
+			flash_4byteModeEnable() != XST_SUCCESS ||
+			flash_waitForFlashReady() != XST_SUCCESS)
+		{
+			return XST_FAILURE;
+		}
+
+		WriteBuffer[BYTE1] = COMMAND_READ;
+		WriteBuffer[BYTE2] = (u8) (addr >> 24);
+		WriteBuffer[BYTE3] = (u8) (addr >> 16);
+		WriteBuffer[BYTE4] = (u8) (addr >> 8);
+		WriteBuffer[BYTE5] = (u8) addr;
+		XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer, len + READ_WRITE_EXTRA_BYTES);
+		memcpy(data, ReadBuffer + READ_WRITE_EXTRA_BYTES, len);
+
+		if (flash_4byteModeDisable() != XST_SUCCESS)
+		{
+			return XST_FAILURE;
+		}
+
+		addr += len;
+		data += len;
+		n -= len;
+	}
+
+	return XST_SUCCESS;
+}
+
+static int check(const char *what, u32 addr, const u8 *data, u32 n)
+{
+	for (u32 k=0; k<n; k++)
+	{
+		if (data[k] != flash_content(addr + k))
+		{
+			printf("%s: 0x%08x read 0x%02x, expected 0x%02x\n", what, addr + k, data[k], flash_content(addr + k));
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static spi_trace_count_t spi_command(void)
+{
+	spi_trace_count_t c;
+
+	spi_trace_command();
+	spi_trace_get(SPI_TRACE_FLASH, 1, &c);
+
+	return c;
+}
+
+// The trace must see every transfer of the model, within the budget.
+static int check_spi(const char *what, spi_trace_count_t c, u32 t, u32 b, u32 max_transfers)
+{
+	if (c.transfers != t || c.bytes != b || c.errors != 0 || c.transfers > max_transfers)
+	{
+		printf("%s: traced %u transfers and %u bytes, model %u and %u, budget %u transfers, %u errors\n",
+				what, c.transfers, c.bytes, t, b, max_transfers, c.errors);
+		return 1;
+	}
+
+	return 0;
+}
+
+static void report(const char *what, u32 n, u32 t, u32 b)
+{
+	printf("%-18s: %6u transactions, %8u bus bytes, %5.1f%% payload\n", what, t, b, 100.0 * n / b);
+}
+
+int main(int argc, char *argv[])
+{
+	u32 addr = (argc > 1) ? strtoul(argv[1], NULL, 0) : 0x3f00010;
+	u32 n = (argc > 2) ? strtoul(argv[2], NULL, 0) : 65536;
+	flash_version_t info;
+	int errors = 0;
+
+	u8 *data = malloc(n);
+	if (data == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	memory = malloc(FLASH_SIZE);
+	if (memory == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (u32 a=0; a<FLASH_SIZE; a++)
+	{
+		memory[a] = flash_pattern(a);
+	}
+
+	flash_init(0, &info);
+
+	// Previous way.
+	memset(data, 0, n);
+	transfers = bus_bytes = 0;
+	errors += (legacy_read(addr, data, n) != XST_SUCCESS);
+	errors += check("legacy", addr, data, n);
+	u32 t_legacy = transfers, b_legacy = bus_bytes;
+
+	// Streaming.
+	memset(data, 0, n);
+	transfers = bus_bytes = 0;
+	spi_command();
+	errors += (flash_readBuffer(addr, data, n) != XST_SUCCESS);
+	errors += check("flash_readBuffer", addr, data, n);
+	u32 t_stream = transfers, b_stream = bus_bytes;
+	errors += check_spi("flash_readBuffer", spi_command(), t_stream, b_stream,
+			FLASH_SIM_READY_TRANSFERS + (n + FLASH_READ_CHUNK - 1) / FLASH_READ_CHUNK);
+
+	// Must not depend on the address mode left by someone else.
+	addr4 = 1;
+	memset(data, 0, n);
+	errors += (flash_readBuffer(addr, data, n) != XST_SUCCESS);
+	errors += check("flash_readBuffer (4-byte mode)", addr, data, n);
+
+	// Bulk programming, as flash_prog does it: 4 kB into the first sector,
+	// a whole sector and 10000 bytes of the next one.
+	u32 paddr = 0x100F000, plen = 0x1000 + BYTE_PER_SECTOR + 10000;
+	u8 *pdata = malloc(plen);
+	if (pdata == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	for (u32 k=0; k<plen; k++)
+	{
+		pdata[k] = (u8) rand();
+	}
+
+	transfers = bus_bytes = 0;
+	spi_command();
+	for (u32 a=paddr; a<paddr+plen; )
+	{
+		u32 size = flash_eraseSize(a, paddr + plen);
+		errors += (flash_eraseBlock(a, size) != XST_SUCCESS);
+		a += size;
+	}
+	errors += (flash_programBuffer(paddr, pdata, plen) != XST_SUCCESS);
+	u32 t_prog = transfers, b_prog = bus_bytes;
+	u32 npages = ((paddr + plen + PAGE_SIZE - 1) / PAGE_SIZE) - (paddr / PAGE_SIZE);
+	errors += check_spi("bulk program", spi_command(), t_prog, b_prog,
+			FLASH_SIM_BLOCK_TRANSFERS * (npages + nerase[0] + nerase[1]));
+
+	u32 crc;
+	errors += (flash_crc(paddr, plen, &crc) != XST_SUCCESS);
+	if (crc != io_crc32(0, pdata, plen))
+	{
+		printf("flash_crc: 0x%08x, expected 0x%08x\n", crc, io_crc32(0, pdata, plen));
+		errors++;
+	}
+	for (u32 k=0; k<plen; k++)
+	{
+		if (memory[paddr + k] != pdata[k])
+		{
+			printf("program: 0x%08x is 0x%02x, expected 0x%02x\n", paddr + k, memory[paddr + k], pdata[k]);
+			errors++;
+			break;
+		}
+	}
+
+	// Erased up to the end of the last subsector, untouched around.
+	u32 pend = (paddr + plen + BYTE_PER_SUBSECTOR - 1) & ~(BYTE_PER_SUBSECTOR - 1);
+	for (u32 a=paddr - BYTE_PER_SECTOR; a<pend + BYTE_PER_SECTOR; a++)
+	{
+		u8 expected = (a < paddr) ? flash_pattern(a) : (a >= pend) ? flash_pattern(a) : (a >= paddr + plen) ? 0xFF : pdata[a - paddr];
+		if (memory[a] != expected)
+		{
+			printf("program: 0x%08x is 0x%02x, expected 0x%02x\n", a, memory[a], expected);
+			errors++;
+			break;
+		}
+	}
+	if (nerase[0] != 4 || nerase[1] != 1)
+	{
+		printf("erase plan: %u subsectors and %u sectors, expected 4 and 1\n", nerase[0], nerase[1]);
+		errors++;
+	}
+
+	printf("%u bytes from 0x%08x\n", n, addr);
+	report("legacy read", n, t_legacy, b_legacy);
+	report("flash_readBuffer", n, t_stream, b_stream);
+	printf("%u bytes programmed at 0x%08x\n", plen, paddr);
+	printf("%-18s: %u subsector and %u sector erases, %u transactions, %u bus bytes\n",
+			"bulk program", nerase[0], nerase[1], t_prog, b_prog);
+	printf("%s\n", errors ? "FAILED" : "OK");
+
+	free(data);
+	free(pdata);
+	free(memory);
+
+	return errors ? 1 : 0;
+}
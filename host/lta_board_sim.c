@@ -0,0 +1,262 @@
+/*
+ * lta_board_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Stand-in for a set of boards, to test lta_ctrl.c and lta_fanout.c
+ *      without hardware.
+ *
+ *      Board i takes commands on cmd_port + i and answers like the firmware:
+ *      one datagram per message, "Done", then "FAILED: " and the error text if
+ *      the command failed, every answer -l ms after the command. It knows:
+ *
+ *      set <var> <value>   : any variable, stored.
+ *      get <var>           : "<var> = <value>", error if never set.
+ *      set acqRun 1        : one frame of simPix pixels (default 1000) per
+ *                            channel, as CDS sequential packets, sent to
+ *                            data_port + i on the host that sent the command.
+ *      set simIlk 1        : from then on an unsolicited interlock line follows
+ *                            "Done" of every command that went fine, which must
+ *                            still count as ok.
+ *
+ *      Pixel values are board*1000000 + channel*100000 + pixel.
+ *
+ *      Build: gcc -O2 -Wall -o lta_board_sim lta_board_sim.c
+ *      Usage: lta_board_sim [-n boards] [-p cmd_port] [-d data_port] [-l ms]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#define SIM_MAX_BOARDS		64
+#define SIM_MAX_VARS		64
+#define SIM_PACKETS			64		// Packets per data datagram.
+
+typedef struct {
+	char name[32];
+	char value[32];
+} sim_var_t;
+
+typedef struct {
+	int fd;
+	uint16_t data_port;
+	sim_var_t vars[SIM_MAX_VARS];
+	int nvars;
+	uint8_t cnt;
+
+	// Pending answer.
+	char reply[1024];
+	int pending;
+	uint64_t due;
+	struct sockaddr_in peer;
+	int send_frame;
+} sim_board_t;
+
+static sim_board_t boards[SIM_MAX_BOARDS];
+
+static uint64_t sim_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec*1000 + ts.tv_nsec/1000000;
+}
+
+static sim_var_t *sim_find(sim_board_t *b, const char *name)
+{
+	for (int i=0; i<b->nvars; i++)
+	{
+		if (strcmp(b->vars[i].name, name) == 0)
+		{
+			return &b->vars[i];
+		}
+	}
+	return NULL;
+}
+
+static void sim_command(sim_board_t *b, char *line)
+{
+	char w0[32] = "", w1[32] = "", w2[32] = "";
+	int n = sscanf(line, "%31s %31s %31s", w0, w1, w2);
+	sim_var_t *v;
+
+	b->reply[0] 	= '\0';
+	b->send_frame 	= 0;
+
+	if (n == 3 && strcmp(w0, "set") == 0)
+	{
+		if ((v = sim_find(b, w1)) == NULL && b->nvars < SIM_MAX_VARS)
+		{
+			v = &b->vars[b->nvars++];
+			strcpy(v->name, w1);
+		}
+		if (v == NULL)
+		{
+			strcpy(b->reply, "Done\r\n|FAILED: ### Too many variables\r\n");
+			return;
+		}
+		strcpy(v->value, w2);
+		b->send_frame = (strcmp(w1, "acqRun") == 0 && atoi(w2) == 1);
+		strcpy(b->reply, "Done\r\n");
+	}
+	else if (n == 2 && strcmp(w0, "get") == 0)
+	{
+		if ((v = sim_find(b, w1)) == NULL)
+		{
+			snprintf(b->reply, sizeof(b->reply), "Done\r\n|FAILED: Invalid command: get %s\r\n", w1);
+		}
+		else
+		{
+			snprintf(b->reply, sizeof(b->reply), "%s = %s\r\n|Done\r\n", v->name, v->value);
+		}
+	}
+	else
+	{
+		snprintf(b->reply, sizeof(b->reply), "Done\r\n|FAILED: Invalid command: %s\r\n", line);
+	}
+
+	// An interlock trips right after a command that went fine.
+	v = sim_find(b, "simIlk");
+	size_t len = strlen(b->reply);
+	if (v != NULL && atoi(v->value) == 1 && len >= 6 && strcmp(b->reply + len - 6, "Done\r\n") == 0)
+	{
+		strncat(b->reply, "|### Interlock vdrain = 27.500000 out of [0.000000, 25.000000]\r\n",
+				sizeof(b->reply) - len - 1);
+	}
+}
+
+static void sim_frame(int idx)
+{
+	sim_board_t *b = &boards[idx];
+	sim_var_t *v = sim_find(b, "simPix");
+	uint32_t npix = (v != NULL) ? atoi(v->value) : 1000;
+	uint8_t buf[SIM_PACKETS*8];
+	int k = 0;
+
+	struct sockaddr_in dst = b->peer;
+	dst.sin_port = htons(b->data_port);
+
+	for (uint32_t p=0; p<npix; p++)
+	{
+		for (int ch=0; ch<4; ch++)
+		{
+			uint32_t data = idx*1000000 + ch*100000 + p;
+			uint64_t w = ((uint64_t) (b->cnt++ & 0xF) << 60) | ((uint64_t) (0xC | ch) << 56) | data;
+			for (int j=0; j<8; j++)
+			{
+				buf[k*8 + j] = (w >> (8*j)) & 0xFF;
+			}
+			if (++k == SIM_PACKETS)
+			{
+				sendto(b->fd, buf, sizeof(buf), 0, (struct sockaddr *) &dst, sizeof(dst));
+				k = 0;
+				usleep(50);
+			}
+		}
+	}
+	if (k > 0)
+	{
+		sendto(b->fd, buf, k*8, 0, (struct sockaddr *) &dst, sizeof(dst));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	struct pollfd fds[SIM_MAX_BOARDS];
+	int nboards = 1, cmd_port = 8888, data_port = 8889, latency = 20;
+	int c;
+
+	while ((c = getopt(argc, argv, "n:p:d:l:")) != -1)
+	{
+		switch (c)
+		{
+		case 'n': nboards = atoi(optarg); break;
+		case 'p': cmd_port = atoi(optarg); break;
+		case 'd': data_port = atoi(optarg); break;
+		case 'l': latency = atoi(optarg); break;
+		default:
+			fprintf(stderr, "Usage: %s [-n boards] [-p cmd_port] [-d data_port] [-l ms]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (nboards < 1 || nboards > SIM_MAX_BOARDS)
+	{
+		fprintf(stderr, "1 to %d boards\n", SIM_MAX_BOARDS);
+		return 1;
+	}
+
+	for (int i=0; i<nboards; i++)
+	{
+		struct sockaddr_in local;
+
+		memset(&boards[i], 0, sizeof(sim_board_t));
+		boards[i].fd 		= socket(AF_INET, SOCK_DGRAM, 0);
+		boards[i].data_port = data_port + i;
+
+		memset(&local, 0, sizeof(local));
+		local.sin_family 		= AF_INET;
+		local.sin_addr.s_addr 	= htonl(INADDR_LOOPBACK);
+		local.sin_port 			= htons(cmd_port + i);
+		if (boards[i].fd < 0 || bind(boards[i].fd, (struct sockaddr *) &local, sizeof(local)) != 0)
+		{
+			perror("bind");
+			return 1;
+		}
+		fds[i].fd 		= boards[i].fd;
+		fds[i].events 	= POLLIN;
+	}
+	printf("%d boards on ports %d-%d, data to %d-%d\n", nboards, cmd_port, cmd_port + nboards - 1,
+			data_port, data_port + nboards - 1);
+	fflush(stdout);
+
+	while (1)
+	{
+		poll(fds, nboards, 1);
+		uint64_t now = sim_ms();
+
+		for (int i=0; i<nboards; i++)
+		{
+			sim_board_t *b = &boards[i];
+
+			if (fds[i].revents & POLLIN)
+			{
+				char line[512];
+				socklen_t len = sizeof(b->peer);
+				ssize_t r = recvfrom(b->fd, line, sizeof(line) - 1, 0, (struct sockaddr *) &b->peer, &len);
+				if (r > 0 && !b->pending)
+				{
+					line[r] = '\0';
+					line[strcspn(line, "\r\n")] = '\0';
+					sim_command(b, line);
+					b->pending 	= 1;
+					b->due 		= now + latency;
+				}
+			}
+
+			// One datagram per message, '|' separates them.
+			if (b->pending && now >= b->due)
+			{
+				char *rest = b->reply, *msg;
+				while ((msg = strsep(&rest, "|")) != NULL)
+				{
+					sendto(b->fd, msg, strlen(msg), 0, (struct sockaddr *) &b->peer, sizeof(b->peer));
+				}
+				b->pending = 0;
+				if (b->send_frame)
+				{
+					sim_frame(i);
+				}
+			}
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,348 @@
+/*
+ * lta_ctrl.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <poll.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+
+#include "lta_ctrl.h"
+
+uint64_t lta_ctrl_ms(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec*1000 + ts.tv_nsec/1000000;
+}
+
+void lta_ctrl_init(lta_ctrl_t *ctrl)
+{
+	memset(ctrl, 0, sizeof(lta_ctrl_t));
+	ctrl->timeout_ms = LTA_CTRL_TIMEOUT_MS;
+}
+
+int lta_ctrl_add(lta_ctrl_t *ctrl, const char *spec)
+{
+	if (ctrl->nboards == LTA_CTRL_MAX_BOARDS)
+	{
+		return -1;
+	}
+
+	lta_board_t *b = &ctrl->boards[ctrl->nboards];
+	char *p;
+
+	memset(b, 0, sizeof(lta_board_t));
+	strncpy(b->host, spec, sizeof(b->host) - 1);
+	b->cmd_port 	= LTA_CTRL_CMD_PORT;
+	b->data_port 	= LTA_CTRL_DATA_PORT;
+	b->cmd_fd 		= -1;
+	b->data_fd 		= -1;
+	b->last_cnt 	= -1;
+
+	if ((p = strchr(b->host, ':')) != NULL)
+	{
+		*p++ = '\0';
+		b->cmd_port = atoi(p);
+		if ((p = strchr(p, ':')) != NULL)
+		{
+			b->data_port = atoi(p + 1);
+		}
+	}
+
+	struct addrinfo hints, *res;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family 	= AF_INET;
+	hints.ai_socktype 	= SOCK_DGRAM;
+	if (getaddrinfo(b->host, NULL, &hints, &res) != 0)
+	{
+		return -1;
+	}
+	b->addr = *(struct sockaddr_in *) res->ai_addr;
+	b->addr.sin_port = htons(b->cmd_port);
+	freeaddrinfo(res);
+
+	return ctrl->nboards++;
+}
+
+int lta_ctrl_open(lta_ctrl_t *ctrl)
+{
+	for (int i=0; i<ctrl->nboards; i++)
+	{
+		lta_board_t *b = &ctrl->boards[i];
+		struct sockaddr_in local;
+
+		b->cmd_fd 	= socket(AF_INET, SOCK_DGRAM, 0);
+		b->data_fd 	= socket(AF_INET, SOCK_DGRAM, 0);
+		if (b->cmd_fd < 0 || b->data_fd < 0)
+		{
+			return -1;
+		}
+
+		// Answers only from this board.
+		if (connect(b->cmd_fd, (struct sockaddr *) &b->addr, sizeof(b->addr)) != 0)
+		{
+			return -1;
+		}
+
+		// Large buffer, the board does not wait for us.
+		int size = 8*1024*1024;
+		setsockopt(b->data_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+		memset(&local, 0, sizeof(local));
+		local.sin_family 		= AF_INET;
+		local.sin_addr.s_addr 	= htonl(INADDR_ANY);
+		local.sin_port 			= htons(b->data_port);
+		if (bind(b->data_fd, (struct sockaddr *) &local, sizeof(local)) != 0)
+		{
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+void lta_ctrl_close(lta_ctrl_t *ctrl)
+{
+	for (int i=0; i<ctrl->nboards; i++)
+	{
+		lta_board_t *b = &ctrl->boards[i];
+		if (b->cmd_fd >= 0) close(b->cmd_fd);
+		if (b->data_fd >= 0) close(b->data_fd);
+		for (int c=0; c<LTA_CTRL_NCHANNELS; c++)
+		{
+			free(b->frame.pix[c]);
+		}
+		b->cmd_fd = b->data_fd = -1;
+	}
+}
+
+static void lta_ctrl_check_done(lta_board_t *b, uint64_t now)
+{
+	b->reply[b->reply_length] = '\0';
+	if (b->t_done == 0 && strstr(b->reply, "Done\r\n") != NULL)
+	{
+		b->t_done = now;
+	}
+}
+
+// The command failed if the line right after "Done" is its error line, which
+// the firmware marks with CMD_FAILED_PREFIX. Any other text (output of a
+// stream, an interlock) does not count.
+static void lta_ctrl_finish(lta_board_t *b)
+{
+	char *done = strstr(b->reply, "Done\r\n");
+
+	b->busy = 0;
+	if (done == NULL)
+	{
+		b->status = -1;
+		return;
+	}
+
+	b->status = (strncmp(done + 6, LTA_CTRL_FAILED, strlen(LTA_CTRL_FAILED)) == 0) ? -1 : 0;
+}
+
+// Throws away what is already queued on the command socket (late answers of
+// a command that timed out, unsolicited output), so it is not taken as the
+// answer of the next one.
+static void lta_ctrl_drain(lta_board_t *b)
+{
+	char buf[2048];
+
+	while (recv(b->cmd_fd, buf, sizeof(buf), MSG_DONTWAIT) > 0)
+	{
+	}
+}
+
+int lta_ctrl_broadcast(lta_ctrl_t *ctrl, const char *cmd)
+{
+	struct pollfd fds[LTA_CTRL_MAX_BOARDS];
+	char line[512];
+	int nbusy = 0, nfail = 0;
+
+	// Commands end with CR, as typed on the terminal.
+	snprintf(line, sizeof(line), "%s\r", cmd);
+
+	uint64_t t0 = lta_ctrl_ms();
+	for (int i=0; i<ctrl->nboards; i++)
+	{
+		lta_board_t *b = &ctrl->boards[i];
+
+		b->reply_length = 0;
+		b->reply[0] 	= '\0';
+		b->t_sent 		= t0;
+		b->t_done 		= 0;
+		b->status 		= 0;
+		b->busy 		= 1;
+		lta_ctrl_drain(b);
+		if (send(b->cmd_fd, line, strlen(line), 0) < 0)
+		{
+			b->busy 	= 0;
+			b->status 	= -1;
+			continue;
+		}
+		nbusy++;
+	}
+
+	while (nbusy > 0)
+	{
+		for (int i=0; i<ctrl->nboards; i++)
+		{
+			fds[i].fd 		= ctrl->boards[i].busy ? ctrl->boards[i].cmd_fd : -1;
+			fds[i].events 	= POLLIN;
+		}
+		poll(fds, ctrl->nboards, 10);
+
+		uint64_t now = lta_ctrl_ms();
+		for (int i=0; i<ctrl->nboards; i++)
+		{
+			lta_board_t *b = &ctrl->boards[i];
+			if (!b->busy)
+			{
+				continue;
+			}
+
+			if (fds[i].revents & POLLIN)
+			{
+				uint32_t room = LTA_CTRL_REPLY_LENGTH - 1 - b->reply_length;
+				ssize_t r = recv(b->cmd_fd, b->reply + b->reply_length, room, 0);
+				if (r > 0)
+				{
+					b->reply_length += r;
+					lta_ctrl_check_done(b, now);
+				}
+			}
+
+			if ( (b->t_done != 0 && now - b->t_done >= LTA_CTRL_LINGER_MS) ||
+				 (now - b->t_sent >= (uint64_t) ctrl->timeout_ms) )
+			{
+				lta_ctrl_finish(b);
+				nbusy--;
+			}
+		}
+	}
+
+	for (int i=0; i<ctrl->nboards; i++)
+	{
+		nfail += (ctrl->boards[i].status != 0);
+	}
+
+	return nfail;
+}
+
+// Decodes one 64-bit packet into the frame of the board.
+static void lta_ctrl_packet(lta_board_t *b, uint64_t w)
+{
+	lta_frame_t *f = &b->frame;
+	int cnt = (w >> 60) & 0xF;
+	int id 	= (w >> 56) & 0xF;
+
+	if (b->last_cnt >= 0 && cnt != ((b->last_cnt + 1) & 0xF))
+	{
+		f->gaps++;
+	}
+	b->last_cnt = cnt;
+
+	// CDS (10xx) and CDS sequential (11xx).
+	if ((id & 0x8) == 0)
+	{
+		f->other++;
+		return;
+	}
+
+	int ch = id & 0x3;
+	if (f->count[ch] < f->npix)
+	{
+		f->pix[ch][f->count[ch]++] = (int32_t) (w & 0xFFFFFFFF);
+	}
+}
+
+static int lta_ctrl_frame_full(lta_frame_t *f)
+{
+	for (int c=0; c<LTA_CTRL_NCHANNELS; c++)
+	{
+		if (f->count[c] < f->npix)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+int lta_ctrl_collect(lta_ctrl_t *ctrl, uint32_t npix, int timeout_ms)
+{
+	struct pollfd fds[LTA_CTRL_MAX_BOARDS];
+	uint8_t buf[65536];
+	int nopen = ctrl->nboards, nfail = 0;
+
+	for (int i=0; i<ctrl->nboards; i++)
+	{
+		lta_frame_t *f = &ctrl->boards[i].frame;
+		for (int c=0; c<LTA_CTRL_NCHANNELS; c++)
+		{
+			free(f->pix[c]);
+			f->pix[c] 	= calloc(npix > 0 ? npix : 1, sizeof(int32_t));
+			f->count[c] = 0;
+		}
+		f->npix 	= npix;
+		f->gaps 	= 0;
+		f->other 	= 0;
+		ctrl->boards[i].last_cnt = -1;
+	}
+
+	uint64_t last_rx = lta_ctrl_ms();
+	while (nopen > 0 && lta_ctrl_ms() - last_rx < (uint64_t) timeout_ms)
+	{
+		for (int i=0; i<ctrl->nboards; i++)
+		{
+			fds[i].fd 		= lta_ctrl_frame_full(&ctrl->boards[i].frame) ? -1 : ctrl->boards[i].data_fd;
+			fds[i].events 	= POLLIN;
+		}
+		if (poll(fds, ctrl->nboards, 10) <= 0)
+		{
+			continue;
+		}
+		last_rx = lta_ctrl_ms();
+
+		for (int i=0; i<ctrl->nboards; i++)
+		{
+			lta_board_t *b = &ctrl->boards[i];
+			if (!(fds[i].revents & POLLIN))
+			{
+				continue;
+			}
+
+			ssize_t r = recv(b->data_fd, buf, sizeof(buf), 0);
+			for (ssize_t k=0; k+8<=r; k+=8)
+			{
+				uint64_t w = 0;
+				for (int j=7; j>=0; j--)
+				{
+					w = (w << 8) | buf[k+j];
+				}
+				lta_ctrl_packet(b, w);
+			}
+
+			if (lta_ctrl_frame_full(&b->frame))
+			{
+				nopen--;
+			}
+		}
+	}
+
+	for (int i=0; i<ctrl->nboards; i++)
+	{
+		nfail += !lta_ctrl_frame_full(&ctrl->boards[i].frame);
+	}
+
+	return nfail;
+}
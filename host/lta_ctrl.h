@@ -0,0 +1,106 @@
+/*
+ * lta_ctrl.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host side controller for many boards at once.
+ *
+ *      Every board gets a command socket and a data socket, and all of them are
+ *      served from one poll() loop: a broadcast sends the command to every
+ *      board and then waits for all the answers together, so configuring N
+ *      boards takes the time of the slowest one instead of N times one.
+ *
+ *      Commands are the text lines of the uart/ethernet interface, sent as one
+ *      datagram each. The board answers with one datagram per message (at most
+ *      ETH_MAX_DATALENGTH bytes): whatever the command prints, then "Done",
+ *      then the error line if the command failed. A command is complete
+ *      LTA_CTRL_LINGER_MS after "Done" with no more text, and failed if the
+ *      line after "Done" starts with LTA_CTRL_FAILED. Unsolicited lines
+ *      ("### Interlock ...", "### Clock drift ...") can follow "Done" too and
+ *      do not count. Anything still queued on the command socket is dropped
+ *      before a command is sent.
+ *
+ *      Data packets (64-bit little endian words, see inc/packer.h) arrive on
+ *      the data port of each board. lta_ctrl_collect merges the CDS packets of
+ *      every board into one frame per CCD (one CCD per board), one image per
+ *      channel, and checks the packet counter.
+ */
+
+#ifndef LTA_CTRL_H_
+#define LTA_CTRL_H_
+
+#include <stdint.h>
+#include <netinet/in.h>
+
+#define LTA_CTRL_MAX_BOARDS			64
+#define LTA_CTRL_REPLY_LENGTH		(64*1024)
+#define LTA_CTRL_TIMEOUT_MS			5000
+#define LTA_CTRL_LINGER_MS			50
+#define LTA_CTRL_NCHANNELS			4
+#define LTA_CTRL_FAILED				"FAILED: "	// CMD_FAILED_PREFIX in inc/defines.h.
+
+// Ports used when not given with the board address.
+#define LTA_CTRL_CMD_PORT			8888
+#define LTA_CTRL_DATA_PORT			8889
+
+typedef struct {
+	uint32_t npix;				// Pixels per channel.
+	int32_t *pix[LTA_CTRL_NCHANNELS];
+	uint32_t count[LTA_CTRL_NCHANNELS];
+	uint32_t gaps;				// Packet counter jumps.
+	uint32_t other;				// Packets that are not CDS.
+} lta_frame_t;
+
+typedef struct {
+	char host[64];
+	uint16_t cmd_port;
+	uint16_t data_port;
+	struct sockaddr_in addr;
+	int cmd_fd;
+	int data_fd;
+
+	// Current command.
+	char reply[LTA_CTRL_REPLY_LENGTH];
+	uint32_t reply_length;
+	uint64_t t_sent;
+	uint64_t t_done;			// 0 until "Done" is received.
+	int busy;
+	int status;					// 0 ok, -1 error text or timeout.
+
+	// Data.
+	lta_frame_t frame;
+	int last_cnt;
+} lta_board_t;
+
+typedef struct {
+	lta_board_t boards[LTA_CTRL_MAX_BOARDS];
+	int nboards;
+	int timeout_ms;
+} lta_ctrl_t;
+
+void lta_ctrl_init(lta_ctrl_t *ctrl);
+
+// Adds a board given as host[:cmd_port[:data_port]]. Returns its index or -1.
+int lta_ctrl_add(lta_ctrl_t *ctrl, const char *spec);
+
+// Opens the sockets of all boards. Returns -1 on error.
+int lta_ctrl_open(lta_ctrl_t *ctrl);
+void lta_ctrl_close(lta_ctrl_t *ctrl);
+
+/*
+ * Sends cmd to every board and waits for all the answers. Returns the number
+ * of boards that failed; the answer of each one is in reply, its result in
+ * status.
+ */
+int lta_ctrl_broadcast(lta_ctrl_t *ctrl, const char *cmd);
+
+/*
+ * Receives npix pixels per channel from every board, or until timeout_ms
+ * without data. Returns the number of boards with an incomplete frame.
+ */
+int lta_ctrl_collect(lta_ctrl_t *ctrl, uint32_t npix, int timeout_ms);
+
+uint64_t lta_ctrl_ms(void);
+
+#endif /* LTA_CTRL_H_ */
@@ -0,0 +1,266 @@
+/*
+ * lta_fanout.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Drives many boards at once through lta_ctrl.c.
+ *
+ *      Boards are given with -b host[:cmd_port[:data_port]], once per board.
+ *      Actions:
+ *
+ *      cmd <command>                   : sends the command to every board and
+ *                                        prints every answer.
+ *      file <file>                     : sends every line of the file, stops at
+ *                                        the first line that fails on any board.
+ *      status <var> [var ...]          : "get <var>" on every board, printed as
+ *                                        one table.
+ *      collect <npix> <prefix> [cmd]   : sends cmd (if given) and merges the CDS
+ *                                        packets of every board into
+ *                                        <prefix>_<board>.bin: npix int32 per
+ *                                        channel, channels A to D one after the
+ *                                        other.
+ *
+ *      host/lta_board_sim.c stands in for the boards when testing.
+ *
+ *      Build: gcc -O2 -Wall -o lta_fanout lta_fanout.c lta_ctrl.c
+ *      Usage: lta_fanout [-t timeout_ms] -b board [-b board ...] <action> ...
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "lta_ctrl.h"
+
+static lta_ctrl_t ctrl;
+
+static void usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-t timeout_ms] -b host[:cmd[:data]] [-b ...] <action> ...\n", name);
+	fprintf(stderr, "  cmd <command>\n");
+	fprintf(stderr, "  file <file>\n");
+	fprintf(stderr, "  status <var> [var ...]\n");
+	fprintf(stderr, "  collect <npix> <prefix> [command]\n");
+}
+
+// Joins argv[first..argc-1] with spaces.
+static void join(char *out, size_t size, int argc, char *argv[], int first)
+{
+	out[0] = '\0';
+	for (int i=first; i<argc; i++)
+	{
+		if (i > first)
+		{
+			strncat(out, " ", size - strlen(out) - 1);
+		}
+		strncat(out, argv[i], size - strlen(out) - 1);
+	}
+}
+
+static int broadcast(const char *cmd, int verbose)
+{
+	uint64_t t0 = lta_ctrl_ms();
+	int nfail = lta_ctrl_broadcast(&ctrl, cmd);
+
+	printf("%s : %d/%d ok in %llu ms\n", cmd, ctrl.nboards - nfail, ctrl.nboards,
+			(unsigned long long) (lta_ctrl_ms() - t0));
+
+	for (int i=0; i<ctrl.nboards; i++)
+	{
+		lta_board_t *b = &ctrl.boards[i];
+		if (verbose || b->status != 0)
+		{
+			printf("[%d %s:%u] %s\n%s", i, b->host, b->cmd_port, b->status ? "FAILED" : "ok", b->reply);
+		}
+	}
+
+	return nfail;
+}
+
+static int action_file(const char *path)
+{
+	char line[512];
+	FILE *f = fopen(path, "r");
+
+	if (f == NULL)
+	{
+		perror(path);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), f) != NULL)
+	{
+		line[strcspn(line, "\r\n")] = '\0';
+		if (line[0] == '\0' || line[0] == '#')
+		{
+			continue;
+		}
+		if (broadcast(line, 0) != 0)
+		{
+			fclose(f);
+			return 1;
+		}
+	}
+	fclose(f);
+
+	return 0;
+}
+
+static int action_status(int argc, char *argv[], int first)
+{
+	static char values[LTA_CTRL_MAX_BOARDS][8][32];
+	char cmd[64];
+	int nvars = argc - first;
+	int ret = 0;
+
+	if (nvars > 8)
+	{
+		nvars = 8;
+	}
+
+	for (int v=0; v<nvars; v++)
+	{
+		snprintf(cmd, sizeof(cmd), "get %s", argv[first+v]);
+		ret |= (lta_ctrl_broadcast(&ctrl, cmd) != 0);
+
+		// Answer is "<var> = <value>".
+		for (int i=0; i<ctrl.nboards; i++)
+		{
+			char *eq = strstr(ctrl.boards[i].reply, " = ");
+			strcpy(values[i][v], "?");
+			if (ctrl.boards[i].status == 0 && eq != NULL)
+			{
+				sscanf(eq + 3, "%31s", values[i][v]);
+			}
+		}
+	}
+
+	printf("%-24s", "board");
+	for (int v=0; v<nvars; v++)
+	{
+		printf(" %14s", argv[first+v]);
+	}
+	printf("\n");
+	for (int i=0; i<ctrl.nboards; i++)
+	{
+		char name[80];
+		snprintf(name, sizeof(name), "%s:%u", ctrl.boards[i].host, ctrl.boards[i].cmd_port);
+		printf("%-24s", name);
+		for (int v=0; v<nvars; v++)
+		{
+			printf(" %14s", values[i][v]);
+		}
+		printf("\n");
+	}
+
+	return ret;
+}
+
+static int action_collect(uint32_t npix, const char *prefix, const char *cmd)
+{
+	char path[512];
+	int ret = 0;
+
+	if (cmd[0] != '\0' && broadcast(cmd, 0) != 0)
+	{
+		return 1;
+	}
+
+	uint64_t t0 = lta_ctrl_ms();
+	int nfail = lta_ctrl_collect(&ctrl, npix, ctrl.timeout_ms);
+	printf("collect : %d/%d frames in %llu ms\n", ctrl.nboards - nfail, ctrl.nboards,
+			(unsigned long long) (lta_ctrl_ms() - t0));
+
+	for (int i=0; i<ctrl.nboards; i++)
+	{
+		lta_frame_t *f = &ctrl.boards[i].frame;
+
+		printf("[%d] pixels %u/%u/%u/%u of %u, counter gaps %u, other packets %u\n",
+				i, f->count[0], f->count[1], f->count[2], f->count[3], npix, f->gaps, f->other);
+
+		snprintf(path, sizeof(path), "%s_%d.bin", prefix, i);
+		FILE *out = fopen(path, "wb");
+		if (out == NULL)
+		{
+			perror(path);
+			ret = 1;
+			continue;
+		}
+		for (int c=0; c<LTA_CTRL_NCHANNELS; c++)
+		{
+			fwrite(f->pix[c], sizeof(int32_t), npix, out);
+		}
+		fclose(out);
+	}
+
+	return ret || nfail;
+}
+
+int main(int argc, char *argv[])
+{
+	char cmd[512];
+	int c;
+
+	lta_ctrl_init(&ctrl);
+
+	while ((c = getopt(argc, argv, "b:t:")) != -1)
+	{
+		switch (c)
+		{
+		case 'b':
+			if (lta_ctrl_add(&ctrl, optarg) < 0)
+			{
+				fprintf(stderr, "Bad board %s\n", optarg);
+				return 1;
+			}
+			break;
+		case 't': ctrl.timeout_ms = atoi(optarg); break;
+		default:
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	if (ctrl.nboards == 0 || optind >= argc)
+	{
+		usage(argv[0]);
+		return 1;
+	}
+	if (lta_ctrl_open(&ctrl) != 0)
+	{
+		perror("socket");
+		return 1;
+	}
+
+	const char *action = argv[optind];
+	int ret = 1;
+
+	if (strcmp(action, "cmd") == 0 && optind + 1 < argc)
+	{
+		join(cmd, sizeof(cmd), argc, argv, optind + 1);
+		ret = (broadcast(cmd, 1) != 0);
+	}
+	else if (strcmp(action, "file") == 0 && optind + 2 == argc)
+	{
+		ret = action_file(argv[optind+1]);
+	}
+	else if (strcmp(action, "status") == 0 && optind + 1 < argc)
+	{
+		ret = action_status(argc, argv, optind + 1);
+	}
+	else if (strcmp(action, "collect") == 0 && optind + 3 <= argc && atoi(argv[optind+1]) > 0)
+	{
+		join(cmd, sizeof(cmd), argc, argv, optind + 3);
+		ret = action_collect(atoi(argv[optind+1]), argv[optind+2], cmd);
+	}
+	else
+	{
+		usage(argv[0]);
+	}
+
+	lta_ctrl_close(&ctrl);
+
+	return ret;
+}
@@ -0,0 +1,25 @@
+/*
+ * io_func.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host stand-in for inc/io_func.h, which pulls in the whole system state.
+ *      Must come before -Iinc. Only the helpers flash.c and spi_trace.c use,
+ *      the simulator defines them.
+ */
+
+#ifndef SRC_IO_FUNC_H_
+#define SRC_IO_FUNC_H_
+
+#include <stdint.h>
+
+void io_sprintf(char *str, char *fmt, ...);
+void io_padd(uint8_t n, char *str, char ch);
+uint32_t io_crc32(uint32_t crc, const uint8_t *data, uint32_t length);
+void io_put_u16(uint8_t *p, uint16_t val);
+void io_put_u32(uint8_t *p, uint32_t val);
+void mprint(const char *str);
+void io_put_bin(const char *title, const uint8_t *data, uint32_t length);
+
+#endif /* SRC_IO_FUNC_H_ */
@@ -0,0 +1,20 @@
+/*
+ * perf.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host stand-in for inc/perf.h, which pulls in the whole system state.
+ *      Must come before -Iinc. Only the timer spi_trace.c uses, the
+ *      simulator defines it.
+ */
+
+#ifndef PERF_H_
+#define PERF_H_
+
+#include <stdint.h>
+
+uint32_t perf_ticks(void);
+uint32_t perf_us(uint32_t t0, uint32_t t1);
+
+#endif /* PERF_H_ */
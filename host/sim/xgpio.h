@@ -0,0 +1,23 @@
+/*
+ * xgpio.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host stand-in for the Xilinx GPIO driver, only what telemetry.c uses.
+ */
+
+#ifndef XGPIO_H_
+#define XGPIO_H_
+
+#include "xintc.h"
+
+typedef struct {
+	u32 data;
+} XGpio;
+
+int XGpio_Initialize(XGpio *gpio, u16 device_id);
+void XGpio_SetDataDirection(XGpio *gpio, unsigned channel, u32 mask);
+void XGpio_DiscreteWrite(XGpio *gpio, unsigned channel, u32 data);
+
+#endif /* XGPIO_H_ */
@@ -0,0 +1,18 @@
+/*
+ * xil_printf.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host stand-in for the Xilinx printing functions.
+ */
+
+#ifndef XIL_PRINTF_H_
+#define XIL_PRINTF_H_
+
+#include <stdio.h>
+
+#define xil_printf		printf
+#define print(s)		fputs((s), stdout)
+
+#endif /* XIL_PRINTF_H_ */
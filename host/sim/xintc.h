@@ -0,0 +1,22 @@
+/*
+ * xintc.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host stand-in for the Xilinx types pulled in through interrupt.h.
+ */
+
+#ifndef XINTC_H_
+#define XINTC_H_
+
+#include <stdint.h>
+
+typedef uint8_t		u8;
+typedef uint16_t	u16;
+typedef uint32_t	u32;
+typedef uintptr_t	UINTPTR;
+
+typedef void (*XInterruptHandler)(void *ref);
+
+#endif /* XINTC_H_ */
@@ -0,0 +1,44 @@
+/*
+ * xspi.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host stand-in for the Xilinx SPI driver, only what telemetry.c and
+ *      flash.c use.
+ *      Transfers are routed to the device model of the simulator.
+ */
+
+#ifndef XSPI_H_
+#define XSPI_H_
+
+#include "xintc.h"
+
+#define XST_SUCCESS					0
+#define XST_FAILURE					1
+
+#define XSP_MASTER_OPTION			0x1
+#define XSP_CLK_ACTIVE_LOW_OPTION	0x2
+#define XSP_CLK_PHASE_1_OPTION		0x4
+#define XSP_MANUAL_SSELECT_OPTION	0x10
+
+typedef struct {
+	u16 DeviceId;
+	UINTPTR BaseAddress;
+} XSpi_Config;
+
+typedef struct {
+	u32 slave;
+} XSpi;
+
+int XSpi_Initialize(XSpi *spi, u16 device_id);
+int XSpi_Stop(XSpi *spi);
+int XSpi_Start(XSpi *spi);
+XSpi_Config *XSpi_LookupConfig(u16 device_id);
+int XSpi_CfgInitialize(XSpi *spi, XSpi_Config *cfg, UINTPTR base_addr);
+int XSpi_SetOptions(XSpi *spi, u32 options);
+void XSpi_IntrGlobalDisable(XSpi *spi);
+int XSpi_SetSlaveSelect(XSpi *spi, u32 mask);
+int XSpi_Transfer(XSpi *spi, u8 *send, u8 *recv, unsigned int n);
+
+#endif /* XSPI_H_ */
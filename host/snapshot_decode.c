@@ -0,0 +1,365 @@
+/*
+ * snapshot_decode.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host side decoder for the blob returned by "get snapshot".
+ *
+ *      Input can be either the raw blob (as received over ethernet) or the hex
+ *      dump printed over uart (lines between "### Snapshot" and "### End").
+ *      Output is one "name = value" line per variable, same as "get all".
+ *
+ *      Build: gcc -O2 -o snapshot_decode snapshot_decode.c
+ *      Usage: snapshot_decode <file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+// Keep in sync with inc/snapshot.h.
+#define SNAPSHOT_MAGIC					0x5341544C
+#define SNAPSHOT_VERSION				1
+#define SNAPSHOT_HEADER_LENGTH			16
+#define SNAPSHOT_SECTION_HEADER_LENGTH	4
+
+#define SNAPSHOT_TYPE_U8				1
+#define SNAPSHOT_TYPE_U16				2
+#define SNAPSHOT_TYPE_U32				3
+#define SNAPSHOT_TYPE_F32				4
+
+// Keep in sync with inc/perf.h.
+#define SNAPSHOT_SECTION_PERF			18
+#define PERF_NAME_LENGTH				12
+#define PERF_SNAPSHOT_VALUES			11
+
+#define MAX_BLOB_LENGTH					65536
+
+typedef struct {
+	uint8_t id;
+	const char *title;
+	const char * const *names;
+	int nnames;
+} section_desc_t;
+
+static const char * const clocks_names[] = {
+	"v1ah", "v1al", "v1bh", "v1bl", "v2ch", "v2cl", "v3ah", "v3al", "v3bh", "v3bl",
+	"h1ah", "h1al", "h1bh", "h1bl", "h2ch", "h2cl", "h3ah", "h3al", "h3bh", "h3bl",
+	"swah", "swal", "swbh", "swbl", "rgah", "rgal", "rgbh", "rgbl", "ogah", "ogal",
+	"ogbh", "ogbl", "dgah", "dgal", "dgbh", "dgbl", "tgah", "tgal", "tgbh", "tgbl" };
+static const char * const clk_sw_names[] = { "ldac_n", "clr_n", "reset_n", "sw_en" };
+static const char * const biases_names[] = { "vdrain", "vdd", "vr", "vsub" };
+static const char * const bias_sw_names[] = {
+	"vdd_sw", "vdrain_sw", "vsub_sw", "vsub_load_sw", "vsub_rdiv_sw", "vr_sw", "p15v_sw", "m15v_sw" };
+static const char * const packer_names[] = { "packSource", "packStart" };
+static const char * const adc_names[] = {
+	"enA", "testPtrnA", "bitSlipA", "pdA", "enB", "testPtrnB", "bitSlipB", "pdB",
+	"enC", "testPtrnC", "bitSlipC", "pdC", "enD", "testPtrnD", "bitSlipD", "pdD" };
+static const char * const seq_sw_names[] = { "seqStart", "seqStartSrc" };
+static const char * const cds_names[] = {
+	"pinit", "sinit", "psamp", "ssamp", "cdsout",
+	"pinitA", "sinitA", "psampA", "ssampA", "cdsoutA", "pinitB", "sinitB", "psampB", "ssampB", "cdsoutB",
+	"pinitC", "sinitC", "psampC", "ssampC", "cdsoutC", "pinitD", "sinitD", "psampD", "ssampD", "cdsoutD" };
+static const char * const generic_names[] = { "echo", "outeth" };
+static const char * const leds_names[] = { "led0", "led1", "led2", "led3", "led4", "led5" };
+static const char * const smart_buffer_names[] = {
+	"bufASel", "bufBSel", "bufCSel", "bufDSel", "bufASamp", "bufBSamp", "bufCSamp", "bufDSamp",
+	"bufChMode", "bufAMode", "bufBMode", "bufCMode", "bufDMode", "bufCapMode", "bufCapSrc",
+	"bufCapStart", "bufCapEnd", "bufSpeed", "bufTraStart", "bufTraEnd", "bufReset" };
+static const char * const eth_names[] = { "ipEth" };
+static const char * const master_sel_names[] = { "isSlave" };
+static const char * const sync_gen_names[] = { "syncStop", "syncDelay" };
+static const char * const fr_meas_names[] = { "frFclk", "frFmeas" };
+static const char * const telemetry_names[] = {
+	"swa", "swb", "oga", "ogb", "rga", "rgb", "dga", "dgb", "h1a", "h1b", "h2c", "v2c",
+	"h3a", "h3b", "v1a", "v1b", "v3a", "v3b", "tga", "tgb", "v_p2v5", "v_p1v0", "v_p4v2",
+	"v_p1v8", "v_p5v0", "v_p2v5a", "v_p3v3", "v_m15v0", "v_p12v0", "v_p15v0", "ccd_vdd",
+	"ccd_vr", "ccd_vsub", "ccd_vdrain" };
+
+#define NAMES(x)	x, (int)(sizeof(x)/sizeof(x[0]))
+
+static const section_desc_t sections[] = {
+	{ 1,	"Clocks' Voltages",				NAMES(clocks_names) },
+	{ 2,	"Clocks' switches",				NAMES(clk_sw_names) },
+	{ 3,	"Bias Voltages",				NAMES(biases_names) },
+	{ 4,	"Bias Switches",				NAMES(bias_sw_names) },
+	{ 5,	"Packer",						NAMES(packer_names) },
+	{ 6,	"ADC",							NAMES(adc_names) },
+	{ 7,	"Sequencer",					NAMES(seq_sw_names) },
+	{ 8,	"Correlated Double Sampling",	NAMES(cds_names) },
+	{ 9,	"Generic Variables",			NAMES(generic_names) },
+	{ 10,	"Leds",							NAMES(leds_names) },
+	{ 11,	"Smart Buffer",					NAMES(smart_buffer_names) },
+	{ 12,	"Ethernet",						NAMES(eth_names) },
+	{ 13,	"Master Selection",				NAMES(master_sel_names) },
+	{ 14,	"Sync Generation",				NAMES(sync_gen_names) },
+	{ 15,	"Frequency Measurement",		NAMES(fr_meas_names) },
+	{ 16,	"Sequencer in RAM",				NULL, 0 },
+	{ 17,	"Telemetry values",				NAMES(telemetry_names) },
+	{ 18,	"Command latency (us)",			NULL, 0 },
+};
+
+static uint32_t get_u16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t crc32(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for (uint32_t i=0; i<length; i++)
+	{
+		crc ^= data[i];
+		for (int j=0; j<8; j++)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+		}
+	}
+	return ~crc;
+}
+
+static int type_size(uint8_t type)
+{
+	switch (type)
+	{
+	case SNAPSHOT_TYPE_U8:	return 1;
+	case SNAPSHOT_TYPE_U16:	return 2;
+	case SNAPSHOT_TYPE_U32:	return 4;
+	case SNAPSHOT_TYPE_F32:	return 4;
+	default:				return 0;
+	}
+}
+
+static const section_desc_t *find_section(uint8_t id)
+{
+	for (size_t i=0; i<sizeof(sections)/sizeof(sections[0]); i++)
+	{
+		if (sections[i].id == id)
+		{
+			return &sections[i];
+		}
+	}
+	return NULL;
+}
+
+static int hexval(int c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/*
+ * Loads the blob from file. Raw binary if it starts with the magic, uart hex
+ * dump otherwise.
+ */
+static long load_blob(const char *fname, uint8_t *blob)
+{
+	FILE *f = fopen(fname, "rb");
+	if (f == NULL)
+	{
+		perror(fname);
+		return -1;
+	}
+
+	static uint8_t raw[4*MAX_BLOB_LENGTH];
+	long n = fread(raw, 1, sizeof(raw), f);
+	fclose(f);
+
+	if (n >= 4 && get_u32(raw) == SNAPSHOT_MAGIC)
+	{
+		if (n > MAX_BLOB_LENGTH)
+		{
+			n = MAX_BLOB_LENGTH;
+		}
+		memcpy(blob, raw, n);
+		return n;
+	}
+
+	// Hex dump. Skip "###" lines.
+	long l = 0;
+	int skip = 0;
+	int hi = -1;
+	for (long i=0; i<n && l<MAX_BLOB_LENGTH; i++)
+	{
+		if (raw[i] == '#')
+		{
+			skip = 1;
+		}
+		else if (raw[i] == '\n' || raw[i] == '\r')
+		{
+			skip = 0;
+			hi = -1;
+		}
+		else if (!skip)
+		{
+			int v = hexval(raw[i]);
+			if (v < 0)
+			{
+				continue;
+			}
+			if (hi < 0)
+			{
+				hi = v;
+			}
+			else
+			{
+				blob[l++] = (hi << 4) | v;
+				hi = -1;
+			}
+		}
+	}
+	return l;
+}
+
+int main(int argc, char *argv[])
+{
+	static uint8_t blob[MAX_BLOB_LENGTH];
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <file>\n", argv[0]);
+		return 1;
+	}
+
+	long n = load_blob(argv[1], blob);
+	if (n < SNAPSHOT_HEADER_LENGTH)
+	{
+		fprintf(stderr, "Snapshot too short\n");
+		return 1;
+	}
+
+	// Header.
+	uint32_t magic 		= get_u32(blob);
+	uint32_t version 	= get_u16(blob + 4);
+	uint32_t nsections 	= get_u16(blob + 6);
+	uint32_t length 	= get_u32(blob + 8);
+	uint32_t crc 		= get_u32(blob + 12);
+
+	if (magic != SNAPSHOT_MAGIC)
+	{
+		fprintf(stderr, "Bad magic 0x%08x\n", magic);
+		return 1;
+	}
+	if (version > SNAPSHOT_VERSION)
+	{
+		fprintf(stderr, "Warning: snapshot version %u is newer than decoder (%u)\n", version, SNAPSHOT_VERSION);
+	}
+	if (length > n || length < SNAPSHOT_HEADER_LENGTH)
+	{
+		fprintf(stderr, "Truncated snapshot: header says %u bytes, got %ld\n", length, n);
+		return 1;
+	}
+	if (crc32(blob + SNAPSHOT_HEADER_LENGTH, length - SNAPSHOT_HEADER_LENGTH) != crc)
+	{
+		fprintf(stderr, "CRC mismatch\n");
+		return 1;
+	}
+
+	printf("### Snapshot v%u, %u bytes, %u sections ###\n\n", version, length, nsections);
+
+	// Sections.
+	uint32_t idx = SNAPSHOT_HEADER_LENGTH;
+	for (uint32_t s=0; s<nsections; s++)
+	{
+		if (idx + SNAPSHOT_SECTION_HEADER_LENGTH > length)
+		{
+			fprintf(stderr, "Section %u truncated\n", s);
+			return 1;
+		}
+
+		uint8_t id 		= blob[idx];
+		uint8_t type 	= blob[idx+1];
+		uint32_t count 	= get_u16(blob + idx + 2);
+		int size 		= type_size(type);
+		idx += SNAPSHOT_SECTION_HEADER_LENGTH;
+
+		if (size == 0 || idx + count*size > length)
+		{
+			fprintf(stderr, "Section %u (id %u) malformed\n", s, id);
+			return 1;
+		}
+
+		const section_desc_t *desc = find_section(id);
+		if (desc == NULL)
+		{
+			// Unknown section from a newer firmware: skip it.
+			idx += count*size;
+			continue;
+		}
+
+		printf("### %s ###\n", desc->title);
+
+		// One line per command type, name first.
+		if (id == SNAPSHOT_SECTION_PERF && type == SNAPSHOT_TYPE_U32)
+		{
+			for (uint32_t i=0; i+PERF_SNAPSHOT_VALUES<=count; i+=PERF_SNAPSHOT_VALUES)
+			{
+				const uint8_t *p = blob + idx + i*size;
+				const uint8_t *v = p + PERF_NAME_LENGTH;
+				printf("%.*s : count %u, min %u, p50 %u, p99 %u, max %u, parse %u, exec %u, output %u\n",
+						PERF_NAME_LENGTH, (const char *) p, get_u32(v), get_u32(v+4), get_u32(v+8),
+						get_u32(v+12), get_u32(v+16), get_u32(v+20), get_u32(v+24), get_u32(v+28));
+			}
+			printf("\n");
+			idx += count*size;
+			continue;
+		}
+
+		for (uint32_t i=0; i<count; i++)
+		{
+			const uint8_t *p = blob + idx + i*size;
+			char name[32];
+
+			if (desc->names != NULL && (int)i < desc->nnames)
+			{
+				snprintf(name, sizeof(name), "%s", desc->names[i]);
+			}
+			else
+			{
+				snprintf(name, sizeof(name), "@%u", i);
+			}
+
+			switch (type)
+			{
+			case SNAPSHOT_TYPE_U8:
+				printf("%s = %u\n", name, p[0]);
+				break;
+			case SNAPSHOT_TYPE_U16:
+				printf("%s = %u\n", name, get_u16(p));
+				break;
+			case SNAPSHOT_TYPE_U32:
+				if (id == 12)
+				{
+					uint32_t ip = get_u32(p);
+					printf("%s = %u.%u.%u.%u\n", name, (ip >> 24) & 0xFF, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+				}
+				else
+				{
+					printf("%s = %u\n", name, get_u32(p));
+				}
+				break;
+			case SNAPSHOT_TYPE_F32:
+			{
+				union { uint32_t u; float f; } conv;
+				conv.u = get_u32(p);
+				printf("%s = %.3f\n", name, conv.f);
+				break;
+			}
+			}
+		}
+		printf("\n");
+
+		idx += count*size;
+	}
+
+	return 0;
+}
@@ -0,0 +1,271 @@
+/*
+ * telemetry_decode.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host side decoder for the frames pushed with "set telStream 1".
+ *
+ *      Input is a capture of the board output: either the raw stream received
+ *      over ethernet (frames can be mixed with text answers, the decoder looks
+ *      for the magic) or the uart log, where every frame is a hex dump between
+ *      "### Telemetry" and "### End".
+ *      Output is CSV, one line per frame: seq, tick and the value of every
+ *      source in volts (nan if never read). With -a, the age in ms of every
+ *      value is added after it. Frames with a bad CRC and gaps in seq are
+ *      reported on stderr.
+ *
+ *      Build: gcc -O2 -o telemetry_decode telemetry_decode.c
+ *      Usage: telemetry_decode [-a] <file>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+// Keep in sync with inc/telemetry_stream.h.
+#define TELEMETRY_STREAM_MAGIC			0x5441544C
+#define TELEMETRY_STREAM_VERSION		1
+#define TELEMETRY_STREAM_HEADER_LENGTH	20
+#define TELEMETRY_STREAM_ENTRY_LENGTH	8
+
+#define MAX_CAPTURE_LENGTH				(16*1024*1024)
+
+static const char * const telemetry_names[] = {
+	"swa", "swb", "oga", "ogb", "rga", "rgb", "dga", "dgb", "h1a", "h1b", "h2c", "v2c",
+	"h3a", "h3b", "v1a", "v1b", "v3a", "v3b", "tga", "tgb", "v_p2v5", "v_p1v0", "v_p4v2",
+	"v_p1v8", "v_p5v0", "v_p2v5a", "v_p3v3", "v_m15v0", "v_p12v0", "v_p15v0", "ccd_vdd",
+	"ccd_vr", "ccd_vsub", "ccd_vdrain" };
+
+#define NNAMES		(int)(sizeof(telemetry_names)/sizeof(telemetry_names[0]))
+
+static uint32_t get_u16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t crc32(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	for (uint32_t i=0; i<length; i++)
+	{
+		crc ^= data[i];
+		for (int j=0; j<8; j++)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+		}
+	}
+	return ~crc;
+}
+
+static int hexval(int c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
+
+/*
+ * Converts the hex dumps of a uart log back to binary, in place. Only lines
+ * between "### Telemetry" and "### End" are taken.
+ */
+static long unhex(uint8_t *buf, long n)
+{
+	long l = 0;
+	int inside = 0;
+	long i = 0;
+
+	while (i < n)
+	{
+		// One line at a time.
+		long end = i;
+		while (end < n && buf[end] != '\n' && buf[end] != '\r')
+		{
+			end++;
+		}
+
+		if (end - i >= 3 && memcmp(buf + i, "###", 3) == 0)
+		{
+			if (end - i >= 13 && memcmp(buf + i, "### Telemetry", 13) == 0)
+			{
+				inside = 1;
+			}
+			else if (end - i >= 7 && memcmp(buf + i, "### End", 7) == 0)
+			{
+				inside = 0;
+			}
+		}
+		else if (inside)
+		{
+			int hi = -1;
+			for (long k=i; k<end; k++)
+			{
+				int v = hexval(buf[k]);
+				if (v < 0)
+				{
+					hi = -1;
+					continue;
+				}
+				if (hi < 0)
+				{
+					hi = v;
+				}
+				else
+				{
+					// l never gets ahead of k, safe to write in place.
+					buf[l++] = (hi << 4) | v;
+					hi = -1;
+				}
+			}
+		}
+
+		i = end + 1;
+	}
+
+	return l;
+}
+
+int main(int argc, char *argv[])
+{
+	int ages = 0;
+	int c;
+
+	while ((c = getopt(argc, argv, "a")) != -1)
+	{
+		switch (c)
+		{
+		case 'a': ages = 1; break;
+		default:
+			fprintf(stderr, "Usage: %s [-a] <file>\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (optind != argc - 1)
+	{
+		fprintf(stderr, "Usage: %s [-a] <file>\n", argv[0]);
+		return 1;
+	}
+
+	FILE *f = fopen(argv[optind], "rb");
+	if (f == NULL)
+	{
+		perror(argv[optind]);
+		return 1;
+	}
+
+	uint8_t *buf = malloc(MAX_CAPTURE_LENGTH);
+	if (buf == NULL)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+	long n = fread(buf, 1, MAX_CAPTURE_LENGTH, f);
+	fclose(f);
+
+	// Uart log if there is a hex dump marker in it.
+	for (long i=0; i+13<=n; i++)
+	{
+		if (memcmp(buf + i, "### Telemetry", 13) == 0)
+		{
+			n = unhex(buf, n);
+			break;
+		}
+	}
+
+	// Header line.
+	printf("seq,tick");
+	for (int i=0; i<NNAMES; i++)
+	{
+		printf(ages ? ",%s,%s_age" : ",%s", telemetry_names[i], telemetry_names[i]);
+	}
+	printf("\n");
+
+	uint32_t nframes = 0, nbad = 0, nlost = 0;
+	uint32_t last_seq = 0;
+	int have_seq = 0;
+	long idx = 0;
+
+	while (idx + TELEMETRY_STREAM_HEADER_LENGTH <= n)
+	{
+		if (get_u32(buf + idx) != TELEMETRY_STREAM_MAGIC)
+		{
+			idx++;
+			continue;
+		}
+
+		uint32_t version 	= get_u16(buf + idx + 4);
+		uint32_t nsources 	= get_u16(buf + idx + 6);
+		uint32_t seq 		= get_u32(buf + idx + 8);
+		uint32_t tick 		= get_u32(buf + idx + 12);
+		uint32_t crc 		= get_u32(buf + idx + 16);
+		uint32_t plen 		= nsources * TELEMETRY_STREAM_ENTRY_LENGTH;
+		const uint8_t *p 	= buf + idx + TELEMETRY_STREAM_HEADER_LENGTH;
+
+		if (idx + TELEMETRY_STREAM_HEADER_LENGTH + plen > n)
+		{
+			fprintf(stderr, "Frame %u truncated\n", seq);
+			break;
+		}
+		if (version > TELEMETRY_STREAM_VERSION || crc32(p, plen) != crc)
+		{
+			// Could also be a magic look-alike inside other data: resync.
+			nbad++;
+			idx++;
+			continue;
+		}
+
+		if (have_seq && seq != last_seq + 1)
+		{
+			fprintf(stderr, "Gap: seq %u after %u\n", seq, last_seq);
+			nlost += seq - last_seq - 1;
+		}
+		last_seq = seq;
+		have_seq = 1;
+		nframes++;
+
+		printf("%u,%u", seq, tick);
+		for (uint32_t i=0; i<nsources; i++)
+		{
+			union { uint32_t u; float f; } conv;
+			uint32_t tstamp = get_u32(p + i*TELEMETRY_STREAM_ENTRY_LENGTH);
+			conv.u = get_u32(p + i*TELEMETRY_STREAM_ENTRY_LENGTH + 4);
+
+			if (conv.f != conv.f)
+			{
+				printf(",nan");
+			}
+			else
+			{
+				printf(",%.4f", conv.f);
+			}
+			if (ages)
+			{
+				if (tstamp == 0)
+				{
+					printf(",");
+				}
+				else
+				{
+					printf(",%u", tick - tstamp);
+				}
+			}
+		}
+		printf("\n");
+
+		idx += TELEMETRY_STREAM_HEADER_LENGTH + plen;
+	}
+
+	fprintf(stderr, "%u frames, %u lost, %u bad\n", nframes, nlost, nbad);
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,282 @@
+/*
+ * telemetry_sim.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Host simulator of the telemetry chain: builds src/telemetry.c against
+ *      the stand-in drivers in host/sim and a model of the muxes and the
+ *      AD7328.
+ *
+ *      Every source is given a different input voltage. The simulator reads
+ *      all of them one by one with telemetry_read and then in one sweep with
+ *      telemetry_read_all, checks both against the inputs and prints the SPI
+ *      transfers each method took.
+ *
+ *      The telemetry is traced with src/spi_trace.c, as on the board, and the
+ *      SPI traffic of every command (what "get spi" shows for the last one) is
+ *      checked against a budget: two transfers and one slave select per
+ *      telemetry_read, and at most TELEMETRY_SIM_READ_ALL_BUDGET transfers and
+ *      one slave select for telemetry_read_all.
+ *
+ *      AD7328 model:
+ *      -> the word sent in a frame takes effect at the end of the frame, and
+ *         the conversion output in a frame is for the channel selected before
+ *         it, sampled with the mux as it is at that moment.
+ *      -> control write with SEQ_NOT selects ADD2-0. With SEQ_PRG it selects
+ *         the first channel of the sequence register.
+ *      -> with SEQ_PRG, every frame with W = 0 moves to the next channel of the
+ *         sequence, wrapping around.
+ *
+ *      Build: gcc -O2 -Ihost/sim -Iinc -o telemetry_sim host/telemetry_sim.c src/telemetry.c src/spi_trace.c -lm
+ *      Usage: telemetry_sim
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+
+#include "xspi.h"
+#include "xgpio.h"
+#include "telemetry.h"
+#include "spi_trace.h"
+
+// Model state.
+static u32 gpio_pins;
+static uint8_t ad_seq_mode;
+static uint8_t ad_seq_mask;
+static uint8_t ad_cur;
+
+// Input codes, indexed by mux enable bit, mux address and AD channel.
+static int16_t input_code[3][8][8];
+
+static int mux_index(uint8_t mux_en)
+{
+	return (mux_en == TELEMETRY_MUX_EN0) ? 0 : (mux_en == TELEMETRY_MUX_EN1) ? 1 : 2;
+}
+
+// Conversion of channel ch with the current mux setting.
+static uint16_t ad_convert(uint8_t ch)
+{
+	uint8_t en = (gpio_pins >> TELEMETRY_MUX_EN_OFFSET) & 0x7;
+	uint8_t addr = (gpio_pins >> TELEMETRY_MUX_CH_OFFSET) & 0x7;
+	int16_t code = 0;
+
+	// Disabled muxes leave their outputs floating, read as 0.
+	for (int m=0; m<3; m++)
+	{
+		if (en & (1 << m))
+		{
+			code += input_code[m][addr][ch];
+		}
+	}
+
+	return (ch << TELEMETRY_DATA_CHID_OFFSET) | (code & 0x1FFF);
+}
+
+static uint8_t ad_next(uint8_t ch)
+{
+	for (int k=1; k<=8; k++)
+	{
+		uint8_t c = (ch + k) % 8;
+		if (ad_seq_mask & (1 << c))
+		{
+			return c;
+		}
+	}
+	return ch;
+}
+
+static uint16_t ad_frame(uint16_t in)
+{
+	uint16_t out = ad_convert(ad_cur);
+	uint8_t cmd = in >> 13;
+
+	if (cmd == TELEMETRY_CMD_WRITE_CTRL)
+	{
+		ad_seq_mode = (in >> TELEMETRY_SEQ_OFFSET) & 0x3;
+		if (ad_seq_mode == TELEMETRY_SEQ_PRG)
+		{
+			ad_cur = ad_next(7);
+		}
+		else
+		{
+			ad_cur = (in >> (8 + TELEMETRY_AD_CH_OFFSET)) & 0x7;
+		}
+	}
+	else if (cmd == TELEMETRY_CMD_WRITE_SEQ)
+	{
+		ad_seq_mask = 0;
+		for (int k=0; k<8; k++)
+		{
+			if (in & (1 << (TELEMETRY_SEQ_REG_VIN0_OFFSET - k)))
+			{
+				ad_seq_mask |= 1 << k;
+			}
+		}
+	}
+	else if ((in & 0x8000) == 0 && ad_seq_mode == TELEMETRY_SEQ_PRG)
+	{
+		ad_cur = ad_next(ad_cur);
+	}
+
+	return out;
+}
+
+// SPI budget of telemetry_read_all with the sources of telemetry.c, as it is
+// now. More is a regression.
+#define TELEMETRY_SIM_READ_ALL_BUDGET	43
+
+// Stand-in drivers.
+static XSpi_Config spi_cfg;
+
+int XSpi_Initialize(XSpi *spi, u16 device_id) { return XST_SUCCESS; }
+int XSpi_Stop(XSpi *spi) { return XST_SUCCESS; }
+int XSpi_Start(XSpi *spi) { return XST_SUCCESS; }
+XSpi_Config *XSpi_LookupConfig(u16 device_id) { return &spi_cfg; }
+int XSpi_CfgInitialize(XSpi *spi, XSpi_Config *cfg, UINTPTR base_addr) { return XST_SUCCESS; }
+int XSpi_SetOptions(XSpi *spi, u32 options) { return XST_SUCCESS; }
+void XSpi_IntrGlobalDisable(XSpi *spi) { }
+int XSpi_SetSlaveSelect(XSpi *spi, u32 mask) { spi->slave = mask; return XST_SUCCESS; }
+
+int XSpi_Transfer(XSpi *spi, u8 *send, u8 *recv, unsigned int n)
+{
+	if (n != 2)
+	{
+		return XST_FAILURE;
+	}
+
+	uint16_t out = ad_frame((send[0] << 8) | send[1]);
+	if (recv != NULL)
+	{
+		recv[0] = out >> 8;
+		recv[1] = out & 0xFF;
+	}
+	return XST_SUCCESS;
+}
+
+int XGpio_Initialize(XGpio *gpio, u16 device_id) { return XST_SUCCESS; }
+void XGpio_SetDataDirection(XGpio *gpio, unsigned channel, u32 mask) { }
+void XGpio_DiscreteWrite(XGpio *gpio, unsigned channel, u32 data) { gpio_pins = data; }
+
+uint32_t tget_ms(void) { return 0; }
+uint32_t perf_ticks(void) { return 0; }
+uint32_t perf_us(uint32_t t0, uint32_t t1) { return t1 - t0; }
+
+void io_sprintf(char *str, char *fmt, ...)
+{
+	va_list ap;
+	va_start(ap, fmt);
+	vsprintf(str, fmt, ap);
+	va_end(ap);
+}
+
+uint32_t io_crc32(uint32_t crc, const uint8_t *data, uint32_t length) { return 0; }
+void mprint(const char *str) { fputs(str, stdout); }
+void io_put_bin(const char *title, const uint8_t *data, uint32_t length) { }
+
+void io_put_u16(uint8_t *p, uint16_t val)
+{
+	p[0] = val & 0xFF;
+	p[1] = (val >> 8) & 0xFF;
+}
+
+void io_put_u32(uint8_t *p, uint32_t val)
+{
+	io_put_u16(p, val & 0xFFFF);
+	io_put_u16(p + 2, (val >> 16) & 0xFFFF);
+}
+
+static int check(const char *what, telemetry_source_t *src, const float *values, const int *status)
+{
+	int errors = 0;
+
+	for (int i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		int16_t code = input_code[mux_index(src[i].mux_en)][src[i].mux_ch][src[i].ad_ch];
+		float expected = code * src[i].gain * (float)TELEMETRY_AD_MAX_VOLT / (float)TELEMETRY_AD_MAX_COUNT;
+
+		if (status[i] != 0 || fabsf(values[i] - expected) > 1e-6f)
+		{
+			printf("%s: %s read %f, expected %f (status %d)\n", what, src[i].name, values[i], expected, status[i]);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+// Telemetry SPI traffic since the previous call, as one command.
+static spi_trace_count_t spi_command(void)
+{
+	spi_trace_count_t c;
+
+	spi_trace_command();
+	spi_trace_get(SPI_TRACE_TELEMETRY, 1, &c);
+
+	return c;
+}
+
+static int check_spi(const char *what, spi_trace_count_t c, uint32_t transfers, uint32_t max_transfers)
+{
+	if (c.transfers < transfers || c.transfers > max_transfers || c.selects != 1 || c.errors != 0 || c.bytes != 2*c.transfers)
+	{
+		printf("%s: %u transfers (budget %u to %u), %u selects, %u bytes, %u errors\n",
+				what, c.transfers, transfers, max_transfers, c.selects, c.bytes, c.errors);
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(void)
+{
+	telemetry_group_t group;
+	telemetry_source_t *src = (telemetry_source_t *) &group;
+	float values[TELEMETRY_NSOURCES];
+	int status[TELEMETRY_NSOURCES];
+	int errors = 0;
+
+	telemetry_init(&group, 0, 0);
+
+	// Different code for every source, negative ones included.
+	for (int i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		input_code[mux_index(src[i].mux_en)][src[i].mux_ch][src[i].ad_ch] = (i - 10) * 97;
+	}
+
+	// One by one.
+	uint32_t t0 = telemetry_get_transfers();
+	spi_command();
+	for (int i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		status[i] = telemetry_read(&src[i], &values[i]);
+		errors += check_spi(src[i].name, spi_command(), 2, 2);
+	}
+	uint32_t single = telemetry_get_transfers() - t0;
+	errors += check("telemetry_read", src, values, status);
+
+	// Burst. Also checks that a single read afterwards still works.
+	memset(values, 0, sizeof(values));
+	t0 = telemetry_get_transfers();
+	telemetry_read_all(&group, values, status);
+	uint32_t burst = telemetry_get_transfers() - t0;
+	errors += check_spi("telemetry_read_all", spi_command(), burst, TELEMETRY_SIM_READ_ALL_BUDGET);
+	errors += check("telemetry_read_all", src, values, status);
+
+	float v;
+	if (telemetry_read(&src[0], &v) != 0)
+	{
+		printf("telemetry_read after telemetry_read_all failed\n");
+		errors++;
+	}
+
+	printf("%d sources\n", TELEMETRY_NSOURCES);
+	printf("telemetry_read     : %u SPI transfers\n", single);
+	printf("telemetry_read_all : %u SPI transfers\n", burst);
+	printf("%s\n", errors ? "FAILED" : "OK");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "cds_model.h"
+#include "trace.h"
+
+int32_t *trace_load(const char *fname, int raw, int is_unsigned, uint32_t *n)
+{
+	FILE *f = fopen(fname, raw ? "rb" : "r");
+	if (f == NULL)
+	{
+		perror(fname);
+		return NULL;
+	}
+
+	uint32_t cap = 1 << 16;
+	uint32_t l = 0;
+	int32_t *x = malloc(cap * sizeof(int32_t));
+
+	while (x != NULL)
+	{
+		uint32_t v;
+		if (raw)
+		{
+			uint8_t b[8];
+			if (fread(b, 1, 8, f) != 8) break;
+			v = b[0] | (b[1] << 8) | ((uint32_t)b[2] << 16);
+		}
+		else
+		{
+			long t;
+			if (fscanf(f, "%ld", &t) != 1) break;
+			v = (uint32_t)t;
+		}
+
+		if (l == cap)
+		{
+			cap *= 2;
+			x = realloc(x, cap * sizeof(int32_t));
+			if (x == NULL) break;
+		}
+
+		if (raw)
+		{
+			x[l++] = is_unsigned ? (int32_t)(v & 0x3FFFF) : cds_model_sext18(v);
+		}
+		else
+		{
+			x[l++] = (int32_t)v;
+		}
+	}
+	fclose(f);
+
+	*n = l;
+	return x;
+}
+
+int32_t *trace_load_board(const char *fname, uint32_t *n)
+{
+	FILE *f = fopen(fname, "rb");
+	if (f == NULL)
+	{
+		perror(fname);
+		return NULL;
+	}
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	uint32_t l = size / 8;
+	int32_t *y = malloc((l + 1) * sizeof(int32_t));
+	uint8_t b[8];
+	for (uint32_t i=0; y != NULL && i<l; i++)
+	{
+		if (fread(b, 1, 8, f) != 8)
+		{
+			l = i;
+			break;
+		}
+		y[i] = (int32_t)(b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24));
+	}
+	fclose(f);
+
+	*n = l;
+	return y;
+}
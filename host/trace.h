@@ -0,0 +1,27 @@
+/*
+ * trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Loading of raw smart buffer traces and board CDS output for host tools.
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stdint.h>
+
+/*
+ * Loads a trace. raw != 0: 64-bit little endian packer packets (source RAW from
+ * Smart Buffer), 18-bit data in bits 17-0, sign extended unless is_unsigned.
+ * raw == 0: text, one sample per line. Returns a malloc'ed array of n samples.
+ */
+int32_t *trace_load(const char *fname, int raw, int is_unsigned, uint32_t *n);
+
+/*
+ * Loads CDS packets sent by the board (64-bit little endian, data in bits 31-0).
+ */
+int32_t *trace_load_board(const char *fname, uint32_t *n);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,47 @@
+/*
+ * acq.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Multi-frame acquisition runs.
+ *
+ *      "set acqRun 1" takes acqFrames images back to back with the sequencer
+ *      program in RAM, and "set acqRun 0" aborts the run. For every frame:
+ *
+ *      clean   : ccd_erase and/or cdd_epurge, as selected by acqClean
+ *                (ACQ_CLEAN_*), before the first frame or every frame.
+ *      expose  : acqExpo ms.
+ *      readout : packer, sync generator and sequencer are started, and the
+ *                frame ends on the sequencer end of sequence ("Read done").
+ *
+ *      The exposure of frame N+1 starts as soon as the readout of frame N ends,
+ *      and the report of frame N is sent while it runs:
+ *
+ *      Frame <n>: expo <ms>, readout <ms>, dead <ms>
+ *
+ *      where dead is the time between the end of the previous readout (start of
+ *      the run for the first frame) and the start of this exposure. A summary
+ *      with min/mean/max of each is printed at the end, or with "get acq".
+ *
+ *      acqFrame is read only and counts the frames done.
+ */
+
+#ifndef ACQ_H_
+#define ACQ_H_
+
+#include "defines.h"
+
+void acq_init(acq_t *acq);
+int acq_change_status(system_state_t *sys, acq_var_t *var, uint32_t value);
+
+// Call on sequencer end of sequence.
+void acq_eos(system_state_t *sys);
+
+// Called from the main loop: moves the run to the next step when due.
+void acq_poll(system_state_t *sys);
+
+// Timing statistics of the current or last run.
+void acq_print(acq_t *acq);
+
+#endif /* ACQ_H_ */
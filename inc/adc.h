@@ -112,7 +112,7 @@ typedef struct {
 	uint8_t min;
 	uint8_t max;
 	uint8_t bit_position;
-	char name[10];
+	const char *name;
 } adc_sw_status_t;
 
 typedef struct {
@@ -75,6 +75,21 @@
  * 01 : signal.
  * 10 : signal - pedestal.
  * 11 : pedestal - signal.
+ *
+ * ################
+ * ### Channels ###
+ * ################
+ * There is one core per amplifier (A..D). Each core has its own set of
+ * variables, named after the register plus the channel letter (pinitA,
+ * sinitB, ...), so every amplifier can use its own integration window.
+ *
+ * The variables without channel letter (pinit, sinit, ...) are a broadcast
+ * alias: writing them sets the same value on the four channels. Their value
+ * follows the channels: the common value if the four agree, "mixed" on get
+ * otherwise. Per channel variables always hold what is in hardware.
+ *
+ * Every variable keeps a shadow of the register. Writing the value already
+ * in the register is accepted but does not touch the bus.
  */
 #ifndef CDS_CORE_H
 #define CDS_CORE_H
@@ -118,6 +133,8 @@
 #define CDS_CORE_OUTSEL_SIG_m_PED		2
 #define CDS_CORE_OUTSEL_PED_m_SIG		3
 
+#define CDS_CORE_BROADCAST				0	// Base address of the broadcast alias.
+
 
 typedef struct {
 	uint16_t value;
@@ -126,7 +143,9 @@ typedef struct {
 	uint32_t reg_offset;
 	uint32_t reg_mask;
 	uint32_t nbits;
-	char name[10];
+	uint32_t base_addr;
+	const char *name;
+	uint8_t mixed;					// Alias only: channels differ, value is channel A's.
 }cds_var_status_t;
 
 typedef struct {
@@ -137,14 +156,22 @@ typedef struct {
 	cds_var_status_t outsel;
 }cds_var_group_status_t;
 
+typedef struct {
+	cds_var_group_status_t all;		// Broadcast alias.
+	cds_var_group_status_t cha;
+	cds_var_group_status_t chb;
+	cds_var_group_status_t chc;
+	cds_var_group_status_t chd;
+}cds_t;
+
 #define CDS_CORE_mWriteReg(BaseAddress, RegOffset, Data) \
   	Xil_Out32((BaseAddress) + (RegOffset), (u32)(Data))
 
 #define CDS_CORE_mReadReg(BaseAddress, RegOffset) \
     Xil_In32((BaseAddress) + (RegOffset))
 
-int cds_core_init(cds_var_group_status_t *cds_var_group);
-int cds_core_change_var_value(cds_var_status_t *cds_var, const uint16_t value);
+int cds_core_init(cds_t *cds);
+int cds_core_change_var_value(cds_t *cds, cds_var_status_t *cds_var, const uint16_t value);
 
 
 #endif // CDS_CORE_H
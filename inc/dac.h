@@ -191,7 +191,7 @@ typedef struct {
 	uint8_t min;
 	uint8_t max;
 	uint8_t bit_position;
-	char name[10];
+	const char *name;
 } clk_sw_status_t;
 
 typedef struct {
@@ -215,7 +215,7 @@ typedef struct {
 	float offset;
 	float gain;
 	float max_code;
-	char name[10];
+	const char *name;
 } clk_status_t;
 
 //Variable for maintaining the state of the clocks
@@ -33,6 +33,10 @@
 #define USERWORDLENTHG 		50
 #define USERNUMBWORDS 		5
 
+// Marks the error line of a failed command, right after "Done". Nothing
+// else prints it, so hosts can tell it from unsolicited "###" lines.
+#define CMD_FAILED_PREFIX	"FAILED: "
+
 #define NO_WORD 	0
 #define ONE_WORD 	1
 #define TWO_WORD 	2
@@ -55,6 +59,7 @@ typedef struct {
 
 typedef struct {
 	seq_t 						seq;
+	acq_t						acq;
 	packer_sw_group_status_t 	packer_sw;
 	gpio_adc_t 					gpio_adc;
 	gpio_sw_t 					gpio_sw;
@@ -62,18 +67,26 @@ typedef struct {
 	clk_sw_t 					clk_sw;
 	clk_group_status_t 			clks;
 	bias_group_status_t 		biases;
-	cds_var_group_status_t 		cds;
+	cds_t 						cds;
 	telemetry_group_t 			telemetry;
+	telemetry_scan_t			telemetry_scan;
+	telemetry_stream_t			telemetry_stream;
+	interlock_t					interlock;
 	uint8_t 					go;
 	exec_t 						exec;
 	generic_vars_t 				generic_vars;
 	leds_t						leds;
 	smart_buffer_group_status_t	smart_buffer;
+	smart_buffer_stream_t		smart_buffer_stream;
+	smart_buffer_trig_t			smart_buffer_trig;
+	smart_buffer_cal_t			smart_buffer_cal;
 	eth_t						eth;
 	flash_version_t				flash;
 	master_sel_t				master_sel;
 	sync_gen_t					sync_gen;
+	sync_align_t				sync_align;
 	fr_meas_t					fr_meas;
+	fr_mon_t					fr_mon;
 } system_state_t;
 
 
@@ -13,6 +13,7 @@
 #include <stdint.h>
 
 #define ETH_MAX_DATALENGTH			256
+#define ETH_HANDSHAKE_TIMEOUT_MS	1000	// Per step, as eth_sdata_handshake.
 
 #define ETH_IP_DEFAULT	0x00000000
 #define ETH_IP_MIN		0x00000000
@@ -31,7 +32,7 @@ typedef struct {
 	uint32_t val;
 	uint32_t min;
 	uint32_t max;
-	char name[10];
+	const char *name;
 	char valStr[ETH_IP_STR_LENGTH];
 } eth_status_t;
 
@@ -75,6 +76,28 @@ int eth_init(uint32_t gpio_device_id, eth_t *eth);
 unsigned int eth_mdata_get(uint8_t *buf);
 void eth_sdata_put(const char *str);
 
+/*
+ * Binary version of eth_sdata_put. Data longer than ETH_MAX_DATALENGTH is sent
+ * in consecutive chunks, each one with its own dready/dack handshake. The master
+ * gets the size of each chunk from dlength.
+ */
+void eth_sdata_put_bin(const uint8_t *data, uint32_t length);
+int eth_sdata_handshake(void);
+
+/*
+ * Non-blocking eth_sdata_put_bin, for data the host did not ask for. Starts
+ * the transfer and returns, eth_sdata_async_poll does one handshake step per
+ * call. data must stay valid until it is done. No 5 s delay on a missing ack.
+ *
+ * eth_sdata_put_bin_async returns -1 if the previous transfer is still
+ * pending. eth_sdata_async_poll returns 1 while pending, 0 when done and -1
+ * (once) if the host did not take a chunk. The blocking puts finish a pending
+ * transfer first, so it never lands in the middle of their data.
+ */
+int eth_sdata_put_bin_async(const uint8_t *data, uint32_t length);
+int eth_sdata_async_poll(void);
+void eth_sdata_async_wait(void);
+
 void eth_uint2ip(uint32_t ip, char *str);
 uint32_t eth_ip2uint(char *str);
 
@@ -11,8 +11,8 @@
 typedef int (*fptr_t)(void *arg);
 
 typedef struct {
-	char name[30];
-	char description[100];
+	const char *name;
+	const char *description;
 	fptr_t func;
 } exec_func_t;
 
@@ -27,12 +27,16 @@
 #define COMMAND_WRITE_EXTENDED_ADDRESS				0xC5
 /*************************************************************************************************/
 #define COMMAND_PAGE_PROGRAM						0x02 /* Page Program command */
+#define COMMAND_4BYTE_PAGE_PROGRAM					0x12 /* 4-BYTE PAGE PROGRAM 12h */
 /*************************************************************************************************/
 #define COMMAND_READ_ID								0x9E /* READ ID 9E/9Fh  */
 #define COMMAND_READ_DISCOVERY						0x5A /* READ SERIAL FLASH DISCOVERY PARAMETER 5Ah */
 #define COMMAND_READ								0x03 /* Random read command */
+#define COMMAND_FAST_READ							0x0B /* FAST READ 0Bh */
+#define COMMAND_4BYTE_FAST_READ						0x0C /* 4-BYTE FAST READ 0Ch */
 /*************************************************************************************************/
 #define COMMAND_SECTOR_ERASE						0xD8 /* Sector Erase command */
+#define COMMAND_4BYTE_SECTOR_ERASE					0xDC /* 4-BYTE SECTOR ERASE DCh */
 #define COMMAND_BULK_ERASE							0xC7 /* Bulk Erase command */
 #define COMMAND_SUBSECTOR_ERASE 					0x20 /* SUBSECTOR ERASE 20h */
 #define COMMAND_4BYTE_SUBSECTOR_ERASE 				0x21 /* 4-BYTE SUBSECTOR ERASE 21h */
@@ -42,6 +46,7 @@
  * This definitions specify the EXTRA bytes for each command.
  */
 #define READ_WRITE_EXTRA_BYTES		5 /* Read/Write extra bytes */
+#define FAST_READ_EXTRA_BYTES		6 /* Command, 4 address bytes and 1 dummy byte */
 #define	WRITE_ENABLE_BYTES			1 /* Write Enable bytes */
 #define STATUS_READ_BYTES			2 /* Status read bytes count */
 #define STATUS_WRITE_BYTES			2 /* Status write bytes count */
@@ -60,6 +65,12 @@
 #define	BYTE_PER_SUBSECTOR			4096
 #define NOB_PAGES					262144
 
+/*
+ * Bytes per transaction in flash_readBuffer. Bigger chunks spend less time in
+ * command overhead, but the chunk buffer is static RAM.
+ */
+#define FLASH_READ_CHUNK			1024
+
 /*
  * Byte Positions.
  */
@@ -75,6 +86,21 @@
 #define FLASH_BOARD_INFO_ADDR		0x3ffff00
 #define FLASH_BOARD_INFO_LENGTH		40
 
+/*
+ * Tuned parameters stored by the firmware itself (one subsector below the board
+ * info). Layout: magic (4) | bufSpeed (2) | reserved (2).
+ */
+#define FLASH_PARAMS_ADDR			0x3ffe000
+#define FLASH_PARAMS_LENGTH			8
+#define FLASH_PARAMS_MAGIC			0x5041544C	// "LTAP".
+
+/*
+ * Configuration profiles (see profile.h): one subsector per profile, in the
+ * sector below the one holding the params and the board info.
+ */
+#define FLASH_PROFILE_ADDR			0x3fe0000
+#define FLASH_PROFILE_NSLOTS		16
+
 /*
  * Variable definitions.
  */
@@ -122,6 +148,12 @@ typedef struct {
 	flash_ip_t 		ip;
 	u32 addr;
 } flash_version_t;
+
+typedef struct {
+	u32 magic;
+	u16 buf_speed;
+	u16 reserved;
+} flash_params_t;
 /*
  * Function prototypes.
  */
@@ -139,14 +171,34 @@ int flash_readByte(u32 Addr, u8 *val);
 int flash_readWord(u32 Addr, u16 *val);
 int flash_readQWord(u32 Addr, u32 *val);
 int flash_readPage(u32 Addr);
+int flash_readBuffer(u32 Addr, u8 *data, u32 ByteCount);
+int flash_benchRead(u32 Addr, u32 ByteCount);
 int flash_write(u32 Addr, u32 ByteCount, u8 *data);
 
 int flash_readBoardInfo(flash_version_t *info);
 int flash_printBoardInfo(flash_version_t *info);
 uint32_t flash_getIp(flash_version_t *info);
 
+int flash_readParams(flash_params_t *params);
+int flash_writeParams(flash_params_t *params);
+
 int flash_eraseSubSector(u32 Addr);
 
+/*
+ * Bulk programming. All of them use the 4-byte address commands, so the
+ * address mode does not matter.
+ * -> flash_eraseSize: biggest block (sector or subsector) that can be erased
+ *    at Addr without going past End. Addr must be subsector aligned.
+ * -> flash_eraseBlock: erases the sector or subsector at Addr.
+ * -> flash_programBuffer: programs ByteCount bytes in page bursts, splitting
+ *    at page boundaries. The range must be erased.
+ * -> flash_crc: CRC-32 (as io_crc32) of a range, read with flash_readBuffer.
+ */
+u32 flash_eraseSize(u32 Addr, u32 End);
+int flash_eraseBlock(u32 Addr, u32 Size);
+int flash_programBuffer(u32 Addr, const u8 *data, u32 ByteCount);
+int flash_crc(u32 Addr, u32 ByteCount, u32 *crc);
+
 int flash_readID(void);
 int flash_getStatus(void);
 int flash_getFlagStatus(void);
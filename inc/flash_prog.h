@@ -0,0 +1,68 @@
+/*
+ * flash_prog.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Bulk flash programming from a data stream.
+ *
+ *      "flash_prog <addr> <length> <crc>" erases the whole range, 64 kB
+ *      sectors where the range covers a whole one and 4 kB subsectors
+ *      otherwise, and then opens a session and answers
+ *      "### Flash: ... ready for data". The erase blocks the main loop (up to
+ *      a few hundred ms per sector), so the data must not be sent before the
+ *      ready line: uart input beyond the rx ring would be lost.
+ *
+ *      From then on all input, uart or ethernet, goes to the session instead
+ *      of the command interpreter: the data as hex digits, anything else
+ *      (spaces, new lines) is ignored. The session closes by itself after
+ *      length bytes, or is cancelled with ESC/CAN or after
+ *      FLASH_PROG_TIMEOUT_MS without data.
+ *
+ *      Data is programmed in page bursts as it arrives, a page program is
+ *      short enough for the rx ring to hold the input meanwhile. At the end the range is read back and its CRC-32
+ *      (same as io_crc32, i.e. zlib crc32) compared against crc, and the
+ *      throughput is reported.
+ *
+ *      addr must be subsector aligned, and the last subsector is erased
+ *      completely. The profiles, params and board info at the top of the
+ *      flash can not be written.
+ */
+
+#ifndef FLASH_PROG_H_
+#define FLASH_PROG_H_
+
+#include <stdint.h>
+#include <xspi.h>
+#include "flash.h"
+
+#define FLASH_PROG_TIMEOUT_MS		10000
+#define FLASH_PROG_END_ADDR			FLASH_PROFILE_ADDR
+
+typedef struct {
+	uint8_t active;
+	uint32_t addr;
+	uint32_t length;
+	uint32_t crc;
+	uint32_t received;
+	uint32_t rx_crc;
+	uint32_t nerase;
+	int nibble;
+	uint32_t t0;
+	uint32_t last_rx;
+	uint8_t page[PAGE_SIZE];
+	uint32_t page_fill;
+} flash_prog_t;
+
+// Erases the range and opens a session. Returns -1 if the range is not
+// valid, -2 if an erase failed.
+int flash_prog_start(uint32_t addr, uint32_t length, uint32_t crc);
+int flash_prog_active(void);
+
+// Input while a session is open.
+void flash_prog_feed(const uint8_t *buf, unsigned int n);
+
+// Called from the main loop, cancels a stalled session.
+void flash_prog_poll(void);
+
+#endif /* FLASH_PROG_H_ */
@@ -10,6 +10,7 @@
 
 #include <xil_io.h>
 #include <stdint.h>
+#include "regmap.h"
 
 #define FR_MEAS_FCLK_REG			0
 #define FR_MEAS_FCLK_REG_OFFSET		0
@@ -26,19 +27,58 @@
 #define FR_MEAS_FMEAS_MAX			0xFFFFFFFF
 #define FR_MEAS_FMEAS_DEFAULT		0
 
+// Register list, see regmap.h. The measured frequency is read only.
+#define FR_MEAS_REGS(X) \
+	X(fclk, 	FCLK, 	"frFclk", 	FR_MEAS_FCLK_DEFAULT, 	FR_MEAS_FCLK_MIN, 	FR_MEAS_FCLK_MAX, 	REGMAP_RW) \
+	X(fmeas, 	FMEAS, 	"frFmeas", 	FR_MEAS_FMEAS_DEFAULT, 	FR_MEAS_FMEAS_MIN, 	FR_MEAS_FMEAS_MAX, 	REGMAP_RO)
+
+typedef regmap_reg_t fr_meas_status_t;
+
+typedef struct {
+	FR_MEAS_REGS(REGMAP_FIELD)
+} fr_meas_t;
+
+// Background frequency monitor (see fr_mon.h).
+#define FR_MON_OFF					0
+#define FR_MON_ON					1
+#define FR_MON_PERIOD_MIN			10		// ms between samples.
+#define FR_MON_PERIOD_MAX			60000
+#define FR_MON_PERIOD_DEFAULT		1000
+#define FR_MON_TOL_DEFAULT			1		// kHz.
+#define FR_MON_HIST_LENGTH			64
+
 typedef struct {
 	uint32_t value;
 	uint32_t min;
 	uint32_t max;
-	uint32_t reg_offset;
-	uint32_t reg_mask;
-	char name[15];
-} fr_meas_status_t;
+	const char *name;
+} fr_mon_var_t;
 
 typedef struct {
-	fr_meas_status_t fclk;
-	fr_meas_status_t fmeas;
-} fr_meas_t;
+	fr_mon_var_t enable;
+	fr_mon_var_t period;
+	fr_mon_var_t ref;
+	fr_mon_var_t tol;
+	fr_mon_var_t alarm;
+	fr_mon_var_t nalarm;
+} fr_mon_group_status_t;
+
+typedef struct {
+	uint32_t tstamp;		// tget_ms() of the sample.
+	uint32_t khz;
+} fr_mon_sample_t;
+
+typedef struct {
+	fr_mon_group_status_t vars;
+	uint32_t last_tick;
+	uint32_t ref;			// Reference in use: frMonRef, or the first sample.
+	uint32_t nsamp;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum;
+	uint8_t hist_idx;		// Next position to write in hist.
+	fr_mon_sample_t hist[FR_MON_HIST_LENGTH];
+} fr_mon_t;
 
 // Register read and write functions.
 #define FR_MEAS_mWriteReg(BaseAddress, RegOffset, Data) \
@@ -50,6 +90,7 @@ typedef struct {
 void fr_meas_init(fr_meas_t *fr_meas);
 int fr_meas_change_status(fr_meas_status_t *reg, uint32_t value);
 int fr_meas_update_reg(fr_meas_status_t *reg);
+const char *fr_meas_reg_name(const fr_meas_status_t *reg);
 
 
 #endif /* INC_FR_MEAS_H_ */
@@ -0,0 +1,53 @@
+/*
+ * fr_mon.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Background monitor of the clock measured by fr_meas.
+ *
+ *      With frMon 1, frFmeas is sampled every frMonPer ms from the main loop
+ *      into a history of the last FR_MON_HIST_LENGTH samples, with min, max
+ *      and mean since the monitor was enabled. Every sample is checked against
+ *      frMonRef (kHz, 0 takes the first sample as reference): when it is more
+ *      than frMonTol kHz away frMonAlarm is set, frMonAlarms counted and
+ *      "### Clock drift" printed once, until the clock is back in range.
+ *
+ *      "get frmon" prints the statistics and the history. "get frhist" sends
+ *      them in binary (all values little endian):
+ *
+ *      Header (32 bytes):
+ *      || magic (4) | version (2) | nsamp (2) | tick (4) | ref (4) |
+ *      || min (4) | max (4) | mean (4) | crc32 (4) ||
+ *
+ *      magic : "LTAM".
+ *      nsamp : number of history entries that follow.
+ *      tick  : tget_ms() when the reply was built.
+ *      crc32 : CRC-32 (IEEE) of the entries.
+ *
+ *      Followed by nsamp entries, oldest first:
+ *      || tstamp (4) | khz (4) ||
+ */
+
+#ifndef FR_MON_H_
+#define FR_MON_H_
+
+#include "defines.h"
+
+#define FR_MON_MAGIC				0x4D41544C	// "LTAM".
+#define FR_MON_VERSION				1
+#define FR_MON_HEADER_LENGTH		32
+#define FR_MON_ENTRY_LENGTH			8
+
+void fr_mon_init(fr_mon_t *mon);
+int fr_mon_change_status(fr_mon_t *mon, fr_mon_var_t *var, uint32_t value);
+
+/*
+ * Takes a sample when due. Returns 1 if a sample was taken.
+ */
+int fr_mon_poll(fr_mon_t *mon, fr_meas_t *fr_meas);
+
+void fr_mon_print(fr_mon_t *mon);
+void fr_mon_send(fr_mon_t *mon);
+
+#endif /* FR_MON_H_ */
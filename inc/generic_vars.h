@@ -25,7 +25,7 @@ typedef struct {
 	float value;
 	float min;
 	float max;
-	char name[10];
+	const char *name;
 } generic_var_t;
 
 typedef struct {
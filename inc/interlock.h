@@ -0,0 +1,53 @@
+/*
+ * interlock.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Telemetry interlocks.
+ *
+ *      Each rule watches one telemetry source against [min, max]. Rules are
+ *      evaluated when the background scanner (telemetry.h) puts a new value of
+ *      their source in the cache, which costs a couple of float compares and
+ *      fits in any scan period. A rule tied to a bias switch is only active
+ *      while the switch is on, so rails that are off do not trip.
+ *
+ *      After INTERLOCK_DEBOUNCE consecutive values out of range the rule trips
+ *      and latches until "set ilkReset 1":
+ *      -> INTERLOCK_ACTION_LOG    : message only.
+ *      -> INTERLOCK_ACTION_SW_OFF : the bias switch is opened.
+ *      -> INTERLOCK_ACTION_RAMP   : the bias is moved ramp_step volts towards
+ *                                   ramp_to on every new value, then the switch
+ *                                   is opened.
+ *
+ *      Worst case latency from a fault to the action is
+ *      INTERLOCK_DEBOUNCE * TELEMETRY_NSOURCES * telScanPer ms, about 1 s with
+ *      the defaults. Interlocks are off at boot (ilkEnable 0) because limits
+ *      depend on the CCD in use: check them with "get interlock" and adjust
+ *      with "set ilkmin/ilkmax <source> <value>".
+ */
+
+#ifndef INTERLOCK_H_
+#define INTERLOCK_H_
+
+#include "defines.h"
+
+void interlock_init(system_state_t *sys);
+int interlock_change_status(system_state_t *sys, telemetry_var_t *var, uint16_t value);
+
+/*
+ * Evaluates the rules of the source last read by the scanner. Call after
+ * telemetry_scan_poll returns 1.
+ */
+void interlock_check(system_state_t *sys);
+
+// Prints the rule table.
+void interlock_print(system_state_t *sys);
+
+/*
+ * Changes a rule, found by source name. field is "ilkmin", "ilkmax" or
+ * "ilkrule" (enable).
+ */
+int interlock_set_rule(system_state_t *sys, const char *field, const char *source, float value);
+
+#endif /* INTERLOCK_H_ */
@@ -13,6 +13,7 @@
 #define XINTC_INT_SRC_TIMER 0
 
 int intc_init(u16 device_id);
+int intc_connect(u8 id, XInterruptHandler handler, void *ref);
 void intc_enable(u8 id);
 void intc_disable(u8 id);
 
@@ -23,4 +24,8 @@ void timer_isr(void);
 void tdelay_ms(uint32_t t);
 void tdelay_s(uint32_t t);
 
+// Milliseconds since intc_init. Wraps after ~49 days, so always compare
+// differences: (tget_ms() - t0) >= t.
+uint32_t tget_ms(void);
+
 #endif /* SRC_INTERRUPT_H_ */
@@ -25,7 +25,26 @@ void io_uint2str(uint32_t n, char *str);
 void io_uint2hex(uint32_t n, char *str);
 void io_float2str(float n, char *str);
 void io_padd(uint8_t n, char *str, char ch);
+uint32_t io_crc32(uint32_t crc, const uint8_t *data, uint32_t length);
+
+// Little endian fields of the binary replies.
+void io_put_u16(uint8_t *p, uint16_t val);
+void io_put_u32(uint8_t *p, uint32_t val);
+uint16_t io_get_u16(const uint8_t *p);
+uint32_t io_get_u32(const uint8_t *p);
 
 void mprint(const char *str);
 
+// Binary data to the current output: raw over ethernet, hex lines between
+// "### <title> N bytes" and "### End" over uart.
+void io_put_bin(const char *title, const uint8_t *data, uint32_t length);
+
+// Same, for data the host did not ask for: over ethernet it goes out in the
+// background from io_put_bin_poll, data must stay valid until then. -1 if the
+// previous one is still pending.
+int io_put_bin_async(const char *title, const uint8_t *data, uint32_t length);
+
+// 1 while an io_put_bin_async is pending, -1 once if the host did not take it.
+int io_put_bin_poll(void);
+
 #endif /* SRC_IO_FUNC_H_ */
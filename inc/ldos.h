@@ -125,7 +125,7 @@ typedef struct {
 	float r2p;
 	uint16_t bits;
 	float rm;
-	char name[10];
+	const char *name;
 } bias_status_t;
 
 typedef struct {
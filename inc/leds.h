@@ -23,7 +23,7 @@ typedef struct {
 	uint8_t min;
 	uint8_t max;
 	uint8_t bit_position;
-	char name[10];
+	const char *name;
 } led_status_t;
 
 typedef struct {
@@ -9,6 +9,7 @@
 #define INC_MASTER_SEL_H_
 
 #include <xil_io.h>
+#include "regmap.h"
 
 // Registers.
 #define MASTER_SEL_MST_SEL_REG 				0
@@ -18,17 +19,14 @@
 #define MASTER_SEL_IS_SLAVE		1
 #define MASTER_SEL_IS_MASTER 	0
 
-typedef struct {
-	uint16_t value;
-	uint16_t min;
-	uint16_t max;
-	uint32_t reg_offset;
-	uint32_t reg_mask;
-	char name[15];
-} master_sel_status_t;
+// Register list, see regmap.h. Set by the board, read only.
+#define MASTER_SEL_REGS(X) \
+	X(sel, 	MST_SEL, 	"isSlave", 	0, 	MASTER_SEL_IS_SLAVE, 	MASTER_SEL_IS_MASTER, 	REGMAP_RO)
+
+typedef regmap_reg_t master_sel_status_t;
 
 typedef struct {
-	master_sel_status_t sel;
+	MASTER_SEL_REGS(REGMAP_FIELD)
 } master_sel_t;
 
 // Register read and write functions.
@@ -41,5 +39,6 @@ typedef struct {
 
 void master_sel_init(master_sel_t *master_sel);
 int master_sel_update_reg(master_sel_status_t *reg);
+const char *master_sel_reg_name(const master_sel_status_t *reg);
 
 #endif /* INC_MASTER_SEL_H_ */
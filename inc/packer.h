@@ -114,6 +114,7 @@
 #define PACKER_H_
 
 #include <stdint.h>
+#include "regmap.h"
 
 #define PACKER_SOURCE_REG_OFFSET	0
 #define PACKER_START_REG_OFFSET		4
@@ -142,18 +143,20 @@
 #define PACKER_START_ON			1
 #define PACKER_START_OFF		0
 
-typedef struct {
-	uint8_t status;
-	uint8_t min;
-	uint8_t max;
-	uint32_t reg_offset;
-	uint32_t reg_mask;
-	char name[12];
-}packer_sw_status_t;
+/*
+ * Register list, see regmap.h. Reset state:
+ *
+ * SOURCE_REG	= 9	=> CDS_SEQ.
+ * START_REG	= 0 => Packer stopped.
+ */
+#define PACKER_REGS(X) \
+	X(source, 	SOURCE, 	"packSource", 	PACKER_TRSRC_CDS_SEQ, 	PACKER_TRSRC_RAW_CHA, 	PACKER_TRSRC_CDS_SEQ, 	REGMAP_RW) \
+	X(start, 	START, 		"packStart", 	PACKER_START_OFF, 		PACKER_START_OFF, 		PACKER_START_ON, 		REGMAP_RW)
+
+typedef regmap_reg_t packer_sw_status_t;
 
 typedef struct {
-	packer_sw_status_t source;
-	packer_sw_status_t start;
+	PACKER_REGS(REGMAP_FIELD)
 }packer_sw_group_status_t;
 
 /**************************** Type Definitions *****************************/
@@ -199,5 +202,6 @@ typedef struct {
 
 void packer_init(packer_sw_group_status_t *packer_sw);
 int packer_change_sw_status(packer_sw_status_t *packer_sw_status, uint8_t value);
+const char *packer_reg_name(const packer_sw_status_t *packer_sw_status);
 
 #endif // PACKER_H_
@@ -0,0 +1,95 @@
+/*
+ * perf.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Latency of the commands typed by the user, per command type.
+ *
+ *      Every command is timestamped in three stages:
+ *
+ *      parse  : excecute_interpret splitting the line in words.
+ *      exec   : lookup and action, SPI traffic included, up to the return of
+ *               excecute_interpret.
+ *      output : "Done" and the error text, printed by the main loop.
+ *
+ *      The type of a command is its first word (set, get, exec, run...).
+ *      Failed commands of a type not seen yet go to "other", so typos do not
+ *      take entries, as well as any new type once PERF_NTYPES are in use.
+ *      Lines stored by a script being recorded and lines run by a script are
+ *      not counted.
+ *
+ *      Per type, the total time goes into a histogram of PERF_NBUCKETS log2
+ *      buckets: bucket 0 holds 0 us and bucket k from 2^(k-1) to 2^k - 1 us,
+ *      the last one everything above. p50 and p99 are the upper bound of the
+ *      bucket they fall in, so they are at most 2x pessimistic. Count, min,
+ *      max and the mean of every stage are exact.
+ *
+ *      Times are in us. If the hardware has an AXI timer (XPAR_TMRCTR_0) it is
+ *      run free and read directly, otherwise the 1 ms interrupt tick is used
+ *      and commands shorter than that read as 0.
+ *
+ *      "get perf" prints the table, "reset perf" clears it. The same table
+ *      is in the snapshot (SNAPSHOT_SECTION_PERF).
+ */
+
+#ifndef PERF_H_
+#define PERF_H_
+
+#include "defines.h"
+
+#define PERF_NTYPES					12
+#define PERF_NAME_LENGTH			12
+#define PERF_NBUCKETS				24
+
+// Values per type in the snapshot: name (3), count, min, p50, p99, max and
+// mean parse, exec and output.
+#define PERF_SNAPSHOT_VALUES		11
+
+typedef struct {
+	char name[PERF_NAME_LENGTH];
+	uint32_t count;
+	uint32_t min;
+	uint32_t max;
+	uint64_t sum_parse;
+	uint64_t sum_exec;
+	uint64_t sum_output;
+	uint32_t hist[PERF_NBUCKETS];
+} perf_type_t;
+
+typedef struct {
+	uint32_t count;
+	uint32_t min;
+	uint32_t p50;
+	uint32_t p99;
+	uint32_t max;
+	uint32_t parse;
+	uint32_t exec;
+	uint32_t output;
+} perf_stats_t;
+
+// Starts the hardware timer, if any, and clears the table.
+void perf_init(void);
+void perf_reset(void);
+
+// Stage marks, in command order. perf_end records the command.
+void perf_start(void);
+void perf_parsed(const char *type);
+void perf_executed(void);
+void perf_end(int status);
+
+// Types in use, and their statistics (-1 if i is out of range).
+int perf_ntypes(void);
+int perf_get(int i, char *name, perf_stats_t *stats);
+
+// Raw timer ticks, and ticks between t0 and t1 in us. Good for intervals
+// shorter than one turn of the timer (~42 s at 100 MHz).
+uint32_t perf_ticks(void);
+uint32_t perf_us(uint32_t t0, uint32_t t1);
+
+// Timer resolution, us.
+uint32_t perf_resolution(void);
+
+void perf_print(void);
+
+#endif /* PERF_H_ */
@@ -0,0 +1,60 @@
+/*
+ * profile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Named configuration profiles in flash.
+ *
+ *      A profile is a snapshot blob (see snapshot.h) stored in one of the
+ *      FLASH_PROFILE_NSLOTS subsectors at FLASH_PROFILE_ADDR, behind a header
+ *      (all values little endian):
+ *
+ *      || magic (4) | version (2) | reserved (2) | name (16) | length (4) | crc32 (4) ||
+ *
+ *      magic  : "LTAF".
+ *      name   : zero padded, at most PROFILE_NAME_LENGTH - 1 characters.
+ *      length : length of the blob that follows.
+ *      crc32  : CRC-32 (IEEE) of the blob.
+ *
+ *      Erased slots (or slots with a bad magic) are free. Saving a profile
+ *      with an existing name overwrites its slot.
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include "defines.h"
+
+#define PROFILE_MAGIC				0x4641544C	// "LTAF".
+#define PROFILE_VERSION				1
+#define PROFILE_HEADER_LENGTH		32
+#define PROFILE_NAME_LENGTH			16
+
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	char name[PROFILE_NAME_LENGTH];
+	uint32_t length;
+	uint32_t crc;
+} profile_header_t;
+
+/*
+ * Snapshot of the current state into the slot with that name, or the first
+ * free one. Returns -1 if the name is too long, there is no free slot or the
+ * slot could not be written and verified.
+ */
+int profile_save(system_state_t *sys, const char *name);
+
+/*
+ * Reads, checks and applies (snapshot_apply) a profile. Returns -1 if there is
+ * no such profile, the CRC does not match or a value was refused.
+ */
+int profile_load(system_state_t *sys, const char *name);
+
+int profile_delete(const char *name);
+
+// Prints slot, name, size and version of every stored profile.
+void profile_list(void);
+
+#endif /* PROFILE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * regmap.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Generic driver for the AXI-lite register banks of the IPs (smart
+ *      buffer, sync gen, frequency meter, master select, packer).
+ *
+ *      Each IP lists its registers once in its header, as an X-macro:
+ *
+ *      X(field, reg, name, value, min, max, flags)
+ *
+ *      field : member of the IP struct (built with REGMAP_FIELD).
+ *      reg   : register, the offset and mask are <IP>_<reg>_REG_OFFSET and
+ *              <IP>_<reg>_REG_MASK.
+ *      name  : variable name for set/get.
+ *      value : reset value, written at init.
+ *      flags : REGMAP_RO for status registers, read from hardware and never
+ *              written. REGMAP_RW otherwise.
+ *
+ *      The driver expands the same list into a const table of regmap_desc_t.
+ *      Only the values live in the IP struct, names, ranges and offsets stay
+ *      in the table. regmap_init loads the reset values and writes every
+ *      register in one loop, regmap_set and regmap_update do the bounds
+ *      checked write and the read back of a single one.
+ */
+
+#ifndef REGMAP_H_
+#define REGMAP_H_
+
+#include <stdint.h>
+
+#define REGMAP_RW					0
+#define REGMAP_RO					1
+
+// Register, as seen by set/get and the snapshot. The rest is in the desc.
+typedef struct {
+	uint32_t value;
+} regmap_reg_t;
+
+typedef struct {
+	const char *name;
+	uint32_t reg_offset;
+	uint32_t reg_mask;
+	uint32_t value;
+	uint32_t min;
+	uint32_t max;
+	uint32_t flags;
+} regmap_desc_t;
+
+typedef struct {
+	uint32_t base_addr;
+	const regmap_desc_t *desc;
+	int nregs;
+	regmap_reg_t *regs;			// Set by regmap_init.
+} regmap_t;
+
+// Member of the IP struct for one entry of the register list.
+#define REGMAP_FIELD(field, reg, name, value, min, max, flags)		regmap_reg_t field;
+
+#define REGMAP_NREGS(desc)			((int) (sizeof(desc)/sizeof(regmap_desc_t)))
+
+// Fills regs (nregs of them, in desc order) and writes them all to hardware.
+void regmap_init(regmap_t *map, regmap_reg_t *regs);
+
+// Writes every register again, status ones are read instead.
+void regmap_write_all(const regmap_t *map);
+
+// -1 if reg is not in map, is read only or value is out of range.
+int regmap_set(const regmap_t *map, regmap_reg_t *reg, uint32_t value);
+
+// Reads reg back from hardware.
+int regmap_update(const regmap_t *map, regmap_reg_t *reg);
+
+// Variable name of reg, NULL if reg is not in map.
+const char *regmap_name(const regmap_t *map, const regmap_reg_t *reg);
+
+#endif /* REGMAP_H_ */
@@ -0,0 +1,97 @@
+/*
+ * script.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Command scripts stored in RAM and run from the main loop, one step per
+ *      pass, so the board keeps answering commands while a script runs.
+ *
+ *      "script <name>" starts recording: every following line is stored
+ *      instead of executed, until "end". Besides any regular command, a line
+ *      can be:
+ *
+ *      loop <n>            : repeats the lines up to the matching endloop n
+ *                            times. Loops nest up to SCRIPT_MAX_DEPTH deep.
+ *      endloop
+ *      wait <ms>           : waits that many milliseconds.
+ *      wait eos [timeout]  : waits for the sequencer end of sequence.
+ *      wait eot [timeout]  : waits for the end of a smart buffer transfer.
+ *
+ *      Before a command is executed, $i is replaced by the index of the
+ *      innermost loop (from 0) and $1, $2 by the arguments given to run.
+ *      Events are only counted if they arrive after the previous command, and
+ *      the script stops at the first command that fails or wait that times out.
+ */
+
+#ifndef SCRIPT_H_
+#define SCRIPT_H_
+
+#include "defines.h"
+
+#define SCRIPT_NSCRIPTS				4
+#define SCRIPT_MAX_LINES			32
+#define SCRIPT_LINE_LENGTH			64
+#define SCRIPT_NAME_LENGTH			16
+#define SCRIPT_MAX_DEPTH			4
+#define SCRIPT_NARGS				2
+
+#define SCRIPT_EVENT_EOS			0x1
+#define SCRIPT_EVENT_EOT			0x2
+
+typedef struct {
+	char name[SCRIPT_NAME_LENGTH];
+	uint32_t nlines;
+	char lines[SCRIPT_MAX_LINES][SCRIPT_LINE_LENGTH];
+} script_t;
+
+typedef struct {
+	uint32_t start;
+	uint32_t count;
+	uint32_t index;
+} script_loop_t;
+
+typedef struct {
+	script_t scripts[SCRIPT_NSCRIPTS];
+
+	// Recording, stored on "end".
+	uint8_t recording;
+	script_t pending;
+	int rec_depth;
+
+	// Running.
+	script_t *run;
+	uint32_t pc;
+	script_loop_t loops[SCRIPT_MAX_DEPTH];
+	int depth;
+	char args[SCRIPT_NARGS][USERWORDLENTHG];
+	uint32_t events;
+	uint8_t waiting;
+	uint32_t wait_events;
+	uint32_t wait_t0;
+	uint32_t wait_ms;
+	uint32_t t0;
+} script_state_t;
+
+// Starts recording into a new script, or over the one with that name.
+int script_record_start(const char *name);
+int script_recording(void);
+
+// Line typed while recording. "end" stores the script.
+int script_record_line(const char *line, char *errStr);
+
+int script_delete(const char *name);
+void script_list(void);
+
+// Starts a script; args can be NULL.
+int script_run(const char *name, const char *arg1, const char *arg2);
+void script_stop(void);
+int script_running(void);
+
+// Events from the main loop.
+void script_event(uint32_t event);
+
+// Called from the main loop: executes at most one line.
+void script_poll(system_state_t *sys);
+
+#endif /* SCRIPT_H_ */
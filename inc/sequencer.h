@@ -31,7 +31,7 @@ typedef struct {
 	uint8_t max;
 	uint32_t reg_offset;
 	uint32_t reg_mask;
-	char name[10];
+	const char *name;
 }seq_sw_status_t;
 
 typedef struct {
@@ -42,7 +42,7 @@ typedef struct {
 typedef struct {
 	uint32_t program[SEQUENCER_MEMORY_SIZE];
 	uint32_t size;
-	char name[50];
+	const char *name;
 }sequencer_t;
 
 typedef struct {
@@ -50,6 +50,55 @@ typedef struct {
 	sequencer_t sequencer;
 }seq_t;
 
+// Acquisition runs (see acq.h).
+#define ACQ_STOP						0
+#define ACQ_START						1
+#define ACQ_FRAMES_MAX					100000
+#define ACQ_EXPO_MAX					86400000	// ms.
+
+#define ACQ_CLEAN_ERASE					0x1			// ccd_erase.
+#define ACQ_CLEAN_EPURGE				0x2			// cdd_epurge.
+#define ACQ_CLEAN_EVERY					0x4			// Before every frame, not only the first.
+#define ACQ_CLEAN_MAX					0x7
+
+#define ACQ_STATE_IDLE					0
+#define ACQ_STATE_CLEAN					1
+#define ACQ_STATE_EXPOSE				2
+#define ACQ_STATE_READOUT				3
+
+typedef struct {
+	uint32_t value;
+	uint32_t min;
+	uint32_t max;
+	const char *name;
+} acq_var_t;
+
+typedef struct {
+	acq_var_t start;
+	acq_var_t frames;
+	acq_var_t expo;
+	acq_var_t clean;
+	acq_var_t frame;
+} acq_group_status_t;
+
+typedef struct {
+	uint32_t min;
+	uint32_t max;
+	uint32_t sum;
+} acq_stat_t;
+
+typedef struct {
+	acq_group_status_t vars;
+	uint8_t state;
+	uint32_t t0;			// Start of the run.
+	uint32_t t_expo;		// Start of the exposure of the current frame.
+	uint32_t t_readout;		// Start of the readout of the current frame.
+	uint32_t t_end;			// End of the readout of the previous frame.
+	acq_stat_t expo;
+	acq_stat_t readout;
+	acq_stat_t dead;
+} acq_t;
+
 
 
 /**************************** Type Definitions *****************************/
@@ -118,11 +118,61 @@
  * 	-> 0 : Not in reset state.
  *	-> 1 : Reset block.
  *
+ * *****************
+ * *** Streaming ***
+ * *****************
+ * The block has a single capture/transfer engine over the whole memory, so a capture
+ * cannot be overlapped with the transfer of the previous one. To stream raw traces
+ * without host intervention, the firmware can re-arm the buffer itself: when the
+ * transfer of a block ends, capture and transfer are started again right away from
+ * the main loop. The gap between blocks is the transfer time plus one main loop
+ * iteration. Streaming requires single capture mode, as a continuous capture never
+ * ends on its own.
+ *
+ * bufStream 		: 0 stops the stream after the current block, 1 starts it.
+ * bufStrmBlocks 	: number of blocks to stream. 0 streams until stopped.
+ * bufStrmCount 	: number of blocks transferred. Can only be set to 0.
+ *
+ * *************************
+ * *** Triggered capture ***
+ * *************************
+ * Pre-trigger capture is built on top of continuous mode, where the buffer keeps
+ * writing samples until CAPTURE_START_REG goes back to 0. Arming the trigger starts
+ * a continuous capture. When the trigger event arrives, capture goes on for the
+ * post-trigger time and then it is stopped and the transfer started. Trigger
+ * sources are a software command or the end of the sequence. Timing is measured
+ * with the 1 ms tick, so the host gets the trigger position with ms resolution:
+ * the trigger sample is bufTrigPostAct ms worth of samples before the end of the
+ * captured data.
+ *
+ * bufTrigArm 		: 1 arms the trigger (starts capture), 0 disarms it.
+ * bufTrigSrc 		: 0 software, 1 end of sequence.
+ * bufTrigPost 		: post-trigger time in ms.
+ * bufTrig 			: software trigger. Write 1 while armed.
+ * bufTrigState 	: 0 idle, 1 armed, 2 triggered, 3 done (read only).
+ * bufTrigPre 		: ms captured before the trigger (read only).
+ * bufTrigPostAct 	: ms captured after the trigger (read only).
+ *
+ * *************************
+ * *** Speed calibration ***
+ * *************************
+ * Finds the smallest SPEED_CTRL_REG value the host link can take without losing
+ * packets (see smart_buffer_cal.h). Only the host can tell if data was lost, so
+ * each step waits for its verdict.
+ *
+ * bufCalStart 	: 1 starts the calibration, 0 aborts it.
+ * bufCalRes 		: host verdict for the last transfer. 1 no loss, 0 loss.
+ * bufCalSpeed 	: speed under test (read only).
+ * bufCalState 	: 0 idle, 1 transferring, 2 waiting verdict, 3 done, 4 failed
+ * 				  (read only).
+ *
  */
 
 #ifndef SRC_SMART_BUFFER_H_
 #define SRC_SMART_BUFFER_H_
 
+#include "regmap.h"
+
 // Registers.
 #define SMART_BUFFER_CHA_SEL_REG 				0
 #define SMART_BUFFER_CHA_SEL_REG_OFFSET 		0
@@ -248,38 +298,122 @@
 #define SMART_BUFFER_RESET_OFF					0
 #define SMART_BUFFER_RESET_ON					1
 
+// Register list, see regmap.h. Capture and transfer end are status flags.
+#define SMART_BUFFER_REGS(X) \
+	X(cha_sel, 			CHA_SEL, 			"bufASel", 		SMART_BUFFER_CHX_SEL_CHA, 				SMART_BUFFER_CHX_SEL_CHA, 				SMART_BUFFER_CHX_SEL_CHD, 				REGMAP_RW) \
+	X(chb_sel, 			CHB_SEL, 			"bufBSel", 		SMART_BUFFER_CHX_SEL_CHB, 				SMART_BUFFER_CHX_SEL_CHA, 				SMART_BUFFER_CHX_SEL_CHD, 				REGMAP_RW) \
+	X(chc_sel, 			CHC_SEL, 			"bufCSel", 		SMART_BUFFER_CHX_SEL_CHC, 				SMART_BUFFER_CHX_SEL_CHA, 				SMART_BUFFER_CHX_SEL_CHD, 				REGMAP_RW) \
+	X(chd_sel, 			CHD_SEL, 			"bufDSel", 		SMART_BUFFER_CHX_SEL_CHD, 				SMART_BUFFER_CHX_SEL_CHA, 				SMART_BUFFER_CHX_SEL_CHD, 				REGMAP_RW) \
+	X(cha_nsamp, 		CHA_NSAMP, 			"bufASamp", 	SMART_BUFFER_NSAMP_MAX, 				SMART_BUFFER_NSAMP_MIN, 				SMART_BUFFER_NSAMP_MAX, 				REGMAP_RW) \
+	X(chb_nsamp, 		CHB_NSAMP, 			"bufBSamp", 	SMART_BUFFER_NSAMP_MAX, 				SMART_BUFFER_NSAMP_MIN, 				SMART_BUFFER_NSAMP_MAX, 				REGMAP_RW) \
+	X(chc_nsamp, 		CHC_NSAMP, 			"bufCSamp", 	SMART_BUFFER_NSAMP_MAX, 				SMART_BUFFER_NSAMP_MIN, 				SMART_BUFFER_NSAMP_MAX, 				REGMAP_RW) \
+	X(chd_nsamp, 		CHD_NSAMP, 			"bufDSamp", 	SMART_BUFFER_NSAMP_MAX, 				SMART_BUFFER_NSAMP_MIN, 				SMART_BUFFER_NSAMP_MAX, 				REGMAP_RW) \
+	X(ch_mode, 			CH_MODE, 			"bufChMode", 	SMART_BUFFER_CH_MODE_SINGLE, 			SMART_BUFFER_CH_MODE_SINGLE, 			SMART_BUFFER_CH_MODE_QUAD, 				REGMAP_RW) \
+	X(dataa_mode, 		DATAA_MODE, 		"bufAMode", 	SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_NSAMP, 			REGMAP_RW) \
+	X(datab_mode, 		DATAB_MODE, 		"bufBMode", 	SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_NSAMP, 			REGMAP_RW) \
+	X(datac_mode, 		DATAC_MODE, 		"bufCMode", 	SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_NSAMP, 			REGMAP_RW) \
+	X(datad_mode, 		DATAD_MODE, 		"bufDMode", 	SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_FULL, 			SMART_BUFFER_DATAX_MODE_NSAMP, 			REGMAP_RW) \
+	X(capture_mode, 	CAPTURE_MODE, 		"bufCapMode", 	SMART_BUFFER_CAPTURE_MODE_SINGLE, 		SMART_BUFFER_CAPTURE_MODE_SINGLE, 		SMART_BUFFER_CAPTURE_MODE_CONTINUOUS, 	REGMAP_RW) \
+	X(capture_en_src, 	CAPTURE_EN_SRC, 	"bufCapSrc", 	SMART_BUFFER_CAPTURE_EN_SRC_INTERNAL, 	SMART_BUFFER_CAPTURE_EN_SRC_EXTERNAL, 	SMART_BUFFER_CAPTURE_EN_SRC_INTERNAL, 	REGMAP_RW) \
+	X(capture_start, 	CAPTURE_START, 		"bufCapStart", 	SMART_BUFFER_CAPTURE_STOP, 				SMART_BUFFER_CAPTURE_STOP, 				SMART_BUFFER_CAPTURE_START, 			REGMAP_RW) \
+	X(capture_end, 		CAPTURE_END, 		"bufCapEnd", 	0, 										SMART_BUFFER_CAPTURE_RUNNING, 			SMART_BUFFER_CAPTURE_FINISHED, 			REGMAP_RO) \
+	X(speed_ctrl, 		SPEED_CTRL, 		"bufSpeed", 	1000, 									SMART_BUFFER_SPEED_CTRL_MIN, 			SMART_BUFFER_SPEED_CTRL_MAX, 			REGMAP_RW) \
+	X(transfer_start, 	TRANSFER_START, 	"bufTraStart", 	SMART_BUFFER_TRNASFER_STOP, 			SMART_BUFFER_TRNASFER_STOP, 			SMART_BUFFER_TRANSFER_START, 			REGMAP_RW) \
+	X(transfer_end, 	TRANSFER_END, 		"bufTraEnd", 	0, 										SMART_BUFFER_TRANSFER_RUNNING, 			SMART_BUFFER_TRANSFER_FINISHED, 		REGMAP_RO) \
+	X(reset, 			RESET, 				"bufReset", 	SMART_BUFFER_RESET_OFF, 				SMART_BUFFER_RESET_OFF, 				SMART_BUFFER_RESET_ON, 					REGMAP_RW)
+
+typedef regmap_reg_t smart_buffer_status_t;
+
+typedef struct {
+	SMART_BUFFER_REGS(REGMAP_FIELD)
+} smart_buffer_group_status_t;
+
+#define SMART_BUFFER_STREAM_OFF					0
+#define SMART_BUFFER_STREAM_ON					1
+
+#define SMART_BUFFER_STREAM_BLOCKS_MIN			0
+#define SMART_BUFFER_STREAM_BLOCKS_MAX			65535
+
 typedef struct {
 	uint16_t value;
 	uint16_t min;
 	uint16_t max;
-	uint32_t reg_offset;
-	uint32_t reg_mask;
-	char name[15];
-} smart_buffer_status_t;
+	const char *name;
+} smart_buffer_var_t;
 
 typedef struct {
-	smart_buffer_status_t cha_sel;
-	smart_buffer_status_t chb_sel;
-	smart_buffer_status_t chc_sel;
-	smart_buffer_status_t chd_sel;
-	smart_buffer_status_t cha_nsamp;
-	smart_buffer_status_t chb_nsamp;
-	smart_buffer_status_t chc_nsamp;
-	smart_buffer_status_t chd_nsamp;
-	smart_buffer_status_t ch_mode;
-	smart_buffer_status_t dataa_mode;
-	smart_buffer_status_t datab_mode;
-	smart_buffer_status_t datac_mode;
-	smart_buffer_status_t datad_mode;
-	smart_buffer_status_t capture_mode;
-	smart_buffer_status_t capture_en_src;
-	smart_buffer_status_t capture_start;
-	smart_buffer_status_t capture_end;
-	smart_buffer_status_t speed_ctrl;
-	smart_buffer_status_t transfer_start;
-	smart_buffer_status_t transfer_end;
-	smart_buffer_status_t reset;
-} smart_buffer_group_status_t;
+	smart_buffer_var_t enable;
+	smart_buffer_var_t nblocks;
+	smart_buffer_var_t count;
+} smart_buffer_stream_group_status_t;
+
+typedef struct {
+	smart_buffer_stream_group_status_t vars;
+	uint8_t running;
+} smart_buffer_stream_t;
+
+#define SMART_BUFFER_TRIG_DISARM				0
+#define SMART_BUFFER_TRIG_ARM					1
+
+#define SMART_BUFFER_TRIG_SRC_SOFT				0
+#define SMART_BUFFER_TRIG_SRC_SEQ				1
+
+#define SMART_BUFFER_TRIG_STATE_IDLE			0
+#define SMART_BUFFER_TRIG_STATE_ARMED			1
+#define SMART_BUFFER_TRIG_STATE_TRIGGERED		2
+#define SMART_BUFFER_TRIG_STATE_DONE			3
+
+#define SMART_BUFFER_TRIG_TIME_MAX				65535
+
+#define SMART_BUFFER_CAL_STATE_IDLE				0
+#define SMART_BUFFER_CAL_STATE_TRANSFER			1
+#define SMART_BUFFER_CAL_STATE_WAIT				2
+#define SMART_BUFFER_CAL_STATE_DONE				3
+#define SMART_BUFFER_CAL_STATE_FAILED			4
+
+typedef struct {
+	smart_buffer_var_t arm;
+	smart_buffer_var_t src;
+	smart_buffer_var_t post;
+	smart_buffer_var_t trig;
+	smart_buffer_var_t state;
+	smart_buffer_var_t pre_act;
+	smart_buffer_var_t post_act;
+} smart_buffer_trig_group_status_t;
+
+typedef struct {
+	smart_buffer_trig_group_status_t vars;
+	uint32_t arm_tick;
+	uint32_t trig_tick;
+	uint16_t capture_mode;
+} smart_buffer_trig_t;
+
+typedef struct {
+	smart_buffer_var_t start;
+	smart_buffer_var_t result;
+	smart_buffer_var_t speed;
+	smart_buffer_var_t state;
+} smart_buffer_cal_group_status_t;
+
+typedef struct {
+	smart_buffer_cal_group_status_t vars;
+
+	// Search bounds. -1 if not known yet.
+	int32_t speed_ok;
+	int32_t speed_bad;
+
+	// Configuration saved before calibrating.
+	uint16_t cha_sel;
+	uint16_t cha_nsamp;
+	uint16_t ch_mode;
+	uint16_t dataa_mode;
+	uint16_t capture_mode;
+	uint16_t capture_en_src;
+	uint16_t speed_ctrl;
+	uint8_t pack_source;
+	uint8_t pack_start;
+	uint8_t test_pattern;
+} smart_buffer_cal_t;
 
 // Register read and write functions.
 #define SMART_BUFFER_mWriteReg(BaseAddress, RegOffset, Data) \
@@ -290,7 +424,17 @@ typedef struct {
 
 void smart_buffer_init(smart_buffer_group_status_t *smart_buffer);
 int smart_buffer_change_status(smart_buffer_status_t *reg, uint16_t value);
+const char *smart_buffer_reg_name(const smart_buffer_status_t *reg);
 int smart_buffer_eoc(smart_buffer_group_status_t *smart_buffer);
 int smart_buffer_eot(smart_buffer_group_status_t *smart_buffer);
 
+void smart_buffer_stream_init(smart_buffer_stream_t *stream);
+int smart_buffer_stream_change_status(smart_buffer_stream_t *stream, smart_buffer_var_t *var, smart_buffer_group_status_t *smart_buffer, uint16_t value);
+int smart_buffer_stream_next(smart_buffer_stream_t *stream, smart_buffer_group_status_t *smart_buffer);
+
+void smart_buffer_trig_init(smart_buffer_trig_t *trig);
+int smart_buffer_trig_change_status(smart_buffer_trig_t *trig, smart_buffer_var_t *var, smart_buffer_group_status_t *smart_buffer, uint16_t value);
+int smart_buffer_trig_event(smart_buffer_trig_t *trig, uint16_t src);
+int smart_buffer_trig_poll(smart_buffer_trig_t *trig, smart_buffer_group_status_t *smart_buffer);
+
 #endif /* SRC_SMART_BUFFER_H_ */
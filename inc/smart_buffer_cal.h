@@ -0,0 +1,42 @@
+/*
+ * smart_buffer_cal.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Transfer speed calibration for the smart buffer.
+ *
+ *      ADC channel A is set in TEST_PATTERN mode and a single capture of
+ *      SMART_BUFFER_CAL_NSAMP samples is transferred through the packer (source
+ *      RAW from Smart Buffer, one sample per packet). After each transfer the
+ *      firmware prints:
+ *
+ *      bufCal speed <speed_ctrl> packets <n>
+ *
+ *      and waits for the host to check the packet counter of the received data
+ *      (host/buf_cal_check.c) and answer with "set bufCalRes 1" (no loss) or
+ *      "set bufCalRes 0" (loss). Starting from the current bufSpeed, the speed
+ *      is halved while there are no losses (doubled while there are), and then
+ *      the fastest loss-free value is found by bisection.
+ *
+ *      The result is written to bufSpeed and stored in the flash parameter
+ *      block, from where it is restored at boot. Smart buffer, packer and ADC
+ *      settings are restored when the calibration ends or is aborted.
+ */
+
+#ifndef SMART_BUFFER_CAL_H_
+#define SMART_BUFFER_CAL_H_
+
+#include "defines.h"
+
+#define SMART_BUFFER_CAL_NSAMP		65535
+
+void smart_buffer_cal_init(system_state_t *sys);
+int smart_buffer_cal_change_status(system_state_t *sys, smart_buffer_var_t *var, uint16_t value);
+
+/*
+ * Call on end of transfer. Returns 1 if the transfer belonged to the calibration.
+ */
+int smart_buffer_cal_eot(system_state_t *sys);
+
+#endif /* SMART_BUFFER_CAL_H_ */
@@ -0,0 +1,98 @@
+/*
+ * snapshot.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Binary snapshot of all system variables.
+ *
+ *      Blob format (all values little endian):
+ *
+ *      Header (16 bytes):
+ *      || magic (4) | version (2) | nsections (2) | length (4) | crc32 (4) ||
+ *
+ *      magic  : "LTAS".
+ *      length : total length of the blob, header included.
+ *      crc32  : CRC-32 (IEEE) of everything after the header.
+ *
+ *      Followed by nsections sections:
+ *      || id (1) | type (1) | count (2) | count values of the given type ||
+ *
+ *      Values within a section follow the order of the corresponding struct
+ *      in system_state_t. A decoder must skip unknown section ids using type
+ *      and count, so new sections can be added without breaking old hosts.
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include "defines.h"
+
+#define SNAPSHOT_MAGIC					0x5341544C	// "LTAS".
+#define SNAPSHOT_VERSION				1
+#define SNAPSHOT_HEADER_LENGTH			16
+#define SNAPSHOT_SECTION_HEADER_LENGTH	4
+#define SNAPSHOT_BUFFER_LENGTH			3072
+
+// Value types.
+#define SNAPSHOT_TYPE_U8				1
+#define SNAPSHOT_TYPE_U16				2
+#define SNAPSHOT_TYPE_U32				3
+#define SNAPSHOT_TYPE_F32				4
+
+// Section ids.
+#define SNAPSHOT_SECTION_CLOCKS			1
+#define SNAPSHOT_SECTION_CLK_SW			2
+#define SNAPSHOT_SECTION_BIASES			3
+#define SNAPSHOT_SECTION_BIAS_SW		4
+#define SNAPSHOT_SECTION_PACKER			5
+#define SNAPSHOT_SECTION_ADC			6
+#define SNAPSHOT_SECTION_SEQ_SW			7
+#define SNAPSHOT_SECTION_CDS			8
+#define SNAPSHOT_SECTION_GENERIC		9
+#define SNAPSHOT_SECTION_LEDS			10
+#define SNAPSHOT_SECTION_SMART_BUFFER	11
+#define SNAPSHOT_SECTION_ETH			12
+#define SNAPSHOT_SECTION_MASTER_SEL		13
+#define SNAPSHOT_SECTION_SYNC_GEN		14
+#define SNAPSHOT_SECTION_FR_MEAS		15
+#define SNAPSHOT_SECTION_SEQ_PROGRAM	16
+#define SNAPSHOT_SECTION_TELEMETRY		17
+#define SNAPSHOT_SECTION_PERF			18
+
+/*
+ * Serializes the system state into buf. On success, length holds the number of
+ * bytes used. Returns -1 if the blob does not fit into size bytes.
+ *
+ * Telemetry comes from the background scanner cache, or is read from the ADC
+ * in one sequencer sweep while building the blob if the scanner is off. Sources that cannot be read
+ * are stored as NaN. The sequencer program is stored without its
+ * trailing zero words.
+ *
+ * The perf section holds PERF_SNAPSHOT_VALUES values per command type, in the
+ * order of perf_stats_t after the name, which takes the first three values
+ * (PERF_NAME_LENGTH bytes, zero padded).
+ */
+int snapshot_build(system_state_t *sys, uint8_t *buf, uint32_t size, uint32_t *length);
+
+/*
+ * Builds the snapshot and sends it to the current output. Over ethernet the
+ * blob goes as raw bytes. Over uart it is printed as hex lines between
+ * "### Snapshot" and "### End" markers.
+ */
+int snapshot_send(system_state_t *sys);
+
+/*
+ * Applies a blob built by snapshot_build. The blob is checked completely
+ * (magic, version, CRC and section bounds) before anything is written.
+ *
+ * Sections are applied in blob order, so voltages are set before their
+ * switches. Unchanged clock and bias voltages are not written again. Only the
+ * operating point is restored: actions (packStart, seqStart, syncStop,
+ * bufCapStart, bufTraStart, bufReset), read only values and the generic, leds,
+ * ethernet, master selection, telemetry and perf sections are skipped. Returns -1
+ * if the blob is not valid or a value was refused.
+ */
+int snapshot_apply(system_state_t *sys, const uint8_t *blob, uint32_t length);
+
+#endif /* SNAPSHOT_H_ */
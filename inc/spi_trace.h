@@ -0,0 +1,105 @@
+/*
+ * spi_trace.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Accounting of the SPI traffic of every device.
+ *
+ *      Drivers call spi_trace_transfer and spi_trace_select instead of
+ *      XSpi_Transfer and XSpi_SetSlaveSelect, on an instance registered at
+ *      init with spi_trace_register. Per device, transfers, slave selects,
+ *      bytes, errors and time spent in XSpi_Transfer (us, perf timer) are
+ *      counted since boot and for the last command (excecute_interpret calls
+ *      spi_trace_command, so "get spi" shows the command before it).
+ *
+ *      "start spitrace" records every operation into a circular buffer of the
+ *      last SPI_TRACE_LENGTH, "stop spitrace" stops it and "reset spi" clears
+ *      counters and buffer. "get spitrace" sends the buffer in binary (all
+ *      values little endian):
+ *
+ *      Header (16 bytes):
+ *      || magic (4) | version (2) | nentries (2) | tick (4) | crc32 (4) ||
+ *
+ *      magic    : "LTAR".
+ *      nentries : number of entries that follow, oldest first.
+ *      tick     : tget_ms() when the reply was built.
+ *      crc32    : CRC-32 (IEEE) of the entries.
+ *
+ *      Entry (16 bytes):
+ *      || tstamp (4) | dev (1) | op (1) | length (2) | us (4) | data (4) ||
+ *
+ *      tstamp : tget_ms() at the operation.
+ *      op     : SPI_TRACE_OP_*, with SPI_TRACE_OP_ERROR set if it failed.
+ *      length : bytes transferred (saturated), or the slave select mask.
+ *      data   : first bytes sent, first one in the lowest byte.
+ *
+ *      The counting itself is in spi_trace_record, which only takes plain
+ *      values and calls nothing but tget_ms, so it can be fed from host code
+ *      with no XSpi behind it.
+ */
+
+#ifndef SPI_TRACE_H_
+#define SPI_TRACE_H_
+
+#include <stdint.h>
+#include "xspi.h"
+
+// Devices.
+#define SPI_TRACE_DAC				0
+#define SPI_TRACE_LDO				1
+#define SPI_TRACE_TELEMETRY			2
+#define SPI_TRACE_VOLT_SW			3
+#define SPI_TRACE_FLASH				4
+#define SPI_TRACE_NDEVS				5
+
+// Operations.
+#define SPI_TRACE_OP_TRANSFER		1
+#define SPI_TRACE_OP_SELECT			2
+#define SPI_TRACE_OP_ERROR			0x80
+
+#define SPI_TRACE_LENGTH			128
+#define SPI_TRACE_MAGIC				0x5241544C	// "LTAR".
+#define SPI_TRACE_VERSION			1
+#define SPI_TRACE_HEADER_LENGTH		16
+#define SPI_TRACE_ENTRY_LENGTH		16
+
+typedef struct {
+	uint32_t transfers;
+	uint32_t selects;
+	uint32_t bytes;
+	uint32_t errors;
+	uint32_t us;
+} spi_trace_count_t;
+
+typedef struct {
+	uint32_t tstamp;
+	uint8_t dev;
+	uint8_t op;
+	uint16_t length;
+	uint32_t us;
+	uint32_t data;
+} spi_trace_entry_t;
+
+void spi_trace_register(XSpi *spi, int dev);
+
+int spi_trace_transfer(XSpi *spi, u8 *send, u8 *recv, unsigned int n);
+int spi_trace_select(XSpi *spi, u32 mask);
+
+// Counts one operation of dev, and stores it if the trace is running.
+void spi_trace_record(int dev, uint8_t op, uint32_t length, uint32_t data, uint32_t us);
+
+// New command: the counters of the previous one become the last command's.
+void spi_trace_command(void);
+
+void spi_trace_start(void);
+void spi_trace_stop(void);
+void spi_trace_reset(void);
+
+// Counters of dev since boot or for the last command. -1 if dev is not valid.
+int spi_trace_get(int dev, int last, spi_trace_count_t *count);
+
+void spi_trace_print(void);
+void spi_trace_send(void);
+
+#endif /* SPI_TRACE_H_ */
@@ -0,0 +1,43 @@
+/*
+ * sync_align.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Synchronized start of several boards.
+ *
+ *      Every board is armed with "set syncArm 1": the sequencer is started
+ *      with its start source set to external, so it waits for the sync line.
+ *      Then "set syncGo 1" on the master (isSlave = 0) arms the master too and
+ *      starts its sync generator, and all the sequencers start on the same
+ *      edge. The end of sequence disarms the board and counts syncStarts.
+ *
+ *      Skew compensation. The sync line reaches every slave syncCable ns after
+ *      the master (0 on the master), and syncRef is the longest of these delays,
+ *      the same value on every board. "set syncCal 1" measures the sync clock
+ *      with fr_meas, sets syncLink if it is within SYNC_ALIGN_FREQ_TOL percent
+ *      of syncFreq (kHz, 0 to accept any), and writes
+ *
+ *      syncDelay = round((syncRef - syncCable) / sync clock period)
+ *
+ *      so every board starts when the latest one does. The skew left, below
+ *      one period, is reported by "get sync", together with the time from arm
+ *      to end of sequence of the last starts: boards that missed an edge show
+ *      up as longer or missing starts. syncDelay is kept in profiles, so the
+ *      calibration only has to be redone when the cabling changes.
+ */
+
+#ifndef SYNC_ALIGN_H_
+#define SYNC_ALIGN_H_
+
+#include "defines.h"
+
+void sync_align_init(sync_align_t *sync_align);
+int sync_align_change_status(system_state_t *sys, sync_align_var_t *var, uint32_t value);
+
+// Call on sequencer end of sequence.
+void sync_align_eos(system_state_t *sys);
+
+void sync_align_print(system_state_t *sys);
+
+#endif /* SYNC_ALIGN_H_ */
@@ -9,6 +9,7 @@
 #define INC_SYNC_GEN_H_
 
 #include <xil_io.h>
+#include "regmap.h"
 
 // Registers.
 #define SYNC_GEN_STOP_REG 			0
@@ -25,20 +26,50 @@
 #define SYNC_GEN_DELAY_MIN	0
 #define SYNC_GEN_DELAY_MAX	255
 
-typedef struct {
-	uint16_t value;
-	uint16_t min;
-	uint16_t max;
-	uint32_t reg_offset;
-	uint32_t reg_mask;
-	char name[15];
-} sync_gen_status_t;
+// Register list, see regmap.h.
+#define SYNC_GEN_REGS(X) \
+	X(stop, 	STOP, 	"syncStop", 	SYNC_GEN_STOP, 		SYNC_GEN_STOP, 		SYNC_GEN_START, 		REGMAP_RW) \
+	X(delay, 	DELAY, 	"syncDelay", 	SYNC_GEN_DELAY_MIN, SYNC_GEN_DELAY_MIN, SYNC_GEN_DELAY_MAX, 	REGMAP_RW)
+
+typedef regmap_reg_t sync_gen_status_t;
 
 typedef struct {
-	sync_gen_status_t stop;
-	sync_gen_status_t delay;
+	SYNC_GEN_REGS(REGMAP_FIELD)
 } sync_gen_t;
 
+// Synchronized start of several boards (see sync_align.h).
+#define SYNC_ALIGN_OFF				0
+#define SYNC_ALIGN_ON				1
+#define SYNC_ALIGN_NS_MAX			100000
+#define SYNC_ALIGN_FREQ_TOL			2		// Percent.
+
+typedef struct {
+	uint32_t value;
+	uint32_t min;
+	uint32_t max;
+	const char *name;
+} sync_align_var_t;
+
+typedef struct {
+	sync_align_var_t arm;
+	sync_align_var_t go;
+	sync_align_var_t cal;
+	sync_align_var_t freq;
+	sync_align_var_t cable;
+	sync_align_var_t ref;
+	sync_align_var_t link;
+	sync_align_var_t starts;
+} sync_align_group_status_t;
+
+typedef struct {
+	sync_align_group_status_t vars;
+	uint32_t t_arm;			// tget_ms() when armed.
+	uint32_t period_ps;		// Sync clock period from the last calibration.
+	int32_t residual_ps;	// Skew left after the delay, from the last calibration.
+	uint32_t wait_min;		// Arm to end of sequence, ms.
+	uint32_t wait_max;
+} sync_align_t;
+
 // Register read and write functions.
 #define SYNC_GEN_mWriteReg(BaseAddress, RegOffset, Data) \
   	Xil_Out32((BaseAddress) + (RegOffset), (u32)(Data))
@@ -48,5 +79,6 @@ typedef struct {
 
 void sync_gen_init(sync_gen_t *sync_gen);
 int sync_gen_change_status(sync_gen_status_t *reg, uint16_t value);
+const char *sync_gen_reg_name(const sync_gen_status_t *reg);
 
 #endif /* INC_SYNC_GEN_H_ */
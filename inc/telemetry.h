@@ -81,6 +81,9 @@
 #define TELEMETRY_DOUT_WEAK			1
 #define TELEMETRY_DOUT_OFFSET		1
 
+// Sequence register, one bit per channel from VIN0 down to VIN7.
+#define TELEMETRY_SEQ_REG_VIN0_OFFSET	12
+
 // Data back from AD7328.
 #define TELEMETRY_DATA_CHID_MASK 	7
 #define TELEMETRY_DATA_CHID_OFFSET	13
@@ -95,8 +98,8 @@
 #define TELEMETRY_AD_MAX_VOLT	10
 
 typedef struct {
-	char name[20];
-	char description[20];
+	const char *name;
+	const char *description;
 	uint8_t mux_en;
 	uint8_t mux_ch;
 	uint8_t ad_ch;
@@ -144,7 +147,142 @@ typedef struct {
 
 } telemetry_group_t;
 
+#define TELEMETRY_NSOURCES				((int)(sizeof(telemetry_group_t)/sizeof(telemetry_source_t)))
+
+// Background scanner.
+#define TELEMETRY_SCAN_OFF				0
+#define TELEMETRY_SCAN_ON				1
+#define TELEMETRY_SCAN_PERIOD_MIN		1		// ms between two sources.
+#define TELEMETRY_SCAN_PERIOD_MAX		10000
+#define TELEMETRY_SCAN_PERIOD_DEFAULT	10		// Full cycle of 34 sources in 340 ms.
+#define TELEMETRY_HIST_LENGTH			16
+
+typedef struct {
+	uint16_t value;
+	uint16_t min;
+	uint16_t max;
+	const char *name;
+} telemetry_var_t;
+
+typedef struct {
+	telemetry_var_t enable;
+	telemetry_var_t period;
+	telemetry_var_t cycles;
+} telemetry_scan_group_status_t;
+
+// Cached values of one source. Only good reads are stored.
+typedef struct {
+	float value;
+	float min;
+	float max;
+	uint32_t tstamp;	// tget_ms() of the last good read.
+	uint32_t nread;
+	uint32_t nerr;
+	uint8_t hist_idx;	// Next position to write in hist.
+	float hist[TELEMETRY_HIST_LENGTH];
+} telemetry_cache_t;
+
+typedef struct {
+	telemetry_scan_group_status_t vars;
+	uint32_t last_tick;
+	uint8_t idx;
+	uint8_t last;		// Source read by the last successful poll.
+	telemetry_cache_t cache[TELEMETRY_NSOURCES];
+} telemetry_scan_t;
+
+// Telemetry frames pushed to the host (see telemetry_stream.h).
+#define TELEMETRY_STREAM_OFF			0
+#define TELEMETRY_STREAM_ON				1
+#define TELEMETRY_STREAM_PERIOD_MIN		100		// ms between frames.
+#define TELEMETRY_STREAM_PERIOD_MAX		60000
+#define TELEMETRY_STREAM_PERIOD_DEFAULT	1000
+
+typedef struct {
+	telemetry_var_t enable;
+	telemetry_var_t period;
+	telemetry_var_t count;
+} telemetry_stream_group_status_t;
+
+typedef struct {
+	telemetry_stream_group_status_t vars;
+	uint32_t last_tick;
+	uint32_t seq;
+} telemetry_stream_t;
+
+// Interlocks (see interlock.h).
+#define INTERLOCK_OFF					0
+#define INTERLOCK_ON					1
+#define INTERLOCK_NRULES				7
+#define INTERLOCK_DEBOUNCE				3		// Consecutive bad reads before tripping.
+#define INTERLOCK_NONE					0xFF	// No switch/bias.
+
+#define INTERLOCK_ACTION_LOG			0
+#define INTERLOCK_ACTION_SW_OFF			1
+#define INTERLOCK_ACTION_RAMP			2
+
+typedef struct {
+	uint8_t source;		// Index in telemetry_group_t.
+	float min;
+	float max;
+	uint8_t action;
+	uint8_t sw;			// Index in bias_sw_group_status_t. Rule only active while it is on.
+	uint8_t bias;		// Index in bias_group_status_t, ramped down by INTERLOCK_ACTION_RAMP.
+	float ramp_to;
+	float ramp_step;
+	uint8_t enable;
+	uint8_t nbad;
+	uint8_t tripped;
+} interlock_rule_t;
+
+typedef struct {
+	telemetry_var_t enable;
+	telemetry_var_t state;
+	telemetry_var_t trips;
+	telemetry_var_t reset;
+} interlock_group_status_t;
+
+typedef struct {
+	interlock_group_status_t vars;
+	interlock_rule_t rules[INTERLOCK_NRULES];
+} interlock_t;
+
 int telemetry_init(telemetry_group_t *sources, uint32_t spi_device_id, uint32_t gpio_device_id);
 int telemetry_read(telemetry_source_t *source, float *value);
 
+/*
+ * Reads every source of the group with the AD7328 sequencer: for each mux
+ * enable the channels behind it are programmed once in the sequence register,
+ * then the mux address is stepped while conversions run back to back. A full
+ * sweep takes 43 SPI transfers instead of 68 with telemetry_read (see
+ * host/telemetry_sim.c).
+ *
+ * values and status are indexed as telemetry_group_t. status is 0 for sources
+ * read correctly.
+ */
+int telemetry_read_all(telemetry_group_t *sources, float *values, int *status);
+
+// SPI transfers done with the telemetry ADC since boot.
+uint32_t telemetry_get_transfers(void);
+
+/*
+ * The scanner reads one source every telScanPer ms, round robin over
+ * telemetry_group_t, and keeps the latest value, min/max and a short history
+ * of each one. It is polled from the main loop, so SPI transfers never happen
+ * inside an interrupt or in the middle of a command.
+ */
+void telemetry_scan_init(telemetry_scan_t *scan);
+int telemetry_scan_change_status(telemetry_scan_t *scan, telemetry_var_t *var, uint16_t value);
+
+// Returns 1 when a new value is in the cache, its index is in scan->last.
+int telemetry_scan_poll(telemetry_scan_t *scan, telemetry_group_t *sources);
+
+// Cache of a source, NULL if the scanner is off or has not read it yet.
+telemetry_cache_t *telemetry_scan_get(telemetry_scan_t *scan, telemetry_group_t *sources, telemetry_source_t *source);
+
+// Value from the cache if available, otherwise read from the ADC.
+int telemetry_scan_read(telemetry_scan_t *scan, telemetry_group_t *sources, telemetry_source_t *source, float *value);
+
+// Same for the whole group, with a telemetry_read_all sweep if the scanner is off.
+int telemetry_scan_read_all(telemetry_scan_t *scan, telemetry_group_t *sources, float *values, int *status);
+
 #endif /* SRC_TELEMETRY_H_ */
@@ -0,0 +1,63 @@
+/*
+ * telemetry_stream.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ *
+ *      Periodic binary telemetry frames.
+ *
+ *      With telStream 1, a frame with every telemetry source is pushed to the
+ *      current output every telStrmPer ms, without any command from the host.
+ *      Values come from the background scanner cache (or one sequencer sweep if
+ *      the scanner is off), so building a frame does not block the main loop.
+ *
+ *      Frame format (all values little endian):
+ *
+ *      Header (20 bytes):
+ *      || magic (4) | version (2) | nsources (2) | seq (4) | tick (4) | crc32 (4) ||
+ *
+ *      magic : "LTAT".
+ *      seq   : frame counter, gaps mean lost frames.
+ *      tick  : tget_ms() when the frame was built.
+ *      crc32 : CRC-32 (IEEE) of everything after the header.
+ *
+ *      Followed by nsources entries, in telemetry_group_t order:
+ *      || tstamp (4) | value (4, float) ||
+ *
+ *      tstamp is tget_ms() of the read, so tick - tstamp is the age of the
+ *      value. Sources never read are sent as NaN with tstamp 0.
+ *
+ *      Over ethernet the frame goes as raw bytes, over uart as hex lines
+ *      between "### Telemetry" and "### End". host/telemetry_decode.c turns a
+ *      capture of frames into CSV.
+ *
+ *      Frames are only sent from the main loop between commands, never inside
+ *      the answer of one: a reader waiting for "Done" gets the frame before
+ *      or after the whole answer. Over ethernet the push does not wait for
+ *      the host; a frame due while the previous one is still pending is
+ *      skipped (a gap in seq). If the host does not take a frame within the
+ *      handshake timeout, telStream goes back to 0 and an error is printed
+ *      once on the uart.
+ */
+
+#ifndef TELEMETRY_STREAM_H_
+#define TELEMETRY_STREAM_H_
+
+#include "defines.h"
+
+#define TELEMETRY_STREAM_MAGIC			0x5441544C	// "LTAT".
+#define TELEMETRY_STREAM_VERSION		1
+#define TELEMETRY_STREAM_HEADER_LENGTH	20
+#define TELEMETRY_STREAM_ENTRY_LENGTH	8
+#define TELEMETRY_STREAM_FRAME_LENGTH	(TELEMETRY_STREAM_HEADER_LENGTH + TELEMETRY_NSOURCES*TELEMETRY_STREAM_ENTRY_LENGTH)
+
+void telemetry_stream_init(system_state_t *sys);
+int telemetry_stream_change_status(system_state_t *sys, telemetry_var_t *var, uint16_t value);
+
+/*
+ * Sends a frame when due, and moves the previous one along. Returns 1 if a
+ * frame was started.
+ */
+int telemetry_stream_poll(system_state_t *sys);
+
+#endif /* TELEMETRY_STREAM_H_ */
@@ -2,9 +2,57 @@
 #define UART_H_
 
 #include <stdint.h>
+#include "defines.h"
+
+/*
+ * Console UART Lite, interrupt driven.
+ *
+ * The isr moves every received byte into an rx ring and refills the tx fifo
+ * from a tx ring, so input typed or pasted while a long command runs is kept
+ * and output does not wait for the line. print and xil_printf go through the
+ * tx ring too (outbyte is replaced), so everything comes out in order.
+ *
+ * Until uart_irq_init, or if the UART interrupt is not wired to the
+ * controller, the UART is polled: uart_rcv empties the fifo and output is
+ * written directly.
+ *
+ * uart_line_put assembles the received bytes into a command line, with the
+ * echo and line editing of the console.
+ */
+
+#define UART_RX_LENGTH			1024	// Power of 2.
+#define UART_TX_LENGTH			1024	// Power of 2.
+
+// Echo of the line assembler.
+#define UART_ECHO_OFF			0
+#define UART_ECHO_ON			1
+#define UART_ECHO_MASK			2		// '*' for every char, for passwords.
+
+typedef struct {
+	char buf[USERCOMMANDLENGTH];
+	unsigned int idx;
+	uint32_t dropped;					// Chars past the line length.
+} uart_line_t;
 
 int uart_init(uint16_t device_id);
-unsigned int uart_rcv(uint8_t *buf);
+
+// Connects the isr. XST_FAILURE if there is no UART interrupt, it is polled.
+int uart_irq_init(void);
+
+// Up to n received bytes, without waiting.
+unsigned int uart_rcv(uint8_t *buf, unsigned int n);
+
+// Queue for transmission. Waits only if the tx ring is full.
+void uart_putc(uint8_t c);
+void uart_puts(const char *str);
+
+// Adds c to line. 1 when c ends the line, which is then in line->buf. -1 when
+// c ends a line longer than USERCOMMANDLENGTH - 1, which must be rejected and
+// cleared (line->dropped chars were lost).
+int uart_line_put(uart_line_t *line, uint8_t c, int echo);
+void uart_line_clear(uart_line_t *line);
+
+void uart_print(void);
 
 void uart_eraseBuffer(uint8_t *buf, unsigned int n);
 
@@ -15,6 +63,7 @@ void uart_printMenu();
 void uart_cmdReset();
 void uart_cmdBoardInfo();
 void uart_cmdRead(char *addr, char *nBytes);
+void uart_cmdBench(char *addr, char *nBytes);
 void uart_cmdReadByte(char *addr);
 void uart_cmdReadWord(char *addr);
 void uart_cmdReadQWord(char *addr);
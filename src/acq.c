@@ -0,0 +1,252 @@
+/*
+ * acq.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "acq.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+void acq_init(acq_t *acq)
+{
+	acq->vars.start.value 	= ACQ_STOP;
+	acq->vars.start.min 	= ACQ_STOP;
+	acq->vars.start.max 	= ACQ_START;
+	acq->vars.start.name = "acqRun";
+
+	acq->vars.frames.value 	= 1;
+	acq->vars.frames.min 	= 1;
+	acq->vars.frames.max 	= ACQ_FRAMES_MAX;
+	acq->vars.frames.name = "acqFrames";
+
+	acq->vars.expo.value 	= 0;
+	acq->vars.expo.min 		= 0;
+	acq->vars.expo.max 		= ACQ_EXPO_MAX;
+	acq->vars.expo.name = "acqExpo";
+
+	acq->vars.clean.value 	= 0;
+	acq->vars.clean.min 	= 0;
+	acq->vars.clean.max 	= ACQ_CLEAN_MAX;
+	acq->vars.clean.name = "acqClean";
+
+	// Read only variable.
+	acq->vars.frame.value 	= 0;
+	acq->vars.frame.min 	= 0;
+	acq->vars.frame.max 	= 0;
+	acq->vars.frame.name = "acqFrame";
+
+	acq->state = ACQ_STATE_IDLE;
+}
+
+static void acq_stat_reset(acq_stat_t *stat)
+{
+	stat->min = 0xFFFFFFFF;
+	stat->max = 0;
+	stat->sum = 0;
+}
+
+static void acq_stat_add(acq_stat_t *stat, uint32_t value)
+{
+	if (value < stat->min) stat->min = value;
+	if (value > stat->max) stat->max = value;
+	stat->sum += value;
+}
+
+static void acq_stat_print(const char *name, acq_stat_t *stat, uint32_t n)
+{
+	char str[100];
+
+	io_sprintf(str, "%s : min %u, mean %u, max %u ms\r\n", (char *) name, stat->min, stat->sum / n, stat->max);
+	mprint(str);
+}
+
+void acq_print(acq_t *acq)
+{
+	char str[100];
+	uint32_t n = acq->vars.frame.value;
+
+	mprint("### Acquisition ###\r\n");
+	io_sprintf(str, "Frames : %u of %u%s\r\n", n, acq->vars.frames.value, (acq->state != ACQ_STATE_IDLE) ? ", running" : "");
+	mprint(str);
+	if (n == 0)
+	{
+		return;
+	}
+
+	acq_stat_print("Expo", &(acq->expo), n);
+	acq_stat_print("Readout", &(acq->readout), n);
+	acq_stat_print("Dead", &(acq->dead), n);
+
+	// Share of the run spent exposing, in percent.
+	uint32_t total = acq->expo.sum + acq->readout.sum + acq->dead.sum;
+	if (total > 0)
+	{
+		io_sprintf(str, "Duty : %u percent\r\n", (uint32_t) ((uint64_t) acq->expo.sum * 100 / total));
+		mprint(str);
+	}
+}
+
+// Clean if selected for this frame, then start the exposure.
+static void acq_next_frame(system_state_t *sys)
+{
+	acq_t *acq = &(sys->acq);
+	uint32_t clean = acq->vars.clean.value;
+
+	if ( (clean & (ACQ_CLEAN_ERASE | ACQ_CLEAN_EPURGE)) &&
+		 (acq->vars.frame.value == 0 || (clean & ACQ_CLEAN_EVERY)) )
+	{
+		acq->state = ACQ_STATE_CLEAN;
+	}
+	else
+	{
+		acq->state = ACQ_STATE_EXPOSE;
+		acq->t_expo = tget_ms();
+	}
+}
+
+static void acq_stop_readout(system_state_t *sys)
+{
+	seq_change_sw_status(&(sys->seq.sw_group.stop), SEQUENCER_STOP);
+	sync_gen_change_status(&(sys->sync_gen.stop), SYNC_GEN_STOP);
+	packer_change_sw_status(&(sys->packer_sw.start), PACKER_START_OFF);
+}
+
+static void acq_end(system_state_t *sys, const char *how)
+{
+	acq_t *acq = &(sys->acq);
+	char str[100];
+
+	acq->state 				= ACQ_STATE_IDLE;
+	acq->vars.start.value 	= ACQ_STOP;
+
+	io_sprintf(str, "Acquisition %s after %u ms\r\n", (char *) how, tget_ms() - acq->t0);
+	mprint(str);
+	acq_print(acq);
+}
+
+int acq_change_status(system_state_t *sys, acq_var_t *var, uint32_t value)
+{
+	acq_t *acq = &(sys->acq);
+
+	// Read only.
+	if (var == &(acq->vars.frame))
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+
+	if (var == &(acq->vars.start))
+	{
+		if (value == ACQ_START && acq->state == ACQ_STATE_IDLE)
+		{
+			acq->vars.frame.value = 0;
+			acq_stat_reset(&(acq->expo));
+			acq_stat_reset(&(acq->readout));
+			acq_stat_reset(&(acq->dead));
+			acq->t0 	= tget_ms();
+			acq->t_end 	= acq->t0;
+			var->value 	= value;
+			acq_next_frame(sys);
+		}
+		else if (value == ACQ_STOP && acq->state != ACQ_STATE_IDLE)
+		{
+			if (acq->state == ACQ_STATE_READOUT)
+			{
+				acq_stop_readout(sys);
+			}
+			acq_end(sys, "aborted");
+		}
+		return 0;
+	}
+
+	// Run settings can not change during a run.
+	if (acq->state != ACQ_STATE_IDLE)
+	{
+		return -1;
+	}
+	var->value = value;
+
+	return 0;
+}
+
+void acq_eos(system_state_t *sys)
+{
+	acq_t *acq = &(sys->acq);
+	char str[100];
+
+	if (acq->state != ACQ_STATE_READOUT)
+	{
+		return;
+	}
+
+	uint32_t now 		= tget_ms();
+	uint32_t expo 		= acq->t_readout - acq->t_expo;
+	uint32_t readout 	= now - acq->t_readout;
+	uint32_t dead 		= acq->t_expo - acq->t_end;
+
+	acq_stat_add(&(acq->expo), expo);
+	acq_stat_add(&(acq->readout), readout);
+	acq_stat_add(&(acq->dead), dead);
+	acq->t_end = now;
+	acq->vars.frame.value++;
+
+	// Next exposure runs while this frame is reported.
+	if (acq->vars.frame.value < acq->vars.frames.value)
+	{
+		acq_next_frame(sys);
+	}
+
+	io_sprintf(str, "Frame %u: expo %u, readout %u, dead %u ms\r\n", acq->vars.frame.value, expo, readout, dead);
+	mprint(str);
+
+	if (acq->vars.frame.value == acq->vars.frames.value)
+	{
+		acq_end(sys, "done");
+	}
+}
+
+void acq_poll(system_state_t *sys)
+{
+	acq_t *acq = &(sys->acq);
+	uint32_t clean = acq->vars.clean.value;
+
+	switch (acq->state)
+	{
+	case ACQ_STATE_CLEAN:
+		// Both functions block until the CCD is clean.
+		if (clean & ACQ_CLEAN_ERASE)
+		{
+			sys->exec.ccd_erase.func(sys);
+		}
+		if (clean & ACQ_CLEAN_EPURGE)
+		{
+			sys->exec.cdd_epurge.func(sys);
+		}
+		acq->state 	= ACQ_STATE_EXPOSE;
+		acq->t_expo = tget_ms();
+		break;
+
+	case ACQ_STATE_EXPOSE:
+		if (tget_ms() - acq->t_expo >= acq->vars.expo.value)
+		{
+			acq->t_readout = tget_ms();
+			acq->state = ACQ_STATE_READOUT;
+			packer_change_sw_status(&(sys->packer_sw.start), PACKER_START_ON);
+			sync_gen_change_status(&(sys->sync_gen.stop), SYNC_GEN_START);
+			seq_change_sw_status(&(sys->seq.sw_group.stop), SEQUENCER_START);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
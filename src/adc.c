@@ -53,100 +53,100 @@ int adc_init(uint32_t gpio_device_id, gpio_adc_t *gpio_adc)
 
 	// Initialize structure.
 	// Channel A.
-	strcpy(gpio_adc->sw_group.cha_enable.name, "enA");
+	gpio_adc->sw_group.cha_enable.name = "enA";
 	gpio_adc->sw_group.cha_enable.status 				= ADC_ENABLE;
 	gpio_adc->sw_group.cha_enable.bit_position 			= GPIO_ADC_CHA_ENABLE;
 	gpio_adc->sw_group.cha_enable.min 					= 0;
 	gpio_adc->sw_group.cha_enable.max 					= 1;
 
-	strcpy(gpio_adc->sw_group.cha_test_pattern.name, "testPtrnA");
+	gpio_adc->sw_group.cha_test_pattern.name = "testPtrnA";
 	gpio_adc->sw_group.cha_test_pattern.status 			= ADC_TEST_OFF;
 	gpio_adc->sw_group.cha_test_pattern.bit_position 	= GPIO_ADC_CHA_TEST_PATTERN;
 	gpio_adc->sw_group.cha_test_pattern.min 			= 0;
 	gpio_adc->sw_group.cha_test_pattern.max 			= 1;
 
-	strcpy(gpio_adc->sw_group.cha_send_bitslip.name, "bitSlipA");
+	gpio_adc->sw_group.cha_send_bitslip.name = "bitSlipA";
 	gpio_adc->sw_group.cha_send_bitslip.status 			= ADC_SEND_BITSLIP_OFF;
 	gpio_adc->sw_group.cha_send_bitslip.bit_position 	= GPIO_ADC_CHA_SEND_BITSLIP;
 	gpio_adc->sw_group.cha_send_bitslip.min = 0;
 	gpio_adc->sw_group.cha_send_bitslip.max = 1;
 
-	strcpy(gpio_adc->sw_group.cha_pd_n.name, "pdA");
+	gpio_adc->sw_group.cha_pd_n.name = "pdA";
 	gpio_adc->sw_group.cha_pd_n.status 					= ADC_PDOWN_OFF;
 	gpio_adc->sw_group.cha_pd_n.bit_position 			= GPIO_ADC_CHA_PD_N;
 	gpio_adc->sw_group.cha_pd_n.min 					= 0;
 	gpio_adc->sw_group.cha_pd_n.max 					= 1;
 
 	// Channel B.
-	strcpy(gpio_adc->sw_group.chb_enable.name, "enB");
+	gpio_adc->sw_group.chb_enable.name = "enB";
 	gpio_adc->sw_group.chb_enable.status 				= ADC_ENABLE;
 	gpio_adc->sw_group.chb_enable.bit_position 			= GPIO_ADC_CHB_ENABLE;
 	gpio_adc->sw_group.chb_enable.min 					= 0;
 	gpio_adc->sw_group.chb_enable.max 					= 1;
 
-	strcpy(gpio_adc->sw_group.chb_test_pattern.name, "testPtrnB");
+	gpio_adc->sw_group.chb_test_pattern.name = "testPtrnB";
 	gpio_adc->sw_group.chb_test_pattern.status 			= ADC_TEST_OFF;
 	gpio_adc->sw_group.chb_test_pattern.bit_position 	= GPIO_ADC_CHB_TEST_PATTERN;
 	gpio_adc->sw_group.chb_test_pattern.min 			= 0;
 	gpio_adc->sw_group.chb_test_pattern.max 			= 1;
 
-	strcpy(gpio_adc->sw_group.chb_send_bitslip.name, "bitSlipB");
+	gpio_adc->sw_group.chb_send_bitslip.name = "bitSlipB";
 	gpio_adc->sw_group.chb_send_bitslip.status 			= ADC_SEND_BITSLIP_OFF;
 	gpio_adc->sw_group.chb_send_bitslip.bit_position 	= GPIO_ADC_CHB_SEND_BITSLIP;
 	gpio_adc->sw_group.chb_send_bitslip.min = 0;
 	gpio_adc->sw_group.chb_send_bitslip.max = 1;
 
-	strcpy(gpio_adc->sw_group.chb_pd_n.name, "pdB");
+	gpio_adc->sw_group.chb_pd_n.name = "pdB";
 	gpio_adc->sw_group.chb_pd_n.status 					= ADC_PDOWN_OFF;
 	gpio_adc->sw_group.chb_pd_n.bit_position 			= GPIO_ADC_CHB_PD_N;
 	gpio_adc->sw_group.chb_pd_n.min 					= 0;
 	gpio_adc->sw_group.chb_pd_n.max 					= 1;
 
 	// Channel C.
-	strcpy(gpio_adc->sw_group.chc_enable.name, "enC");
+	gpio_adc->sw_group.chc_enable.name = "enC";
 	gpio_adc->sw_group.chc_enable.status 				= ADC_ENABLE;
 	gpio_adc->sw_group.chc_enable.bit_position 			= GPIO_ADC_CHC_ENABLE;
 	gpio_adc->sw_group.chc_enable.min 					= 0;
 	gpio_adc->sw_group.chc_enable.max 					= 1;
 
-	strcpy(gpio_adc->sw_group.chc_test_pattern.name, "testPtrnC");
+	gpio_adc->sw_group.chc_test_pattern.name = "testPtrnC";
 	gpio_adc->sw_group.chc_test_pattern.status 			= ADC_TEST_OFF;
 	gpio_adc->sw_group.chc_test_pattern.bit_position 	= GPIO_ADC_CHC_TEST_PATTERN;
 	gpio_adc->sw_group.chc_test_pattern.min 			= 0;
 	gpio_adc->sw_group.chc_test_pattern.max 			= 1;
 
-	strcpy(gpio_adc->sw_group.chc_send_bitslip.name, "bitSlipC");
+	gpio_adc->sw_group.chc_send_bitslip.name = "bitSlipC";
 	gpio_adc->sw_group.chc_send_bitslip.status 			= ADC_SEND_BITSLIP_OFF;
 	gpio_adc->sw_group.chc_send_bitslip.bit_position 	= GPIO_ADC_CHC_SEND_BITSLIP;
 	gpio_adc->sw_group.chc_send_bitslip.min = 0;
 	gpio_adc->sw_group.chc_send_bitslip.max = 1;
 
-	strcpy(gpio_adc->sw_group.chc_pd_n.name, "pdC");
+	gpio_adc->sw_group.chc_pd_n.name = "pdC";
 	gpio_adc->sw_group.chc_pd_n.status 					= ADC_PDOWN_OFF;
 	gpio_adc->sw_group.chc_pd_n.bit_position 			= GPIO_ADC_CHC_PD_N;
 	gpio_adc->sw_group.chc_pd_n.min 					= 0;
 	gpio_adc->sw_group.chc_pd_n.max 					= 1;
 
 	// Channel D.
-	strcpy(gpio_adc->sw_group.chd_enable.name, "enD");
+	gpio_adc->sw_group.chd_enable.name = "enD";
 	gpio_adc->sw_group.chd_enable.status 				= ADC_ENABLE;
 	gpio_adc->sw_group.chd_enable.bit_position 			= GPIO_ADC_CHD_ENABLE;
 	gpio_adc->sw_group.chd_enable.min 					= 0;
 	gpio_adc->sw_group.chd_enable.max 					= 1;
 
-	strcpy(gpio_adc->sw_group.chd_test_pattern.name, "testPtrnD");
+	gpio_adc->sw_group.chd_test_pattern.name = "testPtrnD";
 	gpio_adc->sw_group.chd_test_pattern.status 			= ADC_TEST_OFF;
 	gpio_adc->sw_group.chd_test_pattern.bit_position 	= GPIO_ADC_CHD_TEST_PATTERN;
 	gpio_adc->sw_group.chd_test_pattern.min 			= 0;
 	gpio_adc->sw_group.chd_test_pattern.max 			= 1;
 
-	strcpy(gpio_adc->sw_group.chd_send_bitslip.name, "bitSlipD");
+	gpio_adc->sw_group.chd_send_bitslip.name = "bitSlipD";
 	gpio_adc->sw_group.chd_send_bitslip.status 			= ADC_SEND_BITSLIP_OFF;
 	gpio_adc->sw_group.chd_send_bitslip.bit_position 	= GPIO_ADC_CHD_SEND_BITSLIP;
 	gpio_adc->sw_group.chd_send_bitslip.min = 0;
 	gpio_adc->sw_group.chd_send_bitslip.max = 1;
 
-	strcpy(gpio_adc->sw_group.chd_pd_n.name, "pdD");
+	gpio_adc->sw_group.chd_pd_n.name = "pdD";
 	gpio_adc->sw_group.chd_pd_n.status 					= ADC_PDOWN_OFF;
 	gpio_adc->sw_group.chd_pd_n.bit_position 			= GPIO_ADC_CHD_PD_N;
 	gpio_adc->sw_group.chd_pd_n.min 					= 0;
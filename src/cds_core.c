@@ -9,74 +9,112 @@
 #include "io_func.h"
 
 /************************** Function Definitions ***************************/
-int cds_core_init(cds_var_group_status_t *cds_var_group)
+// Names of the variables of one group, in cds_var_group_status_t order.
+#define CDS_CORE_NAMES(ch)	{ "pinit" ch, "sinit" ch, "psamp" ch, "ssamp" ch, "cdsout" ch }
+
+static const char * const cds_core_names_all[] 	= CDS_CORE_NAMES("");
+static const char * const cds_core_names_a[] 	= CDS_CORE_NAMES("A");
+static const char * const cds_core_names_b[] 	= CDS_CORE_NAMES("B");
+static const char * const cds_core_names_c[] 	= CDS_CORE_NAMES("C");
+static const char * const cds_core_names_d[] 	= CDS_CORE_NAMES("D");
+
+static void cds_core_set_var(cds_var_status_t *cds_var, uint16_t value, uint16_t min, uint16_t max,
+		uint32_t reg_offset, uint32_t reg_mask, uint32_t nbits, uint32_t base_addr, const char *name)
 {
-	cds_var_group->delay_p.value = CDS_CORE_DELAY_P_DEFAULT;
-	cds_var_group->delay_p.min = CDS_CORE_DELAY_MIN;
-	cds_var_group->delay_p.max = CDS_CORE_DELAY_MAX;
-	cds_var_group->delay_p.reg_offset = CDS_CORE_DELAY_P_OFFSET;
-	cds_var_group->delay_p.reg_mask = CDS_CORE_DELAY_P_MASK;
-	cds_var_group->delay_p.nbits = CDS_CORE_DELAY_P_NUM_BITS;
-	strcpy(cds_var_group->delay_p.name,"pinit");
-
-	cds_var_group->delay_s.value = CDS_CORE_DELAY_S_DEFAULT;
-	cds_var_group->delay_s.min = CDS_CORE_DELAY_MIN;
-	cds_var_group->delay_s.max = CDS_CORE_DELAY_MAX;
-	cds_var_group->delay_s.reg_offset = CDS_CORE_DELAY_S_OFFSET;
-	cds_var_group->delay_s.reg_mask = CDS_CORE_DELAY_S_MASK;
-	cds_var_group->delay_s.nbits = CDS_CORE_DELAY_S_NUM_BITS;
-	strcpy(cds_var_group->delay_s.name,"sinit");
-
-	cds_var_group->sample_p.value = CDS_CORE_SAMPLES_P_DEFAULT;
-	cds_var_group->sample_p.min = CDS_CORE_SAMPLE_MIN;
-	cds_var_group->sample_p.max = CDS_CORE_SAMPLE_MAX;
-	cds_var_group->sample_p.reg_offset = CDS_CORE_SAMPLE_P_OFFSET;
-	cds_var_group->sample_p.reg_mask = CDS_CORE_SAMPLE_P_MASK;
-	cds_var_group->sample_p.nbits = CDS_CORE_SAMPLE_P_NUM_BITS;
-	strcpy(cds_var_group->sample_p.name,"psamp");
-
-	cds_var_group->sample_s.value = CDS_CORE_SAMPLES_S_DEFAULT;
-	cds_var_group->sample_s.min = CDS_CORE_SAMPLE_MIN;
-	cds_var_group->sample_s.max = CDS_CORE_SAMPLE_MAX;
-	cds_var_group->sample_s.reg_offset = CDS_CORE_SAMPLE_S_OFFSET;
-	cds_var_group->sample_s.reg_mask = CDS_CORE_SAMPLE_S_MASK;
-	cds_var_group->sample_s.nbits = CDS_CORE_SAMPLE_S_NUM_BITS;
-	strcpy(cds_var_group->sample_s.name,"ssamp");
-
-	cds_var_group->outsel.value = CDS_CORE_OUTSEL_DEFAULT;
-	cds_var_group->outsel.min = CDS_CORE_OUTSEL_PED;
-	cds_var_group->outsel.max = CDS_CORE_OUTSEL_PED_m_SIG;
-	cds_var_group->outsel.reg_offset = CDS_CORE_OUTSEL_OFFSET;
-	cds_var_group->outsel.reg_mask = CDS_CORE_OUTSEL_MASK;
-	cds_var_group->outsel.nbits = CDS_CORE_OUTSEL_NUM_BITS;
-	strcpy(cds_var_group->outsel.name,"cdsout");
-
-	//put default values in hardware
-	cds_core_change_var_value(&(cds_var_group->delay_p),1);
-	cds_core_change_var_value(&(cds_var_group->delay_s),1);
-	cds_core_change_var_value(&(cds_var_group->sample_p),1);
-	cds_core_change_var_value(&(cds_var_group->sample_s),1);
-	cds_core_change_var_value(&(cds_var_group->outsel),2);
+	cds_var->value = value;
+	cds_var->min = min;
+	cds_var->max = max;
+	cds_var->reg_offset = reg_offset;
+	cds_var->reg_mask = reg_mask;
+	cds_var->nbits = nbits;
+	cds_var->base_addr = base_addr;
+	cds_var->name = name;
+	cds_var->mixed = 0;
+}
+
+static void cds_core_group_init(cds_var_group_status_t *cds_var_group, uint32_t base_addr, const char * const *names)
+{
+	cds_core_set_var(&(cds_var_group->delay_p), CDS_CORE_DELAY_P_DEFAULT, CDS_CORE_DELAY_MIN, CDS_CORE_DELAY_MAX,
+			CDS_CORE_DELAY_P_OFFSET, CDS_CORE_DELAY_P_MASK, CDS_CORE_DELAY_P_NUM_BITS, base_addr, names[0]);
+	cds_core_set_var(&(cds_var_group->delay_s), CDS_CORE_DELAY_S_DEFAULT, CDS_CORE_DELAY_MIN, CDS_CORE_DELAY_MAX,
+			CDS_CORE_DELAY_S_OFFSET, CDS_CORE_DELAY_S_MASK, CDS_CORE_DELAY_S_NUM_BITS, base_addr, names[1]);
+	cds_core_set_var(&(cds_var_group->sample_p), CDS_CORE_SAMPLES_P_DEFAULT, CDS_CORE_SAMPLE_MIN, CDS_CORE_SAMPLE_MAX,
+			CDS_CORE_SAMPLE_P_OFFSET, CDS_CORE_SAMPLE_P_MASK, CDS_CORE_SAMPLE_P_NUM_BITS, base_addr, names[2]);
+	cds_core_set_var(&(cds_var_group->sample_s), CDS_CORE_SAMPLES_S_DEFAULT, CDS_CORE_SAMPLE_MIN, CDS_CORE_SAMPLE_MAX,
+			CDS_CORE_SAMPLE_S_OFFSET, CDS_CORE_SAMPLE_S_MASK, CDS_CORE_SAMPLE_S_NUM_BITS, base_addr, names[3]);
+	cds_core_set_var(&(cds_var_group->outsel), CDS_CORE_OUTSEL_DEFAULT, CDS_CORE_OUTSEL_PED, CDS_CORE_OUTSEL_PED_m_SIG,
+			CDS_CORE_OUTSEL_OFFSET, CDS_CORE_OUTSEL_MASK, CDS_CORE_OUTSEL_NUM_BITS, base_addr, names[4]);
+
+	// Put default values in hardware. Shadows are not trusted here.
+	if (base_addr != CDS_CORE_BROADCAST)
+	{
+		cds_var_status_t *cds_var = (cds_var_status_t *) cds_var_group;
+		int nCds_var = sizeof(cds_var_group_status_t)/sizeof(cds_var_status_t);
+		int i;
+
+		for (i=0; i<nCds_var; i++)
+		{
+			CDS_CORE_mWriteReg(cds_var->base_addr, cds_var->reg_offset, (uint32_t) cds_var->value);
+			cds_var++;
+		}
+	}
+}
+
+int cds_core_init(cds_t *cds)
+{
+	cds_core_group_init(&(cds->all), CDS_CORE_BROADCAST, cds_core_names_all);
+	cds_core_group_init(&(cds->cha), XPAR_CDS_CORE_A_BASEADDR, cds_core_names_a);
+	cds_core_group_init(&(cds->chb), XPAR_CDS_CORE_B_BASEADDR, cds_core_names_b);
+	cds_core_group_init(&(cds->chc), XPAR_CDS_CORE_C_BASEADDR, cds_core_names_c);
+	cds_core_group_init(&(cds->chd), XPAR_CDS_CORE_D_BASEADDR, cds_core_names_d);
 
 	return 0;
 }
 
-int cds_core_change_var_value(cds_var_status_t *cds_var, const uint16_t value)
+// The alias of cds_var follows the channels: their value if the four agree,
+// mixed otherwise (value is then channel A's, so a snapshot still restores).
+static void cds_core_update_alias(cds_t *cds, cds_var_status_t *cds_var)
 {
+	int nCds_var = sizeof(cds_var_group_status_t)/sizeof(cds_var_status_t);
+	int idx = (cds_var - (cds_var_status_t *) &(cds->cha)) % nCds_var;
+	cds_var_status_t *all = (cds_var_status_t *) &(cds->all) + idx;
+	uint16_t a = ((cds_var_status_t *) &(cds->cha) + idx)->value;
+	uint16_t b = ((cds_var_status_t *) &(cds->chb) + idx)->value;
+	uint16_t c = ((cds_var_status_t *) &(cds->chc) + idx)->value;
+	uint16_t d = ((cds_var_status_t *) &(cds->chd) + idx)->value;
 
+	all->value = a;
+	all->mixed = (a != b || a != c || a != d);
+}
 
-	if (value >= cds_var->min && value <= cds_var->max)
+int cds_core_change_var_value(cds_t *cds, cds_var_status_t *cds_var, const uint16_t value)
+{
+	if (value < cds_var->min || value > cds_var->max)
 	{
-		cds_var->value = value;
+		return -1;
 	}
-	else
+
+	if (cds_var->base_addr == CDS_CORE_BROADCAST)
 	{
-		return -1;
+		// Same register on every channel, the alias is updated with them.
+		int idx = cds_var - (cds_var_status_t *) &(cds->all);
+
+		cds_core_change_var_value(cds, (cds_var_status_t *) &(cds->cha) + idx, value);
+		cds_core_change_var_value(cds, (cds_var_status_t *) &(cds->chb) + idx, value);
+		cds_core_change_var_value(cds, (cds_var_status_t *) &(cds->chc) + idx, value);
+		cds_core_change_var_value(cds, (cds_var_status_t *) &(cds->chd) + idx, value);
+
+		return 0;
+	}
+
+	// Shadow check.
+	if (cds_var->value != value)
+	{
+		cds_var->value = value;
+		CDS_CORE_mWriteReg(cds_var->base_addr, cds_var->reg_offset, (uint32_t) cds_var->value);
 	}
 
-	CDS_CORE_mWriteReg(XPAR_CDS_CORE_A_BASEADDR, cds_var->reg_offset,(uint32_t) cds_var->value);
-	CDS_CORE_mWriteReg(XPAR_CDS_CORE_B_BASEADDR, cds_var->reg_offset,(uint32_t) cds_var->value);
-	CDS_CORE_mWriteReg(XPAR_CDS_CORE_C_BASEADDR, cds_var->reg_offset,(uint32_t) cds_var->value);
-	CDS_CORE_mWriteReg(XPAR_CDS_CORE_D_BASEADDR, cds_var->reg_offset,(uint32_t) cds_var->value);
+	cds_core_update_alias(cds, cds_var);
+
 	return 0;
 }
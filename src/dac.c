@@ -48,6 +48,7 @@
 #include "dac.h"
 #include "interrupt.h"
 #include "io_func.h"
+#include "spi_trace.h"
 
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
@@ -72,6 +73,9 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	uint32_t base_addr	 = 0;
 	uint32_t control_val = 0;
 
+	// Count its traffic.
+	spi_trace_register(&spi_dac_i, SPI_TRACE_DAC);
+
 	// Init spi_dac_i structure.
 	ret = XSpi_Initialize(&spi_dac_i, spi_device_id);
 	if (ret != XST_SUCCESS) {
@@ -143,22 +147,22 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	//status of ldac_n switch
 	clk_sw->sw_group.ldac_n.status = 0;
 	clk_sw->sw_group.ldac_n.bit_position = GPIO_DAC_DAC_LDAC_N_POSITION;
-	strcpy(clk_sw->sw_group.ldac_n.name, "ldac_n");
+	clk_sw->sw_group.ldac_n.name = "ldac_n";
 
 	//status of clr_n switch
 	clk_sw->sw_group.clr_n.status = 0;
 	clk_sw->sw_group.clr_n.bit_position = GPIO_DAC_DAC_CLR_N_POSITION;
-	strcpy(clk_sw->sw_group.clr_n.name, "clr_n");
+	clk_sw->sw_group.clr_n.name = "clr_n";
 
 	//status of reset_n switch
 	clk_sw->sw_group.reset_n.status = 0;
 	clk_sw->sw_group.reset_n.bit_position = GPIO_DAC_DAC_RESET_N_POSITION;
-	strcpy(clk_sw->sw_group.reset_n.name, "reset_n");
+	clk_sw->sw_group.reset_n.name = "reset_n";
 
 	//status of sw_en switch
 	clk_sw->sw_group.sw_en.status = 0;
 	clk_sw->sw_group.sw_en.bit_position = GPIO_DAC_DAC_SW_EN_POSITION;
-	strcpy(clk_sw->sw_group.sw_en.name, "sw_en");
+	clk_sw->sw_group.sw_en.name = "sw_en";
 
 	/*
 	 * Reset sequence of DAC DAC.
@@ -228,7 +232,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v1ah.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->v1ah.gain = (float)DAC_VXC_GAIN;
 	clks->v1ah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v1ah.name, "v1ah");
+	clks->v1ah.name = "v1ah";
 
 	clks->v1al.value = 0;
 	clks->v1al.reg = DAC_G0_Ch1;
@@ -238,7 +242,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v1al.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->v1al.gain = (float)DAC_VXC_GAIN;
 	clks->v1al.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v1al.name, "v1al");
+	clks->v1al.name = "v1al";
 
 	clks->v2ch.value = 0;
 	clks->v2ch.reg = DAC_G0_Ch2;
@@ -248,7 +252,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v2ch.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->v2ch.gain = (float)DAC_VXC_GAIN;
 	clks->v2ch.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v2ch.name, "v2ch");
+	clks->v2ch.name = "v2ch";
 
 	clks->v2cl.value = 0;
 	clks->v2cl.reg = DAC_G0_Ch3;
@@ -258,7 +262,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v2cl.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->v2cl.gain = (float)DAC_VXC_GAIN;
 	clks->v2cl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v2cl.name, "v2cl");
+	clks->v2cl.name = "v2cl";
 
 	clks->v3ah.value = 0;
 	clks->v3ah.reg = DAC_G0_Ch4;
@@ -268,7 +272,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v3ah.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->v3ah.gain = (float)DAC_VXC_GAIN;
 	clks->v3ah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v3ah.name, "v3ah");
+	clks->v3ah.name = "v3ah";
 
 	clks->v3al.value = 0;
 	clks->v3al.reg = DAC_G0_Ch5;
@@ -278,7 +282,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v3al.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->v3al.gain = (float)DAC_VXC_GAIN;
 	clks->v3al.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v3al.name, "v3al");
+	clks->v3al.name = "v3al";
 
 	clks->h1ah.value = 0;
 	clks->h1ah.reg = DAC_G0_Ch6;
@@ -288,7 +292,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h1ah.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->h1ah.gain = (float)DAC_ALL_GAIN;
 	clks->h1ah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h1ah.name, "h1ah");
+	clks->h1ah.name = "h1ah";
 
 	clks->h1al.value = 0;
 	clks->h1al.reg = DAC_G0_Ch7;
@@ -298,7 +302,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h1al.offset = (float)DAC_CH0_OFFSET_DEFAULT;
 	clks->h1al.gain = (float)DAC_ALL_GAIN;
 	clks->h1al.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h1al.name, "h1al");
+	clks->h1al.name = "h1al";
 
 	/*
 	 * DAC Channel 1.
@@ -312,7 +316,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h1bh.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->h1bh.gain = (float)DAC_ALL_GAIN;
 	clks->h1bh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h1bh.name, "h1bh");
+	clks->h1bh.name = "h1bh";
 
 	clks->h1bl.value = 0;
 	clks->h1bl.reg = DAC_G1_Ch1;
@@ -322,7 +326,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h1bl.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->h1bl.gain = (float)DAC_ALL_GAIN;
 	clks->h1bl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h1bl.name, "h1bl");
+	clks->h1bl.name = "h1bl";
 
 	clks->h2ch.value = 0;
 	clks->h2ch.reg = DAC_G1_Ch2;
@@ -332,7 +336,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h2ch.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->h2ch.gain = (float)DAC_ALL_GAIN;
 	clks->h2ch.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h2ch.name, "h2ch");
+	clks->h2ch.name = "h2ch";
 
 	clks->h2cl.value = 0;
 	clks->h2cl.reg = DAC_G1_Ch3;
@@ -342,7 +346,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h2cl.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->h2cl.gain = (float)DAC_ALL_GAIN;
 	clks->h2cl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h2cl.name, "h2cl");
+	clks->h2cl.name = "h2cl";
 
 	clks->v1bh.value = 0;
 	clks->v1bh.reg = DAC_G1_Ch4;
@@ -352,7 +356,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v1bh.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->v1bh.gain = (float)DAC_VXC_GAIN;
 	clks->v1bh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v1bh.name, "v1bh");
+	clks->v1bh.name = "v1bh";
 
 	clks->v1bl.value = -2;
 	clks->v1bl.reg = DAC_G1_Ch5;
@@ -362,7 +366,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v1bl.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->v1bl.gain = (float)DAC_VXC_GAIN;
 	clks->v1bl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v1bl.name, "v1bl");
+	clks->v1bl.name = "v1bl";
 
 	clks->h3ah.value = 0;
 	clks->h3ah.reg = DAC_G1_Ch6;
@@ -372,7 +376,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h3ah.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->h3ah.gain = (float)DAC_ALL_GAIN;
 	clks->h3ah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h3ah.name, "h3ah");
+	clks->h3ah.name = "h3ah";
 
 	clks->h3al.value = 0;
 	clks->h3al.reg = DAC_G1_Ch7;
@@ -382,7 +386,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h3al.offset = (float)DAC_CH1_OFFSET_DEFAULT;
 	clks->h3al.gain = (float)DAC_ALL_GAIN;
 	clks->h3al.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h3al.name, "h3al");
+	clks->h3al.name = "h3al";
 
 	/*
 	 * DAC Channel 2.
@@ -396,7 +400,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h3bh.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->h3bh.gain = (float)DAC_ALL_GAIN;
 	clks->h3bh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h3bh.name, "h3bh");
+	clks->h3bh.name = "h3bh";
 
 	clks->h3bl.value = 0;
 	clks->h3bl.reg = DAC_G2_Ch1;
@@ -406,7 +410,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->h3bl.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->h3bl.gain = (float)DAC_ALL_GAIN;
 	clks->h3bl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->h3bl.name, "h3bl");
+	clks->h3bl.name = "h3bl";
 
 	clks->swah.value = 0;
 	clks->swah.reg = DAC_G2_Ch2;
@@ -416,7 +420,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->swah.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->swah.gain = (float)DAC_ALL_GAIN;
 	clks->swah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->swah.name, "swah");
+	clks->swah.name = "swah";
 
 	clks->swal.value = 0;
 	clks->swal.reg = DAC_G2_Ch3;
@@ -426,7 +430,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->swal.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->swal.gain = (float)DAC_ALL_GAIN;
 	clks->swal.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->swal.name, "swal");
+	clks->swal.name = "swal";
 
 	clks->swbh.value = 0;
 	clks->swbh.reg = DAC_G2_Ch4;
@@ -436,7 +440,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->swbh.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->swbh.gain = (float)DAC_ALL_GAIN;
 	clks->swbh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->swbh.name, "swbh");
+	clks->swbh.name = "swbh";
 
 	clks->swbl.value = 0;
 	clks->swbl.reg = DAC_G2_Ch5;
@@ -446,7 +450,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->swbl.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->swbl.gain = (float)DAC_ALL_GAIN;
 	clks->swbl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->swbl.name, "swbl");
+	clks->swbl.name = "swbl";
 
 	clks->rgah.value = 0;
 	clks->rgah.reg = DAC_G2_Ch6;
@@ -456,7 +460,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->rgah.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->rgah.gain = (float)DAC_ALL_GAIN;
 	clks->rgah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->rgah.name, "rgah");
+	clks->rgah.name = "rgah";
 
 	clks->rgal.value = 0;
 	clks->rgal.reg = DAC_G2_Ch7;
@@ -466,7 +470,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->rgal.offset = (float)DAC_CH2_OFFSET_DEFAULT;
 	clks->rgal.gain = (float)DAC_ALL_GAIN;
 	clks->rgal.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->rgal.name, "rgal");
+	clks->rgal.name = "rgal";
 
 	/*
 	 * DAC Channel 3.
@@ -479,7 +483,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->rgbh.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->rgbh.gain = (float)DAC_ALL_GAIN;
 	clks->rgbh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->rgbh.name, "rgbh");
+	clks->rgbh.name = "rgbh";
 
 	clks->rgbl.value = 0;
 	clks->rgbl.reg = DAC_G3_Ch1;
@@ -489,7 +493,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->rgbl.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->rgbl.gain = (float)DAC_ALL_GAIN;
 	clks->rgbl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->rgbl.name, "rgbl");
+	clks->rgbl.name = "rgbl";
 
 	clks->ogah.value = 0;
 	clks->ogah.reg = DAC_G3_Ch2;
@@ -499,7 +503,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->ogah.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->ogah.gain = (float)DAC_ALL_GAIN;
 	clks->ogah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->ogah.name, "ogah");
+	clks->ogah.name = "ogah";
 
 	clks->ogal.value = 0;
 	clks->ogal.reg = DAC_G3_Ch3;
@@ -509,7 +513,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->ogal.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->ogal.gain = (float)DAC_ALL_GAIN;
 	clks->ogal.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->ogal.name, "ogal");
+	clks->ogal.name = "ogal";
 
 	clks->ogbh.value = 0;
 	clks->ogbh.reg = DAC_G3_Ch4;
@@ -519,7 +523,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->ogbh.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->ogbh.gain = (float)DAC_ALL_GAIN;
 	clks->ogbh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->ogbh.name, "ogbh");
+	clks->ogbh.name = "ogbh";
 
 	clks->ogbl.value = 0;
 	clks->ogbl.reg = DAC_G3_Ch5;
@@ -529,7 +533,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->ogbl.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->ogbl.gain = (float)DAC_ALL_GAIN;
 	clks->ogbl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->ogbl.name, "ogbl");
+	clks->ogbl.name = "ogbl";
 
 	clks->dgah.value = 0;
 	clks->dgah.reg = DAC_G3_Ch6;
@@ -539,7 +543,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->dgah.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->dgah.gain = (float)DAC_ALL_GAIN;
 	clks->dgah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->dgah.name, "dgah");
+	clks->dgah.name = "dgah";
 
 	clks->dgal.value = 0;
 	clks->dgal.reg = DAC_G3_Ch7;
@@ -549,7 +553,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->dgal.offset = (float)DAC_CH3_OFFSET_DEFAULT;
 	clks->dgal.gain = (float)DAC_ALL_GAIN;
 	clks->dgal.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->dgal.name, "dgal");
+	clks->dgal.name = "dgal";
 
 	/*
 	 * DAC Channel 4.
@@ -563,7 +567,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->tgah.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->tgah.gain = (float)DAC_ALL_GAIN;
 	clks->tgah.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->tgah.name, "tgah");
+	clks->tgah.name = "tgah";
 
 	clks->tgal.value = 0;
 	clks->tgal.reg = DAC_G4_Ch1;
@@ -573,7 +577,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->tgal.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->tgal.gain = (float)DAC_ALL_GAIN;
 	clks->tgal.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->tgal.name, "tgal");
+	clks->tgal.name = "tgal";
 
 	clks->tgbh.value = 0;
 	clks->tgbh.reg = DAC_G4_Ch2;
@@ -583,7 +587,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->tgbh.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->tgbh.gain = (float)DAC_ALL_GAIN;
 	clks->tgbh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->tgbh.name, "tgbh");
+	clks->tgbh.name = "tgbh";
 
 	clks->tgbl.value = 0;
 	clks->tgbl.reg = DAC_G4_Ch3;
@@ -593,7 +597,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->tgbl.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->tgbl.gain = (float)DAC_ALL_GAIN;
 	clks->tgbl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->tgbl.name, "tgbl");
+	clks->tgbl.name = "tgbl";
 
 	clks->v3bh.value = 0;
 	clks->v3bh.reg = DAC_G4_Ch4;
@@ -603,7 +607,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v3bh.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->v3bh.gain = (float)DAC_VXC_GAIN;
 	clks->v3bh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v3bh.name, "v3bh");
+	clks->v3bh.name = "v3bh";
 
 	clks->v3bl.value = 0;
 	clks->v3bl.reg = DAC_G4_Ch5;
@@ -613,7 +617,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->v3bl.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->v3bl.gain = (float)DAC_VXC_GAIN;
 	clks->v3bl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->v3bl.name, "v3bl");
+	clks->v3bl.name = "v3bl";
 
 
 	clks->dgbh.value = 0;
@@ -624,7 +628,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->dgbh.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->dgbh.gain = (float)DAC_ALL_GAIN;
 	clks->dgbh.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->dgbh.name, "dgbh");
+	clks->dgbh.name = "dgbh";
 
 	clks->dgbl.value = 0;
 	clks->dgbl.reg = DAC_G4_Ch7;
@@ -634,7 +638,7 @@ int dac_init(clk_sw_t * clk_sw, clk_group_status_t *clks, uint32_t spi_device_id
 	clks->dgbl.offset = (float)DAC_CH4_OFFSET_DEFAULT;
 	clks->dgbl.gain = (float)DAC_ALL_GAIN;
 	clks->dgbl.max_code = (float)(1 << DAC_BITS);
-	strcpy(clks->dgbl.name, "dgbl");
+	clks->dgbl.name = "dgbl";
 
 
 	//initialize offset groups
@@ -694,13 +698,13 @@ int dac_read(uint16_t reg_addr, uint8_t *reg_data, uint16_t n)
 	buf[2] = 0x00;
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_dac_i, 1);
+	ret = spi_trace_select(&spi_dac_i, 1);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
 
 	// Send/Receive data,
-	return XSpi_Transfer(&spi_dac_i, buf, reg_data, n);
+	return spi_trace_transfer(&spi_dac_i, buf, reg_data, n);
 }
 
 int dac_read_xcm(uint16_t addr_base, uint16_t channel, uint16_t *data)
@@ -710,7 +714,7 @@ int dac_read_xcm(uint16_t addr_base, uint16_t channel, uint16_t *data)
 	int ret;
 
 	// Set slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_dac_i, 1);
+	ret = spi_trace_select(&spi_dac_i, 1);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
@@ -735,7 +739,7 @@ int dac_read_xcm(uint16_t addr_base, uint16_t channel, uint16_t *data)
 	buf[2] = (addr & DAC_DATA_LOW_MASK);
 
 	// Send command.
-	ret = XSpi_Transfer(&spi_dac_i, buf, NULL, 3);
+	ret = spi_trace_transfer(&spi_dac_i, buf, NULL, 3);
 
 	// If Transfer was successfully completed, go ahead.
 	if (ret != XST_SUCCESS ) {
@@ -744,7 +748,7 @@ int dac_read_xcm(uint16_t addr_base, uint16_t channel, uint16_t *data)
 
 	// Retrieve data by sending nop command.
 	buf[0] = DAC_cmd_nop;
-	ret = XSpi_Transfer(&spi_dac_i, buf, buf, 3);
+	ret = spi_trace_transfer(&spi_dac_i, buf, buf, 3);
 
 	*data = (buf[1] << 8) + buf[2];
 
@@ -789,12 +793,12 @@ int dac_write(uint8_t reg_mode, uint8_t reg_addr , uint16_t reg_data)
 			//buf[2] = (uint8_t)data;
 			buf[2] = (uint8_t)(data & 0xFF);
 
-			ret = XSpi_SetSlaveSelect(&spi_dac_i, 1);
+			ret = spi_trace_select(&spi_dac_i, 1);
 			if (ret != XST_SUCCESS) {
 				return ret;
 			}
 
-			return XSpi_Transfer(&spi_dac_i, buf, NULL, 3);
+			return spi_trace_transfer(&spi_dac_i, buf, NULL, 3);
 		}
 	}
 
@@ -813,7 +817,7 @@ int dac_write_sf(uint8_t cmd , clk_status_t *clk)
 
 
 	// Set slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_dac_i, 1);
+	ret = spi_trace_select(&spi_dac_i, 1);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
@@ -825,7 +829,7 @@ int dac_write_sf(uint8_t cmd , clk_status_t *clk)
 			buf[0] = 0x00;
 			buf[1] = 0x00;
 			buf[2] = 0x00;
-			return XSpi_Transfer(&spi_dac_i, buf, NULL, 3);
+			return spi_trace_transfer(&spi_dac_i, buf, NULL, 3);
 
 		case DAC_cmd_Reg2read:
 			break;
@@ -835,7 +839,7 @@ int dac_write_sf(uint8_t cmd , clk_status_t *clk)
 			buf[0] = DAC_cmd_WCR;
 			buf[1] = 0xFF;
 			buf[2] = (uint8_t)data & 0xE7;
-			return XSpi_Transfer(&spi_dac_i, buf, NULL, 3);
+			return spi_trace_transfer(&spi_dac_i, buf, NULL, 3);
 
 		case DAC_cmd_OFS0:
 		case DAC_cmd_OFS1:
@@ -850,7 +854,7 @@ int dac_write_sf(uint8_t cmd , clk_status_t *clk)
 			buf[0] = cmd;
 			buf[1] = (data >> 8);
 			buf[2] = (uint8_t)data;
-			return XSpi_Transfer(&spi_dac_i, buf, NULL, 3);
+			return spi_trace_transfer(&spi_dac_i, buf, NULL, 3);
 
 		default:
 			xil_printf("Not Valid Command \n\r");
@@ -15,6 +15,20 @@
 // XGpio device driver variables.
 XGpio gpio_eth_i;
 
+// Pending eth_sdata_put_bin_async.
+static struct {
+	const uint8_t *data;
+	uint32_t length;
+	uint32_t idx;
+	int state;
+	int failed;
+	uint32_t t0;
+} eth_async;
+
+#define ETH_ASYNC_IDLE				0
+#define ETH_ASYNC_WAIT_ACK			1
+#define ETH_ASYNC_WAIT_RELEASE		2
+
 int eth_init(uint32_t gpio_device_id, eth_t *eth)
 {
 	int ret;
@@ -29,7 +43,7 @@ int eth_init(uint32_t gpio_device_id, eth_t *eth)
 	XGpio_SetDataDirection(&gpio_eth_i, 1, 0x0);
 
 	// Initialize structure.
-	strcpy(eth->ipEth.name, "ipEth");
+	eth->ipEth.name = "ipEth";
 	eth->ipEth.min = ETH_IP_MIN;
 	eth->ipEth.max = ETH_IP_MAX;
 	eth->ipEth.val = ETH_IP_DEFAULT;
@@ -112,6 +126,9 @@ unsigned int eth_mdata_get(uint8_t *buf)
 
 void eth_sdata_put( const char *str )
 {
+	// The mailbox may still hold an async chunk.
+	eth_sdata_async_wait();
+
 	// Copy data into memory.
 	strcpy(eth_sdata->data, str);
 
@@ -119,6 +136,50 @@ void eth_sdata_put( const char *str )
 	uint32_t l = strlen(str);
 	eth_sbus->dlength = l;
 
+	// Hand data over to the master.
+	eth_sdata_handshake();
+
+	return;
+}
+
+void eth_sdata_put_bin(const uint8_t *data, uint32_t length)
+{
+	uint32_t idx = 0;
+
+	eth_sdata_async_wait();
+
+	// Send data in chunks of the mailbox size.
+	while (idx < length)
+	{
+		uint32_t l = length - idx;
+		if (l > ETH_MAX_DATALENGTH)
+		{
+			l = ETH_MAX_DATALENGTH;
+		}
+
+		// Copy data into memory.
+		for (uint32_t i=0; i<l; i++)
+		{
+			eth_sdata->data[i] = data[idx+i];
+		}
+
+		// Set length.
+		eth_sbus->dlength = l;
+
+		// Hand data over to the master.
+		if (eth_sdata_handshake() != 0)
+		{
+			return;
+		}
+
+		idx += l;
+	}
+
+	return;
+}
+
+int eth_sdata_handshake(void)
+{
 	// Set dready.
 	eth_sbus->dready = 0x78787878;
 
@@ -144,7 +205,7 @@ void eth_sdata_put( const char *str )
 		// Clear dready and return.
 		eth_sbus->dready = 0xCDCDCDCD;
 
-		return;
+		return -1;
 	}
 
 	// Clear dready.
@@ -172,13 +233,102 @@ void eth_sdata_put( const char *str )
 		// Clear dready and return.
 		eth_sbus->dready = 0xCDCDCDCD;
 
-		return;
+		return -1;
 	}
 
 	// Clear dready.
 	eth_sbus->dready = 0xCDCDCDCD;
 
-	return;
+	return 0;
+}
+
+// Next chunk into the mailbox, dready up.
+static void eth_async_chunk(void)
+{
+	uint32_t l = eth_async.length - eth_async.idx;
+	if (l > ETH_MAX_DATALENGTH)
+	{
+		l = ETH_MAX_DATALENGTH;
+	}
+
+	for (uint32_t i=0; i<l; i++)
+	{
+		eth_sdata->data[i] = eth_async.data[eth_async.idx+i];
+	}
+	eth_sbus->dlength = l;
+	eth_async.idx += l;
+
+	eth_async.t0 = tget_ms();
+	eth_async.state = ETH_ASYNC_WAIT_ACK;
+	eth_sbus->dready = 0x78787878;
+}
+
+// Same handshake as eth_sdata_handshake, one step per call.
+static void eth_async_step(void)
+{
+	if (eth_async.state != ETH_ASYNC_IDLE && (tget_ms() - eth_async.t0) >= ETH_HANDSHAKE_TIMEOUT_MS)
+	{
+		eth_sbus->dack = 0xEFEFEFEF;
+		eth_sbus->dready = 0xCDCDCDCD;
+		eth_async.state = ETH_ASYNC_IDLE;
+		eth_async.failed = 1;
+	}
+	else if (eth_async.state == ETH_ASYNC_WAIT_ACK && eth_sbus->dack == 0xABABABAB)
+	{
+		eth_sbus->dready = 0xCDCDCDCD;
+		eth_async.t0 = tget_ms();
+		eth_async.state = ETH_ASYNC_WAIT_RELEASE;
+	}
+	else if (eth_async.state == ETH_ASYNC_WAIT_RELEASE && eth_sbus->dack == 0xEFEFEFEF)
+	{
+		eth_sbus->dready = 0xCDCDCDCD;
+		eth_async.state = ETH_ASYNC_IDLE;
+		if (eth_async.idx < eth_async.length)
+		{
+			eth_async_chunk();
+		}
+	}
+}
+
+int eth_sdata_put_bin_async(const uint8_t *data, uint32_t length)
+{
+	eth_async_step();
+	if (eth_async.state != ETH_ASYNC_IDLE)
+	{
+		return -1;
+	}
+
+	eth_async.data 		= data;
+	eth_async.length 	= length;
+	eth_async.idx 		= 0;
+	eth_async_chunk();
+
+	return 0;
+}
+
+int eth_sdata_async_poll(void)
+{
+	int failed;
+
+	eth_async_step();
+	if (eth_async.state != ETH_ASYNC_IDLE)
+	{
+		return 1;
+	}
+
+	failed = eth_async.failed;
+	eth_async.failed = 0;
+
+	return failed ? -1 : 0;
+}
+
+void eth_sdata_async_wait(void)
+{
+	// A failure is kept for the owner's next poll.
+	while (eth_async.state != ETH_ASYNC_IDLE)
+	{
+		eth_async_step();
+	}
 }
 
 void eth_uint2ip(uint32_t ip, char *str)
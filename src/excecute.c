@@ -18,6 +18,19 @@
 #include "excecute.h"
 #include "io_func.h"
 #include "flash.h"
+#include "snapshot.h"
+#include "profile.h"
+#include "smart_buffer_cal.h"
+#include "interrupt.h"
+#include "interlock.h"
+#include "telemetry_stream.h"
+#include "flash_prog.h"
+#include "script.h"
+#include "acq.h"
+#include "sync_align.h"
+#include "fr_mon.h"
+#include "perf.h"
+#include "spi_trace.h"
 
 
 int excecute_interpret(system_state_t *sys, char *userWord, char *errStr)
@@ -27,6 +40,9 @@ int excecute_interpret(system_state_t *sys, char *userWord, char *errStr)
 	char *token;
 	char *rest;
 
+	perf_start();
+	spi_trace_command();
+
 	rest = userWord;
 	// walk through other tokens
 	int wordInd = 0;
@@ -39,6 +55,8 @@ int excecute_interpret(system_state_t *sys, char *userWord, char *errStr)
 	free(token);
 	free(rest);
 
+	perf_parsed((wordInd > 0) ? commandWord[0].word : "");
+
    switch(wordInd){
    case NO_WORD:
 	   io_sprintf(errStr, "Not a valid command\r\n");
@@ -70,6 +88,59 @@ int excecute_interpret(system_state_t *sys, char *userWord, char *errStr)
 	   		return excecute_get(sys, commandWord[1].word, errStr);
 	   	}
 
+	   // script <name>: record the lines that follow, until end.
+	   else if (strcmp(commandWord[0].word,"script")==0)
+	   {
+		   if (script_record_start(commandWord[1].word) != 0)
+		   {
+			   io_sprintf(errStr, "### Can not record script %s\r\n", commandWord[1].word);
+			   return -1;
+		   }
+		   return 0;
+	   }
+
+	   // run <name>.
+	   else if (strcmp(commandWord[0].word,"run")==0)
+	   {
+		   if (script_run(commandWord[1].word, NULL, NULL) != 0)
+		   {
+			   io_sprintf(errStr, "### Can not run script %s\r\n", commandWord[1].word);
+			   return -1;
+		   }
+		   return 0;
+	   }
+
+	   // stop script.
+	   else if ( (strcmp(commandWord[0].word,"stop")==0) && (strcmp(commandWord[1].word,"script")==0) )
+	   {
+		   script_stop();
+		   return 0;
+	   }
+
+	   // reset perf.
+	   else if ( (strcmp(commandWord[0].word,"reset")==0) && (strcmp(commandWord[1].word,"perf")==0) )
+	   {
+		   perf_reset();
+		   return 0;
+	   }
+
+	   // start|stop spitrace, reset spi.
+	   else if ( (strcmp(commandWord[0].word,"start")==0) && (strcmp(commandWord[1].word,"spitrace")==0) )
+	   {
+		   spi_trace_start();
+		   return 0;
+	   }
+	   else if ( (strcmp(commandWord[0].word,"stop")==0) && (strcmp(commandWord[1].word,"spitrace")==0) )
+	   {
+		   spi_trace_stop();
+		   return 0;
+	   }
+	   else if ( (strcmp(commandWord[0].word,"reset")==0) && (strcmp(commandWord[1].word,"spi")==0) )
+	   {
+		   spi_trace_reset();
+		   return 0;
+	   }
+
 	   // exec command.
 	   else if (strcmp(commandWord[0].word,"exec")==0)
 	   {
@@ -105,6 +176,62 @@ int excecute_interpret(system_state_t *sys, char *userWord, char *errStr)
 		   }
 		   return status;
 	   }
+
+	   // run <name> <arg1>.
+	   else if (strcmp(commandWord[0].word,"run")==0)
+	   {
+		   if (script_run(commandWord[1].word, commandWord[2].word, NULL) != 0)
+		   {
+			   io_sprintf(errStr, "### Can not run script %s\r\n", commandWord[1].word);
+			   return -1;
+		   }
+		   return 0;
+	   }
+
+	   // delete script <name>.
+	   else if ( (strcmp(commandWord[0].word,"delete")==0) && (strcmp(commandWord[1].word,"script")==0) )
+	   {
+		   if (script_delete(commandWord[2].word) != 0)
+		   {
+			   io_sprintf(errStr, "### Can not delete script %s\r\n", commandWord[2].word);
+			   return -1;
+		   }
+		   return 0;
+	   }
+
+	   // Configuration profiles.
+	   else if (strcmp(commandWord[1].word,"profile")==0)
+	   {
+		   if (strcmp(commandWord[0].word,"save")==0)
+		   {
+			   if (profile_save(sys, commandWord[2].word) != 0)
+			   {
+				   io_sprintf(errStr, "### Could not save profile %s\r\n", commandWord[2].word);
+				   return -1;
+			   }
+			   return 0;
+		   }
+		   else if (strcmp(commandWord[0].word,"load")==0)
+		   {
+			   if (profile_load(sys, commandWord[2].word) != 0)
+			   {
+				   io_sprintf(errStr, "### Could not load profile %s\r\n", commandWord[2].word);
+				   return -1;
+			   }
+			   return 0;
+		   }
+		   else if (strcmp(commandWord[0].word,"delete")==0)
+		   {
+			   if (profile_delete(commandWord[2].word) != 0)
+			   {
+				   io_sprintf(errStr, "### Could not delete profile %s\r\n", commandWord[2].word);
+				   return -1;
+			   }
+			   return 0;
+		   }
+		   io_sprintf(errStr, "Invalid command: %s %s %s\r\n",commandWord[0].word,commandWord[1].word,commandWord[2].word);
+		   return -1;
+	   }
 	   else
 	   {
 		   io_sprintf(errStr, "Invalid command: %s %s %s\r\n",commandWord[0].word,commandWord[1].word,commandWord[2].word);
@@ -128,12 +255,65 @@ int excecute_interpret(system_state_t *sys, char *userWord, char *errStr)
 				}
 				return status;
 			}
+			// set ilkmin|ilkmax|ilkrule <source> <value>.
+			else if (	(strcmp(commandWord[1].word,"ilkmin")==0) ||
+						(strcmp(commandWord[1].word,"ilkmax")==0) ||
+						(strcmp(commandWord[1].word,"ilkrule")==0) )
+			{
+				int status = interlock_set_rule(sys, commandWord[1].word, commandWord[2].word, atof(commandWord[3].word));
+				if (status != 0)
+				{
+					io_sprintf(errStr, "### No interlock for %s\r\n", commandWord[2].word);
+				}
+				return status;
+			}
 			else
 			{
 				io_sprintf(errStr, "Invalid command: %s %s %s %s\r\n",commandWord[0].word,commandWord[1].word,commandWord[2].word,commandWord[3].word);
 				return -1;
 			}
 		}
+
+		// run <name> <arg1> <arg2>.
+		else if (strcmp(commandWord[0].word,"run")==0)
+		{
+			if (script_run(commandWord[1].word, commandWord[2].word, commandWord[3].word) != 0)
+			{
+				io_sprintf(errStr, "### Can not run script %s\r\n", commandWord[1].word);
+				return -1;
+			}
+			return 0;
+		}
+
+		// flash_prog <addr> <length> <crc>.
+		else if (strcmp(commandWord[0].word,"flash_prog")==0)
+		{
+			int status = flash_prog_start(	str2num(commandWord[1].word),
+											str2num(commandWord[2].word),
+											str2num(commandWord[3].word));
+			if (status == -1)
+			{
+				io_sprintf(errStr, "### Bad range: address must be 4 kB aligned, range below 0x%x\r\n", FLASH_PROG_END_ADDR);
+			}
+			else if (status != 0)
+			{
+				io_sprintf(errStr, "### Flash: erase failed\r\n");
+			}
+			return (status == 0) ? 0 : -1;
+		}
+
+		// get telemetry hist <variable>.
+		else if ( 	(strcmp(commandWord[0].word,"get")==0) &&
+					(strcmp(commandWord[1].word,"telemetry")==0) &&
+					(strcmp(commandWord[2].word,"hist")==0) )
+		{
+			int status = excecute_get_telemetry_hist(sys, commandWord[3].word);
+			if (status != 0)
+			{
+				io_sprintf(errStr, "### No history for %s\r\n", commandWord[3].word);
+			}
+			return status;
+		}
 		else
 	   	{
 			io_sprintf(errStr, "Invalid command: %s %s %s %s\r\n",commandWord[0].word,commandWord[1].word,commandWord[2].word,commandWord[3].word);
@@ -158,11 +338,35 @@ void excecute_help(system_state_t *sys)
 	mprint("-> set <variable> <value>\r\n");
 	mprint("-> get <variable>\r\n");
 	mprint("-> get all\r\n");
+	mprint("-> get snapshot\r\n");
+	mprint("-> get profiles\r\n");
+	mprint("-> save|load|delete profile <name>\r\n");
+	mprint("-> script <name>, then the lines and end\r\n");
+	mprint("-> run <name> [arg1] [arg2]\r\n");
+	mprint("-> stop script\r\n");
+	mprint("-> delete script <name>\r\n");
+	mprint("-> get scripts\r\n");
+	mprint("-> get acq\r\n");
+	mprint("-> get sync\r\n");
+	mprint("-> get frmon\r\n");
+	mprint("-> get frhist\r\n");
+	mprint("-> get perf\r\n");
+	mprint("-> reset perf\r\n");
+	mprint("-> get spi\r\n");
+	mprint("-> get spitrace\r\n");
+	mprint("-> start|stop spitrace\r\n");
+	mprint("-> reset spi\r\n");
+	mprint("-> get uart\r\n");
+	mprint("-> get interlock\r\n");
+	mprint("-> set ilkmin|ilkmax|ilkrule <telemetry variable> <value>\r\n");
 	mprint("-> get telemetry <variable>\r\n");
 	mprint("-> get telemetry help\r\n");
 	mprint("-> get telemetry all\r\n");
+	mprint("-> get telemetry stats\r\n");
+	mprint("-> get telemetry hist <variable>\r\n");
 	mprint("-> exec <function>\r\n");
 	mprint("-> exec help\r\n");
+	mprint("-> flash_prog <addr> <length> <crc>, then the data in hex\r\n");
 	mprint("\r\n");
 }
 
@@ -280,16 +484,18 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	int nPacker_sw = sizeof(packer_sw_group_status_t)/sizeof(packer_sw_status_t);
 	for(int i = 0; i < nPacker_sw; i++)
 	{
+		const char *name = packer_reg_name(packer_sw);
+
 		if (flag_all)
 		{
 		 	// Print value.
-		 	io_sprintf(str, "%s = %d\r\n", packer_sw->name, packer_sw->status);
+		 	io_sprintf(str, "%s = %d\r\n", name, packer_sw->value);
 		 	mprint(str);
 		}
-		else if (strcmp(varID, packer_sw->name)==0)
+		else if (strcmp(varID, name)==0)
 		{
 		 	// Print value.
-		 	io_sprintf(str, "%s = %d\r\n", packer_sw->name, packer_sw->status);
+		 	io_sprintf(str, "%s = %d\r\n", name, packer_sw->value);
 		 	mprint(str);
 
 		 	return 0;
@@ -346,22 +552,52 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	}
 	if (flag_all) mprint("\r\n");
 
+	// Acquisition runs.
+	if (flag_all) mprint("### Acquisition ###\r\n");
+	acq_var_t *acq_var = (acq_var_t *) &(sys->acq.vars);
+	int nAcq = sizeof(acq_group_status_t)/sizeof(acq_var_t);
+	for(int i = 0; i < nAcq; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %u\r\n", acq_var->name, acq_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, acq_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %u\r\n", acq_var->name, acq_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		acq_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
 	// Correlated Double Sampling.
 	if (flag_all) mprint("### Correlated Double Sampling ###\r\n");
 	cds_var_status_t *cds_var = (cds_var_status_t *) &(sys->cds);
-	int nCds_var = sizeof(cds_var_group_status_t)/sizeof(cds_var_status_t);
+	int nCds_var = sizeof(cds_t)/sizeof(cds_var_status_t);
 	for(int i = 0; i < nCds_var; i++)
 	{
+		// Print value, an alias over channels that differ has none.
+		if (cds_var->mixed)
+		{
+			io_sprintf(str, "%s = mixed\r\n", cds_var->name);
+		}
+		else
+		{
+			io_sprintf(str, "%s = %d\r\n", cds_var->name, cds_var->value);
+		}
+
 		if (flag_all)
 		{
-		 	// Print value.
-		 	io_sprintf(str, "%s = %d\r\n", cds_var->name, cds_var->value);
 		 	mprint(str);
 		}
 		else if (strcmp(varID, cds_var->name)==0)
 		{
-		 	// Print value.
-		 	io_sprintf(str, "%s = %d\r\n", cds_var->name, cds_var->value);
 		 	mprint(str);
 
 		 	return 0;
@@ -424,16 +660,18 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	int nSmartBuf = sizeof(smart_buffer_group_status_t)/sizeof(smart_buffer_status_t);
 	for(int i = 0; i < nSmartBuf; i++)
 	{
+		const char *name = smart_buffer_reg_name(smart_buffer_var);
+
 		if (flag_all)
 		{
 			// Print value.
-			io_sprintf(str, "%s = %d\r\n", smart_buffer_var->name, smart_buffer_var->value);
+			io_sprintf(str, "%s = %d\r\n", name, smart_buffer_var->value);
 			mprint(str);
 		}
-		else if (strcmp(varID, smart_buffer_var->name)==0)
+		else if (strcmp(varID, name)==0)
 		{
 			// Print value.
-			io_sprintf(str, "%s = %d\r\n", smart_buffer_var->name, smart_buffer_var->value);
+			io_sprintf(str, "%s = %d\r\n", name, smart_buffer_var->value);
 			mprint(str);
 
 			return 0;
@@ -442,6 +680,150 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	}
 	if (flag_all) mprint("\r\n");
 
+	// Smart buffer streaming.
+	if (flag_all) mprint("### Smart Buffer Stream ###\r\n");
+	smart_buffer_var_t *stream_var = (smart_buffer_var_t *) &(sys->smart_buffer_stream.vars);
+	int nStream = sizeof(smart_buffer_stream_group_status_t)/sizeof(smart_buffer_var_t);
+	for(int i = 0; i < nStream; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", stream_var->name, stream_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, stream_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", stream_var->name, stream_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		stream_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
+	// Smart buffer trigger.
+	if (flag_all) mprint("### Smart Buffer Trigger ###\r\n");
+	smart_buffer_var_t *trig_var = (smart_buffer_var_t *) &(sys->smart_buffer_trig.vars);
+	int nTrig = sizeof(smart_buffer_trig_group_status_t)/sizeof(smart_buffer_var_t);
+	for(int i = 0; i < nTrig; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", trig_var->name, trig_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, trig_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", trig_var->name, trig_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		trig_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
+	// Smart buffer speed calibration.
+	if (flag_all) mprint("### Smart Buffer Calibration ###\r\n");
+	smart_buffer_var_t *cal_var = (smart_buffer_var_t *) &(sys->smart_buffer_cal.vars);
+	int nCal = sizeof(smart_buffer_cal_group_status_t)/sizeof(smart_buffer_var_t);
+	for(int i = 0; i < nCal; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", cal_var->name, cal_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, cal_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", cal_var->name, cal_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		cal_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
+	// Telemetry scanner.
+	if (flag_all) mprint("### Telemetry Scanner ###\r\n");
+	telemetry_var_t *scan_var = (telemetry_var_t *) &(sys->telemetry_scan.vars);
+	int nScan = sizeof(telemetry_scan_group_status_t)/sizeof(telemetry_var_t);
+	for(int i = 0; i < nScan; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", scan_var->name, scan_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, scan_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", scan_var->name, scan_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		scan_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
+	// Telemetry frames.
+	if (flag_all) mprint("### Telemetry Stream ###\r\n");
+	telemetry_var_t *tstrm_var = (telemetry_var_t *) &(sys->telemetry_stream.vars);
+	int nTStrm = sizeof(telemetry_stream_group_status_t)/sizeof(telemetry_var_t);
+	for(int i = 0; i < nTStrm; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", tstrm_var->name, tstrm_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, tstrm_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", tstrm_var->name, tstrm_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		tstrm_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
+	// Interlocks.
+	if (flag_all) mprint("### Interlocks ###\r\n");
+	telemetry_var_t *ilk_var = (telemetry_var_t *) &(sys->interlock.vars);
+	int nIlk = sizeof(interlock_group_status_t)/sizeof(telemetry_var_t);
+	for(int i = 0; i < nIlk; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", ilk_var->name, ilk_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, ilk_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %d\r\n", ilk_var->name, ilk_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		ilk_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
 	// Ethernet.
 	if (flag_all) mprint("### Ethernet ###\r\n");
 	eth_status_t *eth_var = (eth_status_t *) &(sys->eth);
@@ -472,22 +854,24 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	int nMstSel = sizeof(master_sel_t)/sizeof(master_sel_status_t);
 	for(int i = 0; i < nMstSel; i++)
 	{
+		const char *name = master_sel_reg_name(master_sel_var);
+
 		if (flag_all)
 		{
 			// Update value from hadrware.
 			master_sel_update_reg(master_sel_var);
 
 			// Print value.
-			io_sprintf(str, "%s = %d\r\n", master_sel_var->name, master_sel_var->value);
+			io_sprintf(str, "%s = %d\r\n", name, master_sel_var->value);
 			mprint(str);
 		}
-		else if (strcmp(varID, master_sel_var->name)==0)
+		else if (strcmp(varID, name)==0)
 		{
 			// Update value from hadrware.
 			master_sel_update_reg(master_sel_var);
 
 			// Print value.
-			io_sprintf(str, "%s = %d\r\n", master_sel_var->name, master_sel_var->value);
+			io_sprintf(str, "%s = %d\r\n", name, master_sel_var->value);
 			mprint(str);
 
 			return 0;
@@ -503,16 +887,18 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	int nSyncGen = sizeof(sync_gen_t)/sizeof(sync_gen_status_t);
 	for(int i = 0; i < nSyncGen; i++)
 	{
+		const char *name = sync_gen_reg_name(sync_gen_var);
+
 		if (flag_all)
 		{
 			// Print value.
-			io_sprintf(str, "%s = %d\r\n", sync_gen_var->name, sync_gen_var->value);
+			io_sprintf(str, "%s = %d\r\n", name, sync_gen_var->value);
 			mprint(str);
 		}
-		else if (strcmp(varID, sync_gen_var->name)==0)
+		else if (strcmp(varID, name)==0)
 		{
 			// Print value.
-			io_sprintf(str, "%s = %d\r\n", sync_gen_var->name, sync_gen_var->value);
+			io_sprintf(str, "%s = %d\r\n", name, sync_gen_var->value);
 			mprint(str);
 
 			return 0;
@@ -521,6 +907,30 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	}
 	if (flag_all) mprint("\r\n");
 
+	// Synchronized start.
+	if (flag_all) mprint("### Sync Alignment ###\r\n");
+	sync_align_var_t *sync_align_var = (sync_align_var_t *) &(sys->sync_align.vars);
+	int nSyncAlign = sizeof(sync_align_group_status_t)/sizeof(sync_align_var_t);
+	for(int i = 0; i < nSyncAlign; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %u\r\n", sync_align_var->name, sync_align_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, sync_align_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %u\r\n", sync_align_var->name, sync_align_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		sync_align_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
 
 	// Frequency Measurement.
 	if (flag_all) mprint("### Frequency Measurement ###\r\n");
@@ -528,22 +938,24 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	int nFrMeas = sizeof(fr_meas_t)/sizeof(fr_meas_status_t);
 	for(int i = 0; i < nFrMeas; i++)
 	{
+		const char *name = fr_meas_reg_name(fr_meas_var);
+
 		if (flag_all)
 		{
 			// Update value from hadrware.
 			fr_meas_update_reg(fr_meas_var);
 
 			// Print value.
-			io_sprintf(str, "%s = %d kHz\r\n", fr_meas_var->name, fr_meas_var->value);
+			io_sprintf(str, "%s = %d kHz\r\n", name, fr_meas_var->value);
 			mprint(str);
 		}
-		else if (strcmp(varID, fr_meas_var->name)==0)
+		else if (strcmp(varID, name)==0)
 		{
 			// Update value from hadrware.
 			fr_meas_update_reg(fr_meas_var);
 
 			// Print value.
-			io_sprintf(str, "%s = %d kHz\r\n", fr_meas_var->name, fr_meas_var->value);
+			io_sprintf(str, "%s = %d kHz\r\n", name, fr_meas_var->value);
 			mprint(str);
 
 			return 0;
@@ -552,6 +964,30 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 	}
 	if (flag_all) mprint("\r\n");
 
+	// Clock monitor.
+	if (flag_all) mprint("### Clock Monitor ###\r\n");
+	fr_mon_var_t *fr_mon_var = (fr_mon_var_t *) &(sys->fr_mon.vars);
+	int nFrMon = sizeof(fr_mon_group_status_t)/sizeof(fr_mon_var_t);
+	for(int i = 0; i < nFrMon; i++)
+	{
+		if (flag_all)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %u\r\n", fr_mon_var->name, fr_mon_var->value);
+			mprint(str);
+		}
+		else if (strcmp(varID, fr_mon_var->name)==0)
+		{
+			// Print value.
+			io_sprintf(str, "%s = %u\r\n", fr_mon_var->name, fr_mon_var->value);
+			mprint(str);
+
+			return 0;
+		}
+		fr_mon_var++;
+	}
+	if (flag_all) mprint("\r\n");
+
 	// Get sequencer in RAM.
 	if (strcmp(varID,"seq")==0)
 	{
@@ -568,6 +1004,91 @@ int excecute_get(system_state_t *sys, const char *varID, char *errStr) {
 		return 0;
 	}
 
+	// Interlock rules.
+	if (strcmp(varID,"interlock")==0)
+	{
+		interlock_print(sys);
+		return 0;
+	}
+
+	// Clock monitor history, as text or binary.
+	if (strcmp(varID,"frmon")==0)
+	{
+		fr_mon_print(&(sys->fr_mon));
+		return 0;
+	}
+	if (strcmp(varID,"frhist")==0)
+	{
+		fr_mon_send(&(sys->fr_mon));
+		return 0;
+	}
+
+	// Command latency.
+	if (strcmp(varID,"perf")==0)
+	{
+		perf_print();
+		return 0;
+	}
+
+	// SPI traffic per device, and the trace in binary.
+	if (strcmp(varID,"spi")==0)
+	{
+		spi_trace_print();
+		return 0;
+	}
+	if (strcmp(varID,"spitrace")==0)
+	{
+		spi_trace_send();
+		return 0;
+	}
+
+	// Console UART counters.
+	if (strcmp(varID,"uart")==0)
+	{
+		uart_print();
+		return 0;
+	}
+
+	// Synchronized start report.
+	if (strcmp(varID,"sync")==0)
+	{
+		sync_align_print(sys);
+		return 0;
+	}
+
+	// Timing of the acquisition run.
+	if (strcmp(varID,"acq")==0)
+	{
+		acq_print(&(sys->acq));
+		return 0;
+	}
+
+	// Stored scripts.
+	if (strcmp(varID,"scripts")==0)
+	{
+		script_list();
+		return 0;
+	}
+
+	// Stored configuration profiles.
+	if (strcmp(varID,"profiles")==0)
+	{
+		profile_list();
+		return 0;
+	}
+
+	// Binary snapshot of all variables.
+	if (strcmp(varID,"snapshot")==0)
+	{
+		if (snapshot_send(sys) != 0)
+		{
+			io_sprintf(errStr, "### Snapshot does not fit in buffer\r\n");
+			return -1;
+		}
+
+		return 0;
+	}
+
 	if (strcmp(varID,"b")==0)
 	{
 		mprint("\n\r\n\rriBer es de la B!!! ...esa mancha no se borra...\n\r\n\r");
@@ -615,19 +1136,50 @@ int excecute_get_telemetry(system_state_t *sys, const char *varID) {
 		mprint("### Telemetry values ###\r\n");
 		char str[50];
 		int i;
-		float value;
+		float values[TELEMETRY_NSOURCES];
+		int status[TELEMETRY_NSOURCES];
+
+		telemetry_scan_read_all(&(sys->telemetry_scan), &(sys->telemetry), values, status);
 
 		telemetry_source_t *src = (telemetry_source_t*) &(sys->telemetry);
 		int n = sizeof(telemetry_group_t)/sizeof(telemetry_source_t);
 		for (i=0; i<n; i++)
 		{
-			ret = telemetry_read(src, &value);
-			if (ret == 0)
+			if (status[i] == 0)
 			{
-				io_sprintf(str, "%s = %f\r\n", src->name, value);
+				io_sprintf(str, "%s = %f\r\n", src->name, values[i]);
 				mprint(str);
-				src++;
 			}
+			src++;
+		}
+		ret = 0;
+	}
+
+	// stats: cached value, min, max and age of every source.
+	else if (strcmp(varID,"stats") == 0)
+	{
+		if (sys->telemetry_scan.vars.enable.value == TELEMETRY_SCAN_OFF)
+		{
+			return -1;
+		}
+
+		mprint("### Telemetry statistics ###\r\n");
+		char str[100];
+		int i;
+		uint32_t now = tget_ms();
+
+		telemetry_source_t *src = (telemetry_source_t*) &(sys->telemetry);
+		int n = sizeof(telemetry_group_t)/sizeof(telemetry_source_t);
+		for (i=0; i<n; i++)
+		{
+			telemetry_cache_t *cache = telemetry_scan_get(&(sys->telemetry_scan), &(sys->telemetry), src);
+			if (cache != NULL)
+			{
+				io_sprintf(str, "%s = %f min %f max %f age %d ms errors %d\r\n",
+						src->name, cache->value, cache->min, cache->max, now - cache->tstamp, cache->nerr);
+				mprint(str);
+			}
+			src++;
 		}
 		ret = 0;
 	}
@@ -639,13 +1191,14 @@ int excecute_get_telemetry(system_state_t *sys, const char *varID) {
 		float value;
 		char str[50];
 
+		ret = -1;
 		telemetry_source_t *src = (telemetry_source_t*) &(sys->telemetry);
 		int n = sizeof(telemetry_group_t)/sizeof(telemetry_source_t);
 		for (i=0; i<n; i++)
 		{
 			if (strcmp(src->name,varID) == 0)
 			{
-				ret = telemetry_read(src, &value);
+				ret = telemetry_scan_read(&(sys->telemetry_scan), &(sys->telemetry), src, &value);
 				if (ret == 0)
 				{
 					io_sprintf(str, "%s = %f\r\n", varID, value);
@@ -659,6 +1212,40 @@ int excecute_get_telemetry(system_state_t *sys, const char *varID) {
 	return ret;
 }
 
+int excecute_get_telemetry_hist(system_state_t *sys, const char *varID) {
+
+	char str[50];
+	int i, k;
+
+	telemetry_source_t *src = (telemetry_source_t*) &(sys->telemetry);
+	int n = sizeof(telemetry_group_t)/sizeof(telemetry_source_t);
+	for (i=0; i<n; i++)
+	{
+		if (strcmp(src->name,varID) == 0)
+		{
+			telemetry_cache_t *cache = telemetry_scan_get(&(sys->telemetry_scan), &(sys->telemetry), src);
+			if (cache == NULL)
+			{
+				return -1;
+			}
+
+			// Oldest first.
+			int nhist = (cache->nread < TELEMETRY_HIST_LENGTH) ? cache->nread : TELEMETRY_HIST_LENGTH;
+			int idx = (cache->hist_idx + TELEMETRY_HIST_LENGTH - nhist) % TELEMETRY_HIST_LENGTH;
+			for (k=0; k<nhist; k++)
+			{
+				io_sprintf(str, "%s[%d] = %f\r\n", varID, k, cache->hist[idx]);
+				mprint(str);
+				idx = (idx + 1) % TELEMETRY_HIST_LENGTH;
+			}
+			return 0;
+		}
+		src++;
+	}
+
+	return -1;
+}
+
 int execute_exec(system_state_t *sys, const char *varID)
 {
 	// Help.
@@ -783,13 +1370,15 @@ int excecute_set(system_state_t *sys, char *varID, char *varVal, char *errStr) {
 	int nPacker_sw = sizeof(packer_sw_group_status_t)/sizeof(packer_sw_status_t);
 	for(int i = 0; i < nPacker_sw; i++)
 	{
-		if (strcmp(varID,packer_sw->name)==0)
+		const char *name = packer_reg_name(packer_sw);
+
+		if (strcmp(varID,name)==0)
 		{
 		 	status = packer_change_sw_status(packer_sw, (const uint8_t) value);
 
 		 	if ( status != 0)
 		 	{
-		 		io_sprintf(errStr, "%s out of range\r\n", packer_sw->name);
+		 		io_sprintf(errStr, "%s out of range\r\n", name);
 		 		return -1;
 		 	}
 		 	return status;
@@ -835,14 +1424,33 @@ int excecute_set(system_state_t *sys, char *varID, char *varVal, char *errStr) {
 		seq_sw++;
 	}
 
+	// Acquisition runs.
+	acq_var_t *acq_var = (acq_var_t *) &(sys->acq.vars);
+	int nAcq = sizeof(acq_group_status_t)/sizeof(acq_var_t);
+	for(int i = 0; i < nAcq; i++)
+	{
+		if (strcmp(varID, acq_var->name)==0)
+		{
+			status = acq_change_status(sys, acq_var, (uint32_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", acq_var->name);
+				return -1;
+			}
+			return status;
+		}
+		acq_var++;
+	}
+
 	// CDS variables.
 	cds_var_status_t *cds_var = (cds_var_status_t *) &(sys->cds);
-	int nCds_var = sizeof(cds_var_group_status_t)/sizeof(cds_var_status_t);
+	int nCds_var = sizeof(cds_t)/sizeof(cds_var_status_t);
 	for(int i = 0; i < nCds_var; i++)
 	{
 		if (strcmp(varID, cds_var->name)==0)
 		{
-		 	status = cds_core_change_var_value(cds_var, (const uint16_t) value);
+		 	status = cds_core_change_var_value(&(sys->cds), cds_var, (const uint16_t) value);
 
 		 	if (status != 0)
 		 	{
@@ -891,13 +1499,15 @@ int excecute_set(system_state_t *sys, char *varID, char *varVal, char *errStr) {
 	int nSmartBuf = sizeof(smart_buffer_group_status_t)/sizeof(smart_buffer_status_t);
 	for(int i = 0; i < nSmartBuf; i++)
 	{
-		if (strcmp(varID, smart_buffer_var->name)==0)
+		const char *name = smart_buffer_reg_name(smart_buffer_var);
+
+		if (strcmp(varID, name)==0)
 		{
 			status = smart_buffer_change_status(smart_buffer_var, (uint16_t) value);
 
 			if (status != 0)
 			{
-				io_sprintf(errStr, "%s out of range.\r\n", smart_buffer_var->name);
+				io_sprintf(errStr, "%s out of range.\r\n", name);
 				return -1;
 			}
 			return status;
@@ -905,6 +1515,120 @@ int excecute_set(system_state_t *sys, char *varID, char *varVal, char *errStr) {
 		smart_buffer_var++;
 	}
 
+	// Smart buffer streaming.
+	smart_buffer_var_t *stream_var = (smart_buffer_var_t *) &(sys->smart_buffer_stream.vars);
+	int nStream = sizeof(smart_buffer_stream_group_status_t)/sizeof(smart_buffer_var_t);
+	for(int i = 0; i < nStream; i++)
+	{
+		if (strcmp(varID, stream_var->name)==0)
+		{
+			status = smart_buffer_stream_change_status(&(sys->smart_buffer_stream), stream_var, &(sys->smart_buffer), (uint16_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s out of range.\r\n", stream_var->name);
+				return -1;
+			}
+			return status;
+		}
+		stream_var++;
+	}
+
+	// Smart buffer trigger.
+	smart_buffer_var_t *trig_var = (smart_buffer_var_t *) &(sys->smart_buffer_trig.vars);
+	int nTrig = sizeof(smart_buffer_trig_group_status_t)/sizeof(smart_buffer_var_t);
+	for(int i = 0; i < nTrig; i++)
+	{
+		if (strcmp(varID, trig_var->name)==0)
+		{
+			status = smart_buffer_trig_change_status(&(sys->smart_buffer_trig), trig_var, &(sys->smart_buffer), (uint16_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", trig_var->name);
+				return -1;
+			}
+			return status;
+		}
+		trig_var++;
+	}
+
+	// Smart buffer speed calibration.
+	smart_buffer_var_t *cal_var = (smart_buffer_var_t *) &(sys->smart_buffer_cal.vars);
+	int nCal = sizeof(smart_buffer_cal_group_status_t)/sizeof(smart_buffer_var_t);
+	for(int i = 0; i < nCal; i++)
+	{
+		if (strcmp(varID, cal_var->name)==0)
+		{
+			status = smart_buffer_cal_change_status(sys, cal_var, (uint16_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", cal_var->name);
+				return -1;
+			}
+			return status;
+		}
+		cal_var++;
+	}
+
+	// Telemetry scanner.
+	telemetry_var_t *scan_var = (telemetry_var_t *) &(sys->telemetry_scan.vars);
+	int nScan = sizeof(telemetry_scan_group_status_t)/sizeof(telemetry_var_t);
+	for(int i = 0; i < nScan; i++)
+	{
+		if (strcmp(varID, scan_var->name)==0)
+		{
+			status = telemetry_scan_change_status(&(sys->telemetry_scan), scan_var, (uint16_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", scan_var->name);
+				return -1;
+			}
+			return status;
+		}
+		scan_var++;
+	}
+
+	// Telemetry frames.
+	telemetry_var_t *tstrm_var = (telemetry_var_t *) &(sys->telemetry_stream.vars);
+	int nTStrm = sizeof(telemetry_stream_group_status_t)/sizeof(telemetry_var_t);
+	for(int i = 0; i < nTStrm; i++)
+	{
+		if (strcmp(varID, tstrm_var->name)==0)
+		{
+			status = telemetry_stream_change_status(sys, tstrm_var, (uint16_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", tstrm_var->name);
+				return -1;
+			}
+			return status;
+		}
+		tstrm_var++;
+	}
+
+	// Interlocks.
+	telemetry_var_t *ilk_var = (telemetry_var_t *) &(sys->interlock.vars);
+	int nIlk = sizeof(interlock_group_status_t)/sizeof(telemetry_var_t);
+	for(int i = 0; i < nIlk; i++)
+	{
+		if (strcmp(varID, ilk_var->name)==0)
+		{
+			status = interlock_change_status(sys, ilk_var, (uint16_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", ilk_var->name);
+				return -1;
+			}
+			return status;
+		}
+		ilk_var++;
+	}
+
 	// Ethernet.
 	eth_status_t *eth_var = (eth_status_t *) &(sys->eth);
 	int nEth = sizeof(eth_t)/sizeof(eth_status_t);
@@ -929,13 +1653,15 @@ int excecute_set(system_state_t *sys, char *varID, char *varVal, char *errStr) {
 	int nSyncGen = sizeof(sync_gen_t)/sizeof(sync_gen_status_t);
 	for(int i = 0; i < nSyncGen; i++)
 	{
-		if (strcmp(varID, sync_gen_var->name)==0)
+		const char *name = sync_gen_reg_name(sync_gen_var);
+
+		if (strcmp(varID, name)==0)
 		{
 			status = sync_gen_change_status(sync_gen_var, (uint16_t) value);
 
 			if (status != 0)
 			{
-				io_sprintf(errStr, "%s out of range.\r\n", sync_gen_var->name);
+				io_sprintf(errStr, "%s out of range.\r\n", name);
 				return -1;
 			}
 			return status;
@@ -943,6 +1669,44 @@ int excecute_set(system_state_t *sys, char *varID, char *varVal, char *errStr) {
 		sync_gen_var++;
 	}
 
+	// Synchronized start.
+	sync_align_var_t *sync_align_var = (sync_align_var_t *) &(sys->sync_align.vars);
+	int nSyncAlign = sizeof(sync_align_group_status_t)/sizeof(sync_align_var_t);
+	for(int i = 0; i < nSyncAlign; i++)
+	{
+		if (strcmp(varID, sync_align_var->name)==0)
+		{
+			status = sync_align_change_status(sys, sync_align_var, (uint32_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", sync_align_var->name);
+				return -1;
+			}
+			return status;
+		}
+		sync_align_var++;
+	}
+
+	// Clock monitor.
+	fr_mon_var_t *fr_mon_var = (fr_mon_var_t *) &(sys->fr_mon.vars);
+	int nFrMon = sizeof(fr_mon_group_status_t)/sizeof(fr_mon_var_t);
+	for(int i = 0; i < nFrMon; i++)
+	{
+		if (strcmp(varID, fr_mon_var->name)==0)
+		{
+			status = fr_mon_change_status(&(sys->fr_mon), fr_mon_var, (uint32_t) value);
+
+			if (status != 0)
+			{
+				io_sprintf(errStr, "%s could not be set.\r\n", fr_mon_var->name);
+				return -1;
+			}
+			return status;
+		}
+		fr_mon_var++;
+	}
+
 	// Sequencer in RAM.
 	if (strcmp(varID,"seq")==0)
 	{
@@ -262,16 +262,16 @@ int exec_init(exec_t *exec)
 {
 	// Initialize functions structure.
 
-	strcpy(exec->ccd_erase.name,"ccd_erase");
-	strcpy(exec->ccd_erase.description,"CCD erase routine for dark current minimization.");
+	exec->ccd_erase.name = "ccd_erase";
+	exec->ccd_erase.description = "CCD erase routine for dark current minimization.";
 	exec->ccd_erase.func = &ccd_erase;
 
-	strcpy(exec->cdd_epurge.name,"ccd_epurge");
-	strcpy(exec->cdd_epurge.description,"CCD epurge routine for dark current minimization.");
+	exec->cdd_epurge.name = "ccd_epurge";
+	exec->cdd_epurge.description = "CCD epurge routine for dark current minimization.";
 	exec->cdd_epurge.func = &cdd_epurge;
 
-	strcpy(exec->vsub_down.name,"vsub_down");
-	strcpy(exec->vsub_down.description,"Disables VSUB LDO regulator.");
+	exec->vsub_down.name = "vsub_down";
+	exec->vsub_down.description = "Disables VSUB LDO regulator.";
 	exec->vsub_down.func = &vsub_down;
 
 	return 0;
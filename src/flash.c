@@ -6,22 +6,30 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <xspi.h>
 #include <xil_printf.h>
 #include "flash.h"
 #include "io_func.h"
 #include "interrupt.h"
+#include "spi_trace.h"
 
 // SPI driver variables.
 XSpi_Config	*spi_flash_cfg;
 XSpi		spi_flash_i;
 
+// Chunk buffer for flash_readBuffer.
+static u8 FlashChunkBuffer[FLASH_READ_CHUNK + FAST_READ_EXTRA_BYTES];
+
 int flash_init(uint32_t spi_device_id, flash_version_t *info)
 {
 	int ret;
 	uint32_t base_addr		= 0;
 	uint32_t control_val 	= 0;
 
+	// Count its traffic.
+	spi_trace_register(&spi_flash_i, SPI_TRACE_FLASH);
+
 	// Init spi_ldo_i structure.
 	ret = XSpi_Initialize(&spi_flash_i, spi_device_id);
 	if (ret != XST_SUCCESS) {
@@ -80,13 +88,13 @@ int flash_resetEnable()
 	WriteBuffer[BYTE1] = COMMAND_RESET_ENABLE;
 
 	// Select slave for this device.
-	int status = XSpi_SetSlaveSelect(&spi_flash_i, 1);
+	int status = spi_trace_select(&spi_flash_i, 1);
 	if (status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
 	// SPI Transfer.
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer, 1);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, ReadBuffer, 1);
 
 	if (status != XST_SUCCESS)
 	{
@@ -101,13 +109,13 @@ int flash_resetMemory()
 	WriteBuffer[BYTE1] = COMMAND_RESET_MEMORY;
 
 	// Select slave for this device.
-	int status = XSpi_SetSlaveSelect(&spi_flash_i, 1);
+	int status = spi_trace_select(&spi_flash_i, 1);
 	if (status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
 	// SPI Transfer.
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer, 1);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, ReadBuffer, 1);
 
 	if (status != XST_SUCCESS)
 	{
@@ -129,7 +137,7 @@ int flash_writeEnable(void)
 	}
 
 	WriteBuffer[BYTE1] = COMMAND_WRITE_ENABLE;
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -148,7 +156,7 @@ int flash_writeDisable(void)
 
 	WriteBuffer[BYTE1] = COMMAND_WRITE_DISABLE;
 
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -184,7 +192,7 @@ int flash_4byteModeEnable(void)
 	/*
 	 * Initiate the Transfer.
 	 */
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -224,7 +232,7 @@ int flash_4byteModeDisable(void)
 	/*
 	 * Initiate the Transfer.
 	 */
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL, WRITE_ENABLE_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -234,51 +242,24 @@ int flash_4byteModeDisable(void)
 
 int flash_read(u32 Addr, u32 ByteCount)
 {
-	if (ByteCount >= PAGE_SIZE)
-	{
-		xil_printf("Error: cannot read more than %d bytes at once!!\r\n", PAGE_SIZE);
-		return XST_FAILURE;
-	}
-
+	u8 data[64];
 	int status;
 
-	status = flash_writeEnable();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_4byteModeEnable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_waitForFlashReady();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	WriteBuffer[BYTE1] = COMMAND_READ;
-	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
-	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
-	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
-	WriteBuffer[BYTE5] = (u8) Addr;
-
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
-			(ByteCount + READ_WRITE_EXTRA_BYTES));
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	uint32_t StartAddr = Addr;
-	for (int i=0; i<ByteCount; i++)
+	while (ByteCount > 0)
 	{
-		xil_printf("0x%08x: 0x%02x\t\r\n", StartAddr, (ReadBuffer[i + READ_WRITE_EXTRA_BYTES]));
-		StartAddr++;
-	}
+		u32 n = (ByteCount > sizeof(data)) ? sizeof(data) : ByteCount;
 
-	status = flash_4byteModeDisable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
+		status = flash_readBuffer(Addr, data, n);
+		if (status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		for (int i=0; i<n; i++)
+		{
+			xil_printf("0x%08x: 0x%02x\t\r\n", Addr, data[i]);
+			Addr++;
+		}
+		ByteCount -= n;
 	}
 
 	return XST_SUCCESS;
@@ -286,73 +267,15 @@ int flash_read(u32 Addr, u32 ByteCount)
 
 int flash_readByte(u32 Addr, u8 *val)
 {
-	int status;
-
-	status = flash_writeEnable();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_4byteModeEnable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_waitForFlashReady();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	WriteBuffer[BYTE1] = COMMAND_READ;
-	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
-	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
-	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
-	WriteBuffer[BYTE5] = (u8) Addr;
-
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
-			(1 + READ_WRITE_EXTRA_BYTES));
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	// Set output.
-	*val = ReadBuffer[READ_WRITE_EXTRA_BYTES];
-
-	status = flash_4byteModeDisable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	return XST_SUCCESS;
+	return flash_readBuffer(Addr, val, 1);
 }
 
 int flash_readWord(u32 Addr, u16 *val)
 {
+	u8 data[2];
 	int status;
 
-	status = flash_writeEnable();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_4byteModeEnable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_waitForFlashReady();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	WriteBuffer[BYTE1] = COMMAND_READ;
-	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
-	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
-	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
-	WriteBuffer[BYTE5] = (u8) Addr;
-
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
-			(2 + READ_WRITE_EXTRA_BYTES));
+	status = flash_readBuffer(Addr, data, 2);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -361,12 +284,7 @@ int flash_readWord(u32 Addr, u16 *val)
 	*val = 0;
 	for (int i=0; i<2; i++)
 	{
-		*val += (ReadBuffer[READ_WRITE_EXTRA_BYTES+i]<<8*i);
-	}
-
-	status = flash_4byteModeDisable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
+		*val += (data[i]<<8*i);
 	}
 
 	return XST_SUCCESS;
@@ -374,31 +292,10 @@ int flash_readWord(u32 Addr, u16 *val)
 
 int flash_readQWord(u32 Addr, u32 *val)
 {
+	u8 data[4];
 	int status;
 
-	status = flash_writeEnable();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_4byteModeEnable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_waitForFlashReady();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	WriteBuffer[BYTE1] = COMMAND_READ;
-	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
-	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
-	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
-	WriteBuffer[BYTE5] = (u8) Addr;
-
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
-			(4 + READ_WRITE_EXTRA_BYTES));
+	status = flash_readBuffer(Addr, data, 4);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -407,12 +304,7 @@ int flash_readQWord(u32 Addr, u32 *val)
 	*val = 0;
 	for (int i=0; i<4; i++)
 	{
-		*val += (ReadBuffer[READ_WRITE_EXTRA_BYTES+i]<<8*i);
-	}
-
-	status = flash_4byteModeDisable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
+		*val += (data[i]<<8*i);
 	}
 
 	return XST_SUCCESS;
@@ -424,8 +316,7 @@ int flash_readPage(u32 Addr)
 	uint32_t mask = ~(PAGE_SIZE - 1);
 	uint32_t addrStart = (Addr & mask);
 	uint32_t addrEnd = addrStart + (PAGE_SIZE - 1);
-
-	Addr = addrStart;
+	u8 data[PAGE_SIZE];
 
 	print("\n\r\n\rPerforming Flash Read Operation...\r\n");
 	xil_printf("\n\rFlash Start Address:\t0x%08x",addrStart);
@@ -433,29 +324,7 @@ int flash_readPage(u32 Addr)
 
 	int status;
 
-	status = flash_writeEnable();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_4byteModeEnable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_waitForFlashReady();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	WriteBuffer[BYTE1] = COMMAND_READ;
-	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
-	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
-	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
-	WriteBuffer[BYTE5] = (u8) Addr;
-
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
-			(PAGE_SIZE + READ_WRITE_EXTRA_BYTES));
+	status = flash_readBuffer(addrStart, data, PAGE_SIZE);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
@@ -467,21 +336,89 @@ int flash_readPage(u32 Addr)
 		xil_printf("\n\r0x%08x:\t", addrInc);
 		for (int j=0; j<8; j++)
 		{
-			xil_printf("0x%02x\t", (ReadBuffer[i*8+j + READ_WRITE_EXTRA_BYTES]));
+			xil_printf("0x%02x\t", data[i*8+j]);
 		}
 		addrInc += 8;
 	}
 
 	print("\r\n");
 
+	return XST_SUCCESS;
 
-	status = flash_4byteModeDisable();
-	if (status != XST_SUCCESS) {
+}
+
+int flash_readBuffer(u32 Addr, u8 *data, u32 ByteCount)
+{
+	int status;
+
+	// A program or erase could still be running.
+	status = flash_waitForFlashReady();
+	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
+	// 4-byte fast read takes a 4 byte address whatever the address mode is, so
+	// there is no need to enter/exit 4-byte mode (and no write enable for it).
+	// One transaction per chunk, the flash streams across page boundaries.
+	while (ByteCount > 0)
+	{
+		u32 n = (ByteCount > FLASH_READ_CHUNK) ? FLASH_READ_CHUNK : ByteCount;
+
+		FlashChunkBuffer[BYTE1] = COMMAND_4BYTE_FAST_READ;
+		FlashChunkBuffer[BYTE2] = (u8) (Addr >> 24);
+		FlashChunkBuffer[BYTE3] = (u8) (Addr >> 16);
+		FlashChunkBuffer[BYTE4] = (u8) (Addr >> 8);
+		FlashChunkBuffer[BYTE5] = (u8) Addr;
+		FlashChunkBuffer[BYTE6] = 0;	// Dummy byte.
+
+		// Same buffer for send and receive: the driver reads each received
+		// byte after the byte at the same position was sent.
+		status = spi_trace_transfer(&spi_flash_i, FlashChunkBuffer, FlashChunkBuffer,
+				(n + FAST_READ_EXTRA_BYTES));
+		if(status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		memcpy(data, FlashChunkBuffer + FAST_READ_EXTRA_BYTES, n);
+
+		data += n;
+		Addr += n;
+		ByteCount -= n;
+	}
+
 	return XST_SUCCESS;
+}
 
+int flash_benchRead(u32 Addr, u32 ByteCount)
+{
+	// Too big for the stack.
+	static u8 data[FLASH_READ_CHUNK];
+	u32 left = ByteCount;
+	int status;
+
+	uint32_t t0 = tget_ms();
+	while (left > 0)
+	{
+		u32 n = (left > sizeof(data)) ? sizeof(data) : left;
+
+		status = flash_readBuffer(Addr, data, n);
+		if(status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		Addr += n;
+		left -= n;
+	}
+	uint32_t dt = tget_ms() - t0;
+
+	// No floats in xil_printf: kB/s (1000 bytes), i.e. MB/s times 1000.
+	xil_printf("Read %d bytes in %d ms", ByteCount, dt);
+	if (dt > 0)
+	{
+		xil_printf(": %d kB/s", ByteCount/dt);
+	}
+	print("\r\n");
+
+	return XST_SUCCESS;
 }
 
 int flash_write(u32 Addr, u32 ByteCount, u8 *data)
@@ -519,7 +456,7 @@ int flash_write(u32 Addr, u32 ByteCount, u8 *data)
 		WriteBuffer[BYTE6+i] = data[i];
 	}
 
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, NULL,
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL,
 			(ByteCount + READ_WRITE_EXTRA_BYTES));
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
@@ -548,41 +485,20 @@ int flash_readBoardInfo(flash_version_t *info)
 	int status;
 	u32 Addr = FLASH_BOARD_INFO_ADDR;
 	uint32_t tmp1, tmp2;
+	u8 data[FLASH_BOARD_INFO_LENGTH];
 
-	status = flash_writeEnable();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_4byteModeEnable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	status = flash_waitForFlashReady();
-	if(status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
-	WriteBuffer[BYTE1] = COMMAND_READ;
-	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
-	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
-	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
-	WriteBuffer[BYTE5] = (u8) Addr;
-
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
-			(FLASH_BOARD_INFO_LENGTH + READ_WRITE_EXTRA_BYTES));
+	status = flash_readBuffer(Addr, data, FLASH_BOARD_INFO_LENGTH);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
 	// Fill board info structure.
-	int idx = READ_WRITE_EXTRA_BYTES;
+	int idx = 0;
 	char str[20];
 
 	// Firmware version.
-	info->firm_version.minor = ReadBuffer[idx++];
-	info->firm_version.major = ReadBuffer[idx++];
+	info->firm_version.minor = data[idx++];
+	info->firm_version.major = data[idx++];
 	io_sprintf(	str, "%d.%d",
 				info->firm_version.major,
 				info->firm_version.minor);
@@ -592,10 +508,10 @@ int flash_readBoardInfo(flash_version_t *info)
 	idx += 2;
 
 	// Firmware date.
-	info->firm_date.month = ReadBuffer[idx++];
-	info->firm_date.day = ReadBuffer[idx++];
-	info->firm_date.year = ReadBuffer[idx++];
-	info->firm_date.year += (uint16_t) (ReadBuffer[idx++]<<8);
+	info->firm_date.month = data[idx++];
+	info->firm_date.day = data[idx++];
+	info->firm_date.year = data[idx++];
+	info->firm_date.year += (uint16_t) (data[idx++]<<8);
 	io_sprintf(	str, "%d/%d/%d",
 				info->firm_date.month,
 				info->firm_date.day,
@@ -606,13 +522,13 @@ int flash_readBoardInfo(flash_version_t *info)
 	tmp1 = 0;
 	for (int i=0; i<4; i++)
 	{
-		info->firm_hash.hash[i] = ReadBuffer[idx++];
+		info->firm_hash.hash[i] = data[idx++];
 		tmp1 += (uint32_t) (info->firm_hash.hash[i] << 8*i);
 	}
 	tmp2 = 0;
 	for (int i=0; i<4; i++)
 	{
-		info->firm_hash.hash[4+i] = ReadBuffer[idx++];
+		info->firm_hash.hash[4+i] = data[idx++];
 		tmp2 += (uint32_t) (info->firm_hash.hash[4+i] << 8*i);
 	}
 	io_sprintf( str, "%x%x",
@@ -624,8 +540,8 @@ int flash_readBoardInfo(flash_version_t *info)
 	strcpy(info->firm_hash.str, str);
 
 	// Software version.
-	info->soft_version.minor = ReadBuffer[idx++];
-	info->soft_version.major = ReadBuffer[idx++];
+	info->soft_version.minor = data[idx++];
+	info->soft_version.major = data[idx++];
 	io_sprintf(	str, "%d.%d",
 				info->soft_version.major,
 				info->soft_version.minor);
@@ -635,10 +551,10 @@ int flash_readBoardInfo(flash_version_t *info)
 	idx += 2;
 
 	// Software date.
-	info->soft_date.month = ReadBuffer[idx++];
-	info->soft_date.day = ReadBuffer[idx++];
-	info->soft_date.year = ReadBuffer[idx++];
-	info->soft_date.year += (uint16_t) (ReadBuffer[idx++]<<8);
+	info->soft_date.month = data[idx++];
+	info->soft_date.day = data[idx++];
+	info->soft_date.year = data[idx++];
+	info->soft_date.year += (uint16_t) (data[idx++]<<8);
 	io_sprintf(	str, "%d/%d/%d",
 				info->soft_date.month,
 				info->soft_date.day,
@@ -649,13 +565,13 @@ int flash_readBoardInfo(flash_version_t *info)
 	tmp1 = 0;
 	for (int i=0; i<4; i++)
 	{
-		info->soft_hash.hash[i] = ReadBuffer[idx++];
+		info->soft_hash.hash[i] = data[idx++];
 		tmp1 += (uint32_t) (info->soft_hash.hash[i] << 8*i);
 	}
 	tmp2 = 0;
 	for (int i=0; i<4; i++)
 	{
-		info->soft_hash.hash[4+i] = ReadBuffer[idx++];
+		info->soft_hash.hash[4+i] = data[idx++];
 		tmp2 += (uint32_t) (info->soft_hash.hash[4+i] << 8*i);
 	}
 	io_sprintf( str, "%x%x",
@@ -667,16 +583,16 @@ int flash_readBoardInfo(flash_version_t *info)
 	strcpy(info->soft_hash.str, str);
 
 	// Unique board id.
-	info->id.val = ReadBuffer[idx++];
-	info->id.val += (uint32_t) (ReadBuffer[idx++]<<8);
-	info->id.val += (uint32_t) (ReadBuffer[idx++]<<16);
-	info->id.val += (uint32_t) (ReadBuffer[idx++]<<24);
+	info->id.val = data[idx++];
+	info->id.val += (uint32_t) (data[idx++]<<8);
+	info->id.val += (uint32_t) (data[idx++]<<16);
+	info->id.val += (uint32_t) (data[idx++]<<24);
 
 	// Board ip.
-	info->ip.val = ReadBuffer[idx++];
-	info->ip.val += (uint32_t) (ReadBuffer[idx++]<<8);
-	info->ip.val += (uint32_t) (ReadBuffer[idx++]<<16);
-	info->ip.val += (uint32_t) (ReadBuffer[idx++]<<24);
+	info->ip.val = data[idx++];
+	info->ip.val += (uint32_t) (data[idx++]<<8);
+	info->ip.val += (uint32_t) (data[idx++]<<16);
+	info->ip.val += (uint32_t) (data[idx++]<<24);
 	io_sprintf(	str, "%d.%d.%d.%d",
 				(info->ip.val>>24 	& 0xFF),
 				(info->ip.val>>16 	& 0xFF),
@@ -687,11 +603,6 @@ int flash_readBoardInfo(flash_version_t *info)
 	// Flash info address on flash.
 	info->addr = Addr;
 
-	status = flash_4byteModeDisable();
-	if (status != XST_SUCCESS) {
-		return XST_FAILURE;
-	}
-
 	return XST_SUCCESS;
 }
 
@@ -717,6 +628,51 @@ uint32_t flash_getIp(flash_version_t *info)
 	return info->ip.val;
 }
 
+int flash_readParams(flash_params_t *params)
+{
+	int status;
+	u8 data[FLASH_PARAMS_LENGTH];
+
+	status = flash_readBuffer(FLASH_PARAMS_ADDR, data, FLASH_PARAMS_LENGTH);
+	if (status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+	params->magic 		= data[0] | (data[1] << 8) | (data[2] << 16) | ((u32) data[3] << 24);
+	params->buf_speed 	= (u16) (data[4] | (data[5] << 8));
+	params->reserved 	= (u16) (data[6] | (data[7] << 8));
+
+	// Erased or never written block.
+	if (params->magic != FLASH_PARAMS_MAGIC) {
+		return XST_FAILURE;
+	}
+
+	return XST_SUCCESS;
+}
+
+int flash_writeParams(flash_params_t *params)
+{
+	int status;
+	u8 data[FLASH_PARAMS_LENGTH];
+
+	params->magic = FLASH_PARAMS_MAGIC;
+
+	for (int i=0; i<4; i++)
+	{
+		data[i] = (u8) (params->magic >> 8*i);
+	}
+	data[4] = (u8) params->buf_speed;
+	data[5] = (u8) (params->buf_speed >> 8);
+	data[6] = (u8) params->reserved;
+	data[7] = (u8) (params->reserved >> 8);
+
+	status = flash_eraseSubSector(FLASH_PARAMS_ADDR);
+	if (status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return flash_write(FLASH_PARAMS_ADDR, FLASH_PARAMS_LENGTH, data);
+}
+
 int flash_eraseSubSector(u32 Addr)
 {
 	uint32_t mask = ~(BYTE_PER_SUBSECTOR - 1);
@@ -755,7 +711,7 @@ int flash_eraseSubSector(u32 Addr)
 	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
 	WriteBuffer[BYTE5] = (u8) (Addr);
 
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, NULL,
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL,
 			SECTOR_ERASE_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
@@ -779,6 +735,107 @@ int flash_eraseSubSector(u32 Addr)
 	return XST_SUCCESS;
 }
 
+u32 flash_eraseSize(u32 Addr, u32 End)
+{
+	if ((Addr & (BYTE_PER_SECTOR - 1)) == 0 && End - Addr >= BYTE_PER_SECTOR)
+	{
+		return BYTE_PER_SECTOR;
+	}
+
+	return BYTE_PER_SUBSECTOR;
+}
+
+int flash_eraseBlock(u32 Addr, u32 Size)
+{
+	int status;
+
+	status = flash_writeEnable();
+	if(status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	WriteBuffer[BYTE1] = (Size == BYTE_PER_SECTOR) ? COMMAND_4BYTE_SECTOR_ERASE : COMMAND_4BYTE_SUBSECTOR_ERASE;
+	WriteBuffer[BYTE2] = (u8) (Addr >> 24);
+	WriteBuffer[BYTE3] = (u8) (Addr >> 16);
+	WriteBuffer[BYTE4] = (u8) (Addr >> 8);
+	WriteBuffer[BYTE5] = (u8) (Addr);
+
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL,
+			SECTOR_ERASE_BYTES);
+	if(status != XST_SUCCESS) {
+		return XST_FAILURE;
+	}
+
+	return flash_waitForWriteEnd();
+}
+
+int flash_programBuffer(u32 Addr, const u8 *data, u32 ByteCount)
+{
+	int status;
+
+	while (ByteCount > 0)
+	{
+		// Up to the end of the page, the flash wraps around inside a page.
+		u32 n = PAGE_SIZE - (Addr & (PAGE_SIZE - 1));
+		if (n > ByteCount)
+		{
+			n = ByteCount;
+		}
+
+		status = flash_writeEnable();
+		if(status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		WriteBuffer[BYTE1] = COMMAND_4BYTE_PAGE_PROGRAM;
+		WriteBuffer[BYTE2] = (u8) (Addr >> 24);
+		WriteBuffer[BYTE3] = (u8) (Addr >> 16);
+		WriteBuffer[BYTE4] = (u8) (Addr >> 8);
+		WriteBuffer[BYTE5] = (u8) Addr;
+		memcpy(&WriteBuffer[BYTE6], data, n);
+
+		status = spi_trace_transfer(&spi_flash_i, WriteBuffer, NULL,
+				(n + READ_WRITE_EXTRA_BYTES));
+		if(status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		status = flash_waitForWriteEnd();
+		if(status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+
+		data += n;
+		Addr += n;
+		ByteCount -= n;
+	}
+
+	return XST_SUCCESS;
+}
+
+int flash_crc(u32 Addr, u32 ByteCount, u32 *crc)
+{
+	u8 data[PAGE_SIZE];
+	int status;
+
+	*crc = 0;
+	while (ByteCount > 0)
+	{
+		u32 n = (ByteCount > sizeof(data)) ? sizeof(data) : ByteCount;
+
+		status = flash_readBuffer(Addr, data, n);
+		if(status != XST_SUCCESS) {
+			return XST_FAILURE;
+		}
+		*crc = io_crc32(*crc, data, n);
+
+		Addr += n;
+		ByteCount -= n;
+	}
+
+	return XST_SUCCESS;
+}
+
 int flash_readID(void)
 {
 	int status;
@@ -794,7 +851,7 @@ int flash_readID(void)
 	WriteBuffer[BYTE1] = COMMAND_READ_ID;
 
 	// SPI Transfer.
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer, READ_WRITE_EXTRA_BYTES);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, ReadBuffer, READ_WRITE_EXTRA_BYTES);
 	if (status != XST_SUCCESS)
 	{
 		return XST_FAILURE;
@@ -874,13 +931,13 @@ int flash_getStatus(void)
 	WriteBuffer[BYTE1] = COMMAND_STATUSREG_READ;
 
 	// Select slave for this device.
-	int status = XSpi_SetSlaveSelect(&spi_flash_i, 1);
+	int status = spi_trace_select(&spi_flash_i, 1);
 	if (status != XST_SUCCESS) {
 		return XST_FAILURE;
 	}
 
 	// SPI Transfer.
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer, STATUS_READ_BYTES);
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, ReadBuffer, STATUS_READ_BYTES);
 
 	if (status != XST_SUCCESS)
 	{
@@ -904,7 +961,7 @@ int flash_getFlagStatus()
 	}
 
 	WriteBuffer[BYTE1] = COMMAND_READ_FLAG_STATUS;
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
 			READ_WRITE_EXTRA_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
@@ -930,7 +987,7 @@ int flash_getExtendedAddress(void)
 
 	WriteBuffer[BYTE1] = COMMAND_READ_EXTENDED_ADDRESS;
 
-	status = XSpi_Transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
+	status = spi_trace_transfer(&spi_flash_i, WriteBuffer, ReadBuffer,
 			READ_WRITE_EXTRA_BYTES);
 	if(status != XST_SUCCESS) {
 		return XST_FAILURE;
@@ -0,0 +1,186 @@
+/*
+ * flash_prog.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "flash_prog.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+static flash_prog_t flash_prog;
+
+int flash_prog_start(uint32_t addr, uint32_t length, uint32_t crc)
+{
+	flash_prog_t *p = &flash_prog;
+	uint32_t t0 = tget_ms();
+	char str[100];
+
+	if (	(addr & (BYTE_PER_SUBSECTOR - 1)) != 0 	||
+			length == 0 							||
+			addr >= FLASH_PROG_END_ADDR 			||
+			length > FLASH_PROG_END_ADDR - addr )
+	{
+		return -1;
+	}
+
+	// The whole range now, an erase takes up to a few hundred ms and no
+	// data must arrive meanwhile.
+	p->nerase = 0;
+	for (uint32_t a=addr; a<addr+length; )
+	{
+		uint32_t size = flash_eraseSize(a, addr + length);
+		if (flash_eraseBlock(a, size) != XST_SUCCESS)
+		{
+			return -2;
+		}
+		a += size;
+		p->nerase++;
+	}
+
+	p->addr 		= addr;
+	p->length 		= length;
+	p->crc 			= crc;
+	p->received 	= 0;
+	p->rx_crc 		= 0;
+	p->nibble 		= -1;
+	p->page_fill 	= 0;
+	p->t0 			= tget_ms();
+	p->last_rx 		= p->t0;
+	p->active 		= 1;
+
+	io_sprintf(str, "### Flash: %u erases in %u ms, ready for data\r\n", p->nerase, p->t0 - t0);
+	mprint(str);
+
+	return 0;
+}
+
+int flash_prog_active(void)
+{
+	return flash_prog.active;
+}
+
+// Programs the page buffer, the range is already erased.
+static int flash_prog_flush(void)
+{
+	flash_prog_t *p = &flash_prog;
+	uint32_t addr = p->addr + p->received - p->page_fill;
+
+	if (flash_programBuffer(addr, p->page, p->page_fill) != XST_SUCCESS)
+	{
+		return -1;
+	}
+	p->page_fill = 0;
+
+	return 0;
+}
+
+static void flash_prog_finish(void)
+{
+	flash_prog_t *p = &flash_prog;
+	uint32_t dt = tget_ms() - p->t0;
+	uint32_t crc = 0;
+	char str[100];
+
+	p->active = 0;
+
+	io_sprintf(str, "### Flash: %u bytes, %u ms", p->length, dt);
+	mprint(str);
+	if (dt > 0)
+	{
+		io_sprintf(str, ", %u kB/s", p->length / dt);
+		mprint(str);
+	}
+	mprint("\r\n");
+
+	if (p->rx_crc != p->crc)
+	{
+		io_sprintf(str, "### Flash: data CRC 0x%x, expected 0x%x\r\n", p->rx_crc, p->crc);
+	}
+	else if (flash_crc(p->addr, p->length, &crc) != XST_SUCCESS)
+	{
+		io_sprintf(str, "### Flash: verify failed, read back error\r\n");
+	}
+	else if (crc != p->crc)
+	{
+		io_sprintf(str, "### Flash: verify failed, CRC 0x%x\r\n", crc);
+	}
+	else
+	{
+		io_sprintf(str, "### Flash: verify OK\r\n");
+	}
+	mprint(str);
+}
+
+static void flash_prog_abort(const char *reason)
+{
+	char str[100];
+
+	flash_prog.active = 0;
+	io_sprintf(str, "### Flash: %s after %u bytes\r\n", (char *) reason, flash_prog.received);
+	mprint(str);
+}
+
+void flash_prog_feed(const uint8_t *buf, unsigned int n)
+{
+	flash_prog_t *p = &flash_prog;
+
+	for (unsigned int i=0; i<n && p->active; i++)
+	{
+		uint8_t c = buf[i];
+		int v;
+
+		if (c == ASCII_CHAR_ESC || c == ASCII_CHAR_CAN)
+		{
+			flash_prog_abort("cancelled");
+			return;
+		}
+
+		if (c >= '0' && c <= '9') 		v = c - '0';
+		else if (c >= 'a' && c <= 'f') 	v = c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F') 	v = c - 'A' + 10;
+		else 							continue;
+
+		if (p->nibble < 0)
+		{
+			p->nibble = v;
+			continue;
+		}
+
+		uint8_t byte = (p->nibble << 4) | v;
+		p->nibble = -1;
+
+		p->rx_crc = io_crc32(p->rx_crc, &byte, 1);
+		p->page[p->page_fill++] = byte;
+		p->received++;
+
+		// Full page or last byte.
+		if (((p->addr + p->received) & (PAGE_SIZE - 1)) == 0 || p->received == p->length)
+		{
+			if (flash_prog_flush() != 0)
+			{
+				flash_prog_abort("write error");
+				return;
+			}
+		}
+
+		if (p->received == p->length)
+		{
+			flash_prog_finish();
+		}
+	}
+
+	p->last_rx = tget_ms();
+}
+
+void flash_prog_poll(void)
+{
+	if (flash_prog.active && (tget_ms() - flash_prog.last_rx) >= FLASH_PROG_TIMEOUT_MS)
+	{
+		flash_prog_abort("timeout");
+	}
+}
@@ -0,0 +1,198 @@
+/*
+ * fr_mon.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "fr_mon.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+static uint8_t fr_mon_buffer[FR_MON_HEADER_LENGTH + FR_MON_HIST_LENGTH*FR_MON_ENTRY_LENGTH];
+
+static void fr_mon_reset(fr_mon_t *mon)
+{
+	mon->ref 		= mon->vars.ref.value;
+	mon->nsamp 		= 0;
+	mon->min 		= 0;
+	mon->max 		= 0;
+	mon->sum 		= 0;
+	mon->hist_idx 	= 0;
+	mon->vars.alarm.value = FR_MON_OFF;
+}
+
+void fr_mon_init(fr_mon_t *mon)
+{
+	mon->vars.enable.value 	= FR_MON_OFF;
+	mon->vars.enable.min 	= FR_MON_OFF;
+	mon->vars.enable.max 	= FR_MON_ON;
+	mon->vars.enable.name = "frMon";
+
+	mon->vars.period.value 	= FR_MON_PERIOD_DEFAULT;
+	mon->vars.period.min 	= FR_MON_PERIOD_MIN;
+	mon->vars.period.max 	= FR_MON_PERIOD_MAX;
+	mon->vars.period.name = "frMonPer";
+
+	mon->vars.ref.value 	= 0;
+	mon->vars.ref.min 		= FR_MEAS_FMEAS_MIN;
+	mon->vars.ref.max 		= FR_MEAS_FMEAS_MAX;
+	mon->vars.ref.name = "frMonRef";
+
+	mon->vars.tol.value 	= FR_MON_TOL_DEFAULT;
+	mon->vars.tol.min 		= 0;
+	mon->vars.tol.max 		= FR_MEAS_FMEAS_MAX;
+	mon->vars.tol.name = "frMonTol";
+
+	// Read only variables.
+	mon->vars.alarm.value 	= FR_MON_OFF;
+	mon->vars.alarm.min 	= 0;
+	mon->vars.alarm.max 	= 0;
+	mon->vars.alarm.name = "frMonAlarm";
+
+	mon->vars.nalarm.value 	= 0;
+	mon->vars.nalarm.min 	= 0;
+	mon->vars.nalarm.max 	= 0;
+	mon->vars.nalarm.name = "frMonAlarms";
+
+	mon->last_tick = tget_ms();
+	fr_mon_reset(mon);
+}
+
+int fr_mon_change_status(fr_mon_t *mon, fr_mon_var_t *var, uint32_t value)
+{
+	// Read only.
+	if (var == &(mon->vars.alarm) || var == &(mon->vars.nalarm))
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+	var->value = value;
+
+	// Statistics start again with the new reference, first sample right away.
+	if ( var == &(mon->vars.ref) ||
+		 (var == &(mon->vars.enable) && value == FR_MON_ON) )
+	{
+		fr_mon_reset(mon);
+		mon->last_tick = tget_ms() - mon->vars.period.value;
+	}
+
+	return 0;
+}
+
+int fr_mon_poll(fr_mon_t *mon, fr_meas_t *fr_meas)
+{
+	char str[100];
+
+	if (mon->vars.enable.value == FR_MON_OFF)
+	{
+		return 0;
+	}
+
+	uint32_t now = tget_ms();
+	if ((now - mon->last_tick) < mon->vars.period.value)
+	{
+		return 0;
+	}
+	mon->last_tick = now;
+
+	fr_meas_update_reg(&(fr_meas->fmeas));
+	uint32_t khz = fr_meas->fmeas.value;
+
+	if (mon->nsamp == 0 || khz < mon->min) mon->min = khz;
+	if (mon->nsamp == 0 || khz > mon->max) mon->max = khz;
+	if (mon->ref == 0) mon->ref = khz;
+	mon->sum += khz;
+	mon->nsamp++;
+
+	mon->hist[mon->hist_idx].tstamp = now;
+	mon->hist[mon->hist_idx].khz 	= khz;
+	mon->hist_idx = (mon->hist_idx + 1) % FR_MON_HIST_LENGTH;
+
+	// Alarm once on the way out of range.
+	uint32_t drift = (khz > mon->ref) ? khz - mon->ref : mon->ref - khz;
+	if (drift > mon->vars.tol.value)
+	{
+		if (mon->vars.alarm.value == FR_MON_OFF)
+		{
+			mon->vars.alarm.value = FR_MON_ON;
+			mon->vars.nalarm.value++;
+			io_sprintf(str, "### Clock drift: %u kHz, reference %u kHz\r\n", khz, mon->ref);
+			mprint(str);
+		}
+	}
+	else
+	{
+		mon->vars.alarm.value = FR_MON_OFF;
+	}
+
+	return 1;
+}
+
+// Number of history entries, and index of the oldest one.
+static uint32_t fr_mon_hist_count(fr_mon_t *mon, uint32_t *first)
+{
+	uint32_t n = (mon->nsamp < FR_MON_HIST_LENGTH) ? mon->nsamp : FR_MON_HIST_LENGTH;
+
+	*first = (mon->hist_idx + FR_MON_HIST_LENGTH - n) % FR_MON_HIST_LENGTH;
+
+	return n;
+}
+
+void fr_mon_print(fr_mon_t *mon)
+{
+	char str[100];
+	uint32_t first, n = fr_mon_hist_count(mon, &first);
+	uint32_t now = tget_ms();
+
+	mprint("### Clock monitor ###\r\n");
+	if (mon->nsamp == 0)
+	{
+		mprint("No samples\r\n");
+		return;
+	}
+	io_sprintf(str, "Reference %u kHz, %u samples, min %u, mean %u, max %u kHz, %u alarms\r\n",
+			mon->ref, mon->nsamp, mon->min, (uint32_t) (mon->sum / mon->nsamp), mon->max, mon->vars.nalarm.value);
+	mprint(str);
+
+	for (uint32_t i=0; i<n; i++)
+	{
+		fr_mon_sample_t *s = &(mon->hist[(first + i) % FR_MON_HIST_LENGTH]);
+		io_sprintf(str, "-%u ms : %u kHz\r\n", now - s->tstamp, s->khz);
+		mprint(str);
+	}
+}
+
+void fr_mon_send(fr_mon_t *mon)
+{
+	uint32_t first, n = fr_mon_hist_count(mon, &first);
+	uint8_t *p = fr_mon_buffer + FR_MON_HEADER_LENGTH;
+
+	for (uint32_t i=0; i<n; i++)
+	{
+		fr_mon_sample_t *s = &(mon->hist[(first + i) % FR_MON_HIST_LENGTH]);
+		io_put_u32(p, s->tstamp);
+		io_put_u32(p + 4, s->khz);
+		p += FR_MON_ENTRY_LENGTH;
+	}
+
+	uint8_t *h = fr_mon_buffer;
+	io_put_u32(h, FR_MON_MAGIC);
+	io_put_u16(h + 4, FR_MON_VERSION);
+	io_put_u16(h + 6, n);
+	io_put_u32(h + 8, tget_ms());
+	io_put_u32(h + 12, mon->ref);
+	io_put_u32(h + 16, mon->min);
+	io_put_u32(h + 20, mon->max);
+	io_put_u32(h + 24, (mon->nsamp > 0) ? (uint32_t) (mon->sum / mon->nsamp) : 0);
+	io_put_u32(h + 28, io_crc32(0, fr_mon_buffer + FR_MON_HEADER_LENGTH, n*FR_MON_ENTRY_LENGTH));
+
+	io_put_bin("Clock monitor", fr_mon_buffer, FR_MON_HEADER_LENGTH + n*FR_MON_ENTRY_LENGTH);
+}
@@ -11,12 +11,12 @@
 
 int generic_vars_init(generic_vars_t *vars)
 {
-	strcpy(vars->echo.name,"echo");
+	vars->echo.name = "echo";
 	vars->echo.min = GENERIC_VARS_ECHO_MIN;
 	vars->echo.max = GENERIC_VARS_ECHO_MAX;
 	vars->echo.value = GENERIC_VARS_ECHO_OFF;
 
-	strcpy(vars->outeth.name, "outeth");
+	vars->outeth.name = "outeth";
 	vars->outeth.min = GENERIC_VARS_OUTETH_MIN;
 	vars->outeth.max = GENERIC_VARS_OUTETH_MAX;
 	vars->outeth.value = GENERIC_VARS_OUTETH_ON;
@@ -0,0 +1,290 @@
+/*
+ * interlock.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <xil_printf.h>
+
+#include "interlock.h"
+#include "io_func.h"
+
+// Switch and bias indexes from their field in the group.
+#define INTERLOCK_SW(field)		(uint8_t)(offsetof(bias_sw_group_status_t, field)/sizeof(bias_sw_status_t))
+#define INTERLOCK_BIAS(field)	(uint8_t)(offsetof(bias_group_status_t, field)/sizeof(bias_status_t))
+
+static int interlock_find_source(system_state_t *sys, const char *name)
+{
+	telemetry_source_t *src = (telemetry_source_t *) &(sys->telemetry);
+	int i;
+
+	for (i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		if (strcmp(src[i].name, name) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void interlock_rule_init(system_state_t *sys, interlock_rule_t *rule, const char *source,
+		float min, float max, uint8_t action, uint8_t sw, uint8_t bias)
+{
+	rule->source 	= interlock_find_source(sys, source);
+	rule->min 		= min;
+	rule->max 		= max;
+	rule->action 	= action;
+	rule->sw 		= sw;
+	rule->bias 		= bias;
+	rule->ramp_to 	= 0;
+	rule->ramp_step = 0;
+	rule->enable 	= 1;
+	rule->nbad 		= 0;
+	rule->tripped 	= 0;
+}
+
+void interlock_init(system_state_t *sys)
+{
+	interlock_t *ilk = &(sys->interlock);
+	interlock_rule_t *rule = ilk->rules;
+
+	ilk->vars.enable.value 	= INTERLOCK_OFF;
+	ilk->vars.enable.min 	= INTERLOCK_OFF;
+	ilk->vars.enable.max 	= INTERLOCK_ON;
+	ilk->vars.enable.name = "ilkEnable";
+
+	// Read only variables.
+	ilk->vars.state.value 	= 0;
+	ilk->vars.state.min 	= 0;
+	ilk->vars.state.max 	= 0;
+	ilk->vars.state.name = "ilkState";
+
+	ilk->vars.trips.value 	= 0;
+	ilk->vars.trips.min 	= 0;
+	ilk->vars.trips.max 	= 0;
+	ilk->vars.trips.name = "ilkTrips";
+
+	ilk->vars.reset.value 	= 0;
+	ilk->vars.reset.min 	= 0;
+	ilk->vars.reset.max 	= 1;
+	ilk->vars.reset.name = "ilkReset";
+
+	// Supply rails.
+	interlock_rule_init(sys, rule++, "v_m15v0", -16.5, -13.5, INTERLOCK_ACTION_SW_OFF,
+			INTERLOCK_SW(m15v_sw), INTERLOCK_NONE);
+	interlock_rule_init(sys, rule++, "v_p15v0", 13.5, 16.5, INTERLOCK_ACTION_SW_OFF,
+			INTERLOCK_SW(p15v_sw), INTERLOCK_NONE);
+	interlock_rule_init(sys, rule++, "v_p12v0", 10.8, 13.2, INTERLOCK_ACTION_LOG,
+			INTERLOCK_NONE, INTERLOCK_NONE);
+
+	// CCD biases, 2 V outside of what the LDOs can be programmed to.
+	interlock_rule_init(sys, rule, "ccd_vsub", LDOS_VSUB_VMIN - 2, LDOS_VSUB_VMAX + 2, INTERLOCK_ACTION_RAMP,
+			INTERLOCK_SW(ccd_vsub_sw), INTERLOCK_BIAS(vsub));
+	rule->ramp_to 	= LDOS_VSUB_VMIN;
+	rule->ramp_step = 5;
+	rule++;
+	interlock_rule_init(sys, rule++, "ccd_vdrain", LDOS_VDRAIN_VMIN - 2, LDOS_VDRAIN_VMAX + 2, INTERLOCK_ACTION_SW_OFF,
+			INTERLOCK_SW(ccd_vdrain_sw), INTERLOCK_NONE);
+	interlock_rule_init(sys, rule++, "ccd_vdd", LDOS_VDD_VMIN - 2, LDOS_VDD_VMAX + 2, INTERLOCK_ACTION_SW_OFF,
+			INTERLOCK_SW(ccd_vdd_sw), INTERLOCK_NONE);
+	interlock_rule_init(sys, rule++, "ccd_vr", LDOS_VR_VMIN - 2, LDOS_VR_VMAX + 2, INTERLOCK_ACTION_SW_OFF,
+			INTERLOCK_SW(ccd_vr_sw), INTERLOCK_NONE);
+}
+
+int interlock_change_status(system_state_t *sys, telemetry_var_t *var, uint16_t value)
+{
+	interlock_t *ilk = &(sys->interlock);
+	int i;
+
+	// Read only.
+	if (var == &(ilk->vars.state) || var == &(ilk->vars.trips))
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+
+	// Clear latched rules. Switches are not closed again.
+	if (var == &(ilk->vars.reset))
+	{
+		if (value)
+		{
+			for (i=0; i<INTERLOCK_NRULES; i++)
+			{
+				ilk->rules[i].tripped = 0;
+				ilk->rules[i].nbad = 0;
+			}
+			ilk->vars.state.value = 0;
+		}
+		return 0;
+	}
+
+	var->value = value;
+
+	return 0;
+}
+
+static void interlock_trip(system_state_t *sys, int idx, float value)
+{
+	interlock_t *ilk = &(sys->interlock);
+	interlock_rule_t *rule = &(ilk->rules[idx]);
+	telemetry_source_t *src = (telemetry_source_t *) &(sys->telemetry) + rule->source;
+	bias_sw_status_t *sw = (bias_sw_status_t *) &(sys->bias_sw.sw_group);
+	char str[100];
+
+	rule->tripped = 1;
+	ilk->vars.state.value |= (1 << idx);
+	ilk->vars.trips.value++;
+
+	io_sprintf(str, "### Interlock %s = %f out of [%f, %f]\r\n", src->name, value, rule->min, rule->max);
+	mprint(str);
+
+	if (rule->action == INTERLOCK_ACTION_SW_OFF && rule->sw != INTERLOCK_NONE)
+	{
+		volt_sw_state_set(sw + rule->sw, &(sys->bias_sw.state), 0);
+	}
+}
+
+// One ramp step. Opens the switch once the target is reached.
+static void interlock_ramp(system_state_t *sys, interlock_rule_t *rule)
+{
+	bias_status_t *bias = (bias_status_t *) &(sys->biases) + rule->bias;
+	bias_sw_status_t *sw = (bias_sw_status_t *) &(sys->bias_sw.sw_group);
+	float v = bias->value;
+
+	if (v > rule->ramp_to + rule->ramp_step)
+	{
+		ldos_set_voltage(bias, v - rule->ramp_step);
+	}
+	else if (v < rule->ramp_to - rule->ramp_step)
+	{
+		ldos_set_voltage(bias, v + rule->ramp_step);
+	}
+	else
+	{
+		ldos_set_voltage(bias, rule->ramp_to);
+		if (rule->sw != INTERLOCK_NONE)
+		{
+			volt_sw_state_set(sw + rule->sw, &(sys->bias_sw.state), 0);
+		}
+	}
+}
+
+void interlock_check(system_state_t *sys)
+{
+	interlock_t *ilk = &(sys->interlock);
+	bias_sw_status_t *sw = (bias_sw_status_t *) &(sys->bias_sw.sw_group);
+	uint8_t source = sys->telemetry_scan.last;
+	float value = sys->telemetry_scan.cache[source].value;
+	int i;
+
+	if (ilk->vars.enable.value == INTERLOCK_OFF)
+	{
+		return;
+	}
+
+	for (i=0; i<INTERLOCK_NRULES; i++)
+	{
+		interlock_rule_t *rule = &(ilk->rules[i]);
+
+		if (rule->source != source || !rule->enable)
+		{
+			continue;
+		}
+
+		// Ramp goes on while the switch is closed.
+		if (rule->tripped)
+		{
+			if (rule->action == INTERLOCK_ACTION_RAMP && (rule->sw == INTERLOCK_NONE || sw[rule->sw].status))
+			{
+				interlock_ramp(sys, rule);
+			}
+			continue;
+		}
+
+		// Rail switched off: nothing to check.
+		if (rule->sw != INTERLOCK_NONE && !sw[rule->sw].status)
+		{
+			rule->nbad = 0;
+			continue;
+		}
+
+		if (value < rule->min || value > rule->max)
+		{
+			if (++rule->nbad >= INTERLOCK_DEBOUNCE)
+			{
+				interlock_trip(sys, i, value);
+			}
+		}
+		else
+		{
+			rule->nbad = 0;
+		}
+	}
+}
+
+void interlock_print(system_state_t *sys)
+{
+	interlock_t *ilk = &(sys->interlock);
+	telemetry_source_t *src = (telemetry_source_t *) &(sys->telemetry);
+	const char *actions[] = { "log", "sw_off", "ramp" };
+	char str[100];
+	int i;
+
+	mprint("### Interlocks ###\r\n");
+	for (i=0; i<INTERLOCK_NRULES; i++)
+	{
+		interlock_rule_t *rule = &(ilk->rules[i]);
+		io_sprintf(str, "%s : [%f, %f] %s enable %d tripped %d\r\n",
+				src[rule->source].name, rule->min, rule->max, actions[rule->action], rule->enable, rule->tripped);
+		mprint(str);
+	}
+}
+
+int interlock_set_rule(system_state_t *sys, const char *field, const char *source, float value)
+{
+	interlock_t *ilk = &(sys->interlock);
+	int idx = interlock_find_source(sys, source);
+	int i;
+
+	for (i=0; i<INTERLOCK_NRULES; i++)
+	{
+		interlock_rule_t *rule = &(ilk->rules[i]);
+
+		if (rule->source != idx)
+		{
+			continue;
+		}
+
+		if (strcmp(field, "ilkmin") == 0)
+		{
+			rule->min = value;
+		}
+		else if (strcmp(field, "ilkmax") == 0)
+		{
+			rule->max = value;
+		}
+		else if (strcmp(field, "ilkrule") == 0)
+		{
+			rule->enable = (value != 0);
+		}
+		else
+		{
+			return -1;
+		}
+		rule->nbad = 0;
+
+		return 0;
+	}
+
+	return -1;
+}
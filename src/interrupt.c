@@ -11,7 +11,10 @@
 XIntc intc_i;
 
 // Global delay variable.
-uint32_t interrupt_counter;
+volatile uint32_t interrupt_counter;
+
+// Free running tick counter (ms).
+volatile uint32_t interrupt_ticks;
 
 int intc_init(u16 device_id)
 {
@@ -59,12 +62,19 @@ int intc_init(u16 device_id)
 	// Enable exceptions.
 	Xil_ExceptionEnable();
 
-	// Disable interrupts.
-	intc_disable(XINTC_INT_SRC_TIMER);
+	// Timer is kept enabled so the tick counter is always running.
+	interrupt_counter = 0;
+	interrupt_ticks = 0;
+	intc_enable(XINTC_INT_SRC_TIMER);
 
 	return XST_SUCCESS;
 }
 
+int intc_connect(u8 id, XInterruptHandler handler, void *ref)
+{
+	return XIntc_Connect(&intc_i, id, handler, ref);
+}
+
 void intc_enable(u8 id)
 {
 	XIntc_Enable(&intc_i, id);
@@ -77,23 +87,27 @@ void intc_disable(u8 id)
 
 void timer_isr(void)
 {
-	interrupt_counter--;
+	interrupt_ticks++;
+
+	if (interrupt_counter)
+	{
+		interrupt_counter--;
+	}
 	//print("On isr\r\n");
 }
 
+uint32_t tget_ms(void)
+{
+	return interrupt_ticks;
+}
+
 void tdelay_ms(uint32_t t)
 {
 	// Load global variable.
 	interrupt_counter = t;
 
-	// Enable timer interrupt.
-	intc_enable(XINTC_INT_SRC_TIMER);
-
 	// Wait for counter to finish.
 	while (interrupt_counter);
-
-	// Disable timer interrupt.
-	intc_disable(XINTC_INT_SRC_TIMER);
 }
 
 void tdelay_s(uint32_t t)
@@ -101,12 +115,6 @@ void tdelay_s(uint32_t t)
 	// Load global variable.
 	interrupt_counter = 1000*t;
 
-	// Enable timer interrupt.
-	intc_enable(XINTC_INT_SRC_TIMER);
-
 	// Wait for counter to finish.
 	while (interrupt_counter);
-
-	// Disable timer interrupt.
-	intc_disable(XINTC_INT_SRC_TIMER);
 }
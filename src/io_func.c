@@ -393,6 +393,55 @@ void io_padd(uint8_t n, char *str, char ch)
 	strcpy(str, pad_str);
 }
 
+uint32_t io_crc32(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+	// Standard CRC-32 (IEEE 802.3, reflected, poly 0xEDB88320). Bitwise
+	// implementation to avoid spending 1 kB of memory in a table. Pass 0 as the
+	// initial crc. Can be chained over several blocks.
+	crc = ~crc;
+	for (uint32_t i=0; i<length; i++)
+	{
+		crc ^= data[i];
+		for (int j=0; j<8; j++)
+		{
+			if (crc & 1)
+			{
+				crc = (crc >> 1) ^ 0xEDB88320;
+			}
+			else
+			{
+				crc = crc >> 1;
+			}
+		}
+	}
+
+	return ~crc;
+}
+
+void io_put_u16(uint8_t *p, uint16_t val)
+{
+	p[0] = val & 0xFF;
+	p[1] = (val >> 8) & 0xFF;
+}
+
+void io_put_u32(uint8_t *p, uint32_t val)
+{
+	p[0] = val & 0xFF;
+	p[1] = (val >> 8) & 0xFF;
+	p[2] = (val >> 16) & 0xFF;
+	p[3] = (val >> 24) & 0xFF;
+}
+
+uint16_t io_get_u16(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+uint32_t io_get_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
 void mprint(const char *str)
 {
 	if (io_sys->generic_vars.outeth.value)
@@ -404,3 +453,53 @@ void mprint(const char *str)
 		print(str);
 	}
 }
+
+void io_put_bin(const char *title, const uint8_t *data, uint32_t length)
+{
+	if (io_sys->generic_vars.outeth.value)
+	{
+		eth_sdata_put_bin(data, length);
+	}
+	else
+	{
+		// Hex dump, 32 bytes per line.
+		const char digits[] = "0123456789ABCDEF";
+		char str[70];
+		uint32_t i, j;
+
+		io_sprintf(str, "### %s %u bytes\r\n", title, length);
+		print(str);
+		for (i=0; i<length; i+=32)
+		{
+			int idx = 0;
+			for (j=i; (j<i+32) && (j<length); j++)
+			{
+				str[idx++] = digits[data[j] >> 4];
+				str[idx++] = digits[data[j] & 0xF];
+			}
+			str[idx++] = '\r';
+			str[idx++] = '\n';
+			str[idx] = '\0';
+			print(str);
+		}
+		print("### End\r\n");
+	}
+}
+
+int io_put_bin_async(const char *title, const uint8_t *data, uint32_t length)
+{
+	if (io_sys->generic_vars.outeth.value)
+	{
+		return eth_sdata_put_bin_async(data, length);
+	}
+
+	// The uart tx ring does not wait for the host.
+	io_put_bin(title, data, length);
+
+	return 0;
+}
+
+int io_put_bin_poll(void)
+{
+	return eth_sdata_async_poll();
+}
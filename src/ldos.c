@@ -14,6 +14,7 @@
 #include "interrupt.h"
 #include "ldos.h"
 #include "io_func.h"
+#include "spi_trace.h"
 
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
@@ -37,6 +38,9 @@ int ldos_init(bias_group_status_t *biases, uint32_t spi_device_id, uint32_t gpio
 	uint32_t base_addr		= 0;
 	uint32_t control_val 	= 0;
 
+	// Count its traffic.
+	spi_trace_register(&spi_ldo_i, SPI_TRACE_LDO);
+
 	// Init spi_ldo_i structure.
 	ret = XSpi_Initialize(&spi_ldo_i, spi_device_id);
 	if (ret != XST_SUCCESS) {
@@ -133,7 +137,7 @@ int ldos_init(bias_group_status_t *biases, uint32_t spi_device_id, uint32_t gpio
 	biases->vdrain.r2p = LDOS_VDRAIN_R2P;
 	biases->vdrain.bits = LDOS_VDRAIN_BITS;
 	biases->vdrain.rm = (float)LDOS_VDRAIN_RFS/(float)(1 << biases->vdrain.bits);
-	strcpy(biases->vdrain.name,"vdrain");
+	biases->vdrain.name = "vdrain";
 
 	//VDD initial values
 	/*
@@ -155,7 +159,7 @@ int ldos_init(bias_group_status_t *biases, uint32_t spi_device_id, uint32_t gpio
 	biases->vdd.r2p = LDOS_VDD_R2P;
 	biases->vdd.bits = LDOS_VDD_BITS;
 	biases->vdd.rm =  (float)LDOS_VDD_RFS/(float)(1 << biases->vdd.bits);
-	strcpy(biases->vdd.name,"vdd");
+	biases->vdd.name = "vdd";
 
 	//set VR initial values
 	/*
@@ -177,7 +181,7 @@ int ldos_init(bias_group_status_t *biases, uint32_t spi_device_id, uint32_t gpio
 	biases->vr.r2p = LDOS_VR_R2P;
 	biases->vr.bits = LDOS_VR_BITS;
 	biases->vr.rm =  (float)LDOS_VR_RFS/(float)(1 << biases->vr.bits);
-	strcpy(biases->vr.name, "vr");
+	biases->vr.name = "vr";
 
 
 
@@ -201,7 +205,7 @@ int ldos_init(bias_group_status_t *biases, uint32_t spi_device_id, uint32_t gpio
 	biases->vsub.r2p = LDOS_VSUB_R2P;
 	biases->vsub.bits = LDOS_VSUB_BITS;
 	biases->vsub.rm = (float)LDOS_VSUB_RFS/(float)(1 << biases->vsub.bits);
-	strcpy(biases->vsub.name, "vsub");
+	biases->vsub.name = "vsub";
 
 	//set default values to hardware
 	bias_status_t *bias = (bias_status_t *) biases;
@@ -246,13 +250,13 @@ int ldos_rdac_wr(uint16_t data,uint32_t ss)
 	buf[1] = (data & LDOS_DATA_LOW_MASK);
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_ldo_i, ss);
+	ret = spi_trace_select(&spi_ldo_i, ss);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
 
 	// Send data.
-	return XSpi_Transfer(&spi_ldo_i, buf, NULL, 2);
+	return spi_trace_transfer(&spi_ldo_i, buf, NULL, 2);
 }
 
 /**********************
@@ -264,7 +268,7 @@ int ldos_rdac_rd(uint16_t *data, uint32_t ss)
 	int ret;
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_ldo_i, ss);
+	ret = spi_trace_select(&spi_ldo_i, ss);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
@@ -276,7 +280,7 @@ int ldos_rdac_rd(uint16_t *data, uint32_t ss)
 	// 	 	 || 0  |  0 | C3 | C2 | C1 | C0 | X  | X  | X  | X  | X  | X  | X  | X  | X  | X  ||
 	buf[0] = LDOS_CMD_RDAC_READ;
 	buf[1] = 0x00;
-	ret = XSpi_Transfer(&spi_ldo_i, buf, NULL, 2);
+	ret = spi_trace_transfer(&spi_ldo_i, buf, NULL, 2);
 
 	// If Transfer was successfully completed, go ahead.
 	if (ret != XST_SUCCESS ) {
@@ -290,7 +294,7 @@ int ldos_rdac_rd(uint16_t *data, uint32_t ss)
 	// 	 	 || 0  |  0 | C3 | C2 | C1 | C0 | X  | X  | X  | X  | X  | X  | X  | X  | X  | X  ||
 	buf[0] = LDOS_CMD_NOP;
 	buf[1] = 0x00;
-	ret = XSpi_Transfer(&spi_ldo_i, buf, buf, 2);
+	ret = spi_trace_transfer(&spi_ldo_i, buf, buf, 2);
 
 	// Set results into data variable.
 	*data = (buf[0] << 8) | buf[1];
@@ -316,13 +320,13 @@ int ldos_rst(uint32_t ss)
 	buf[1] = 0x00;
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_ldo_i, ss);
+	ret = spi_trace_select(&spi_ldo_i, ss);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
 
 	// Transfer data.
-	return XSpi_Transfer(&spi_ldo_i, buf, NULL, 2);
+	return spi_trace_transfer(&spi_ldo_i, buf, NULL, 2);
 }
 
 /**********************
@@ -342,10 +346,10 @@ int ldos_creg_wr(uint8_t c1, uint8_t c2, uint32_t ss)
 		   | ( (c1 & 1) << LDOS_CTRL_REG_C1_BIT_POS );
 
 	// Select slave for this device.
-	XSpi_SetSlaveSelect(&spi_ldo_i, ss);
+	spi_trace_select(&spi_ldo_i, ss);
 
 	// Transfer data.
-	return XSpi_Transfer(&spi_ldo_i, buf, NULL, 2);
+	return spi_trace_transfer(&spi_ldo_i, buf, NULL, 2);
 }
 
 /**********************
@@ -357,7 +361,7 @@ int ldos_creg_rd(uint8_t *c1, uint8_t *c2, uint32_t ss)
 	int ret;
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_ldo_i, ss);
+	ret = spi_trace_select(&spi_ldo_i, ss);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
@@ -369,7 +373,7 @@ int ldos_creg_rd(uint8_t *c1, uint8_t *c2, uint32_t ss)
 	// 	 	 || 0  |  0 | C3 | C2 | C1 | C0 | X  | X  | X  | X  | X  | X  | X  | X  | X  | X  ||
 	buf[0] = LDOS_CMD_CREG_READ;
 	buf[1] = 0x00;
-	ret = XSpi_Transfer(&spi_ldo_i, buf, NULL, 2);
+	ret = spi_trace_transfer(&spi_ldo_i, buf, NULL, 2);
 
 	// If Transfer was successfully completed, go ahead.
 	if (ret != XST_SUCCESS ) {
@@ -385,7 +389,7 @@ int ldos_creg_rd(uint8_t *c1, uint8_t *c2, uint32_t ss)
 	buf[1] = 0x00;
 	buf[2] = 0x00;
 	buf[3] = 0x00;
-	ret = XSpi_Transfer(&spi_ldo_i, buf, buf, 2);
+	ret = spi_trace_transfer(&spi_ldo_i, buf, buf, 2);
 
 	// Write results into c1 and c2 variables.
 	*c1 = ( (buf[1] & LDOS_CTRL_REG_C1_BIT_MASK) >> LDOS_CTRL_REG_C1_BIT_POS );
@@ -411,13 +415,13 @@ int ldos_pdown(uint8_t d0, uint32_t ss)
 	buf[1] = ( (d0 & 1) << LDOS_PDOWN_D0_BIT_POS );
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_ldo_i, ss);
+	ret = spi_trace_select(&spi_ldo_i, ss);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
 
 	// Transfer data.
-	return XSpi_Transfer(&spi_ldo_i, buf, NULL, 2);
+	return spi_trace_transfer(&spi_ldo_i, buf, NULL, 2);
 }
 
 int ldos_sw_en(uint8_t sw, uint8_t en)
@@ -40,37 +40,37 @@ int gpio_leds_init(uint32_t gpio_device_id, leds_t *leds)
 	XGpio_SetDataDirection(&gpio_leds_i, 1, 0x0);
 
 	// Initialize structure.
-	strcpy(leds->leds_group.led0.name, "led0");
+	leds->leds_group.led0.name = "led0";
 	leds->leds_group.led0.status = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led0.bit_position = GPIO_LEDS_LED0_POSITION;
 	leds->leds_group.led0.min = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led0.max = GPIO_LEDS_LED_ON;
 
-	strcpy(leds->leds_group.led1.name, "led1");
+	leds->leds_group.led1.name = "led1";
 	leds->leds_group.led1.status = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led1.bit_position = GPIO_LEDS_LED1_POSITION;
 	leds->leds_group.led1.min = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led1.max = GPIO_LEDS_LED_ON;
 
-	strcpy(leds->leds_group.led2.name, "led2");
+	leds->leds_group.led2.name = "led2";
 	leds->leds_group.led2.status = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led2.bit_position = GPIO_LEDS_LED2_POSITION;
 	leds->leds_group.led2.min = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led2.max = GPIO_LEDS_LED_ON;
 
-	strcpy(leds->leds_group.led3.name, "led3");
+	leds->leds_group.led3.name = "led3";
 	leds->leds_group.led3.status = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led3.bit_position = GPIO_LEDS_LED3_POSITION;
 	leds->leds_group.led3.min = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led3.max = GPIO_LEDS_LED_ON;
 
-	strcpy(leds->leds_group.led4.name, "led4");
+	leds->leds_group.led4.name = "led4";
 	leds->leds_group.led4.status = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led4.bit_position = GPIO_LEDS_LED4_POSITION;
 	leds->leds_group.led4.min = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led4.max = GPIO_LEDS_LED_ON;
 
-	strcpy(leds->leds_group.led5.name, "led5");
+	leds->leds_group.led5.name = "led5";
 	leds->leds_group.led5.status = GPIO_LEDS_LED_OFF;
 	leds->leds_group.led5.bit_position = GPIO_LEDS_LED5_POSITION;
 	leds->leds_group.led5.min = GPIO_LEDS_LED_OFF;
@@ -39,6 +39,15 @@
 #include "flash.h"
 #include "master_sel.h"
 #include "gpio_root.h"
+#include "smart_buffer_cal.h"
+#include "interlock.h"
+#include "telemetry_stream.h"
+#include "flash_prog.h"
+#include "script.h"
+#include "acq.h"
+#include "sync_align.h"
+#include "fr_mon.h"
+#include "perf.h"
 
 system_state_t sys;
 
@@ -50,9 +59,9 @@ int main ()
    // Variables for command parsing.
    int status = 0;
    int nWords = 0;
-   uint8_t bufWords[USERCOMMANDLENGTH];
-   uint8_t userWord[USERCOMMANDLENGTH];
-   int userWordInd = 0;
+   // Sized for a full ethernet message.
+   uint8_t bufWords[ETH_MAX_DATALENGTH];
+   uart_line_t cmdLine;
    char errStr[256];
 
    // Initialize uart.
@@ -68,6 +77,12 @@ int main ()
    // Initialize interrupts.
    intc_init(XPAR_INTC_0_DEVICE_ID);
 
+   // Console input and output from now on by interrupts.
+   uart_irq_init();
+
+   // Initialize command latency profiling.
+   perf_init();
+
    // Initialize flash.
    flash_init(XPAR_SPI_FLASH_DEVICE_ID, &(sys.flash));
 
@@ -76,12 +91,11 @@ int main ()
    if (gpio_root_sw())
    {
 	   // Main loop.
-	   unsigned int cmdBufferIdx = 0;
 	   //uart_printMenu();
 
 	   // Erase buffers.
-	   uart_eraseBuffer(bufWords, USERCOMMANDLENGTH);
-	   uart_eraseBuffer(userWord, USERCOMMANDLENGTH);
+	   uart_eraseBuffer(bufWords, ETH_MAX_DATALENGTH);
+	   uart_line_clear(&cmdLine);
 
 	   print("\033[2J");
 	   print("\033[H");
@@ -90,64 +104,39 @@ int main ()
 
 	   while(1)
 	   {
-		   // Read char from serial port.
-		   int n = uart_rcv(bufWords);
+		   // Read chars from serial port.
+		   int n = uart_rcv(bufWords, ETH_MAX_DATALENGTH);
 		   for (int i=0; i<n; i++)
 		   {
-			   // Enter was detected.
-			   if (bufWords[i] == ASCII_CHAR_CR)
+			   int echo = gpio_root_get_waitPass() ? UART_ECHO_MASK : UART_ECHO_ON;
+
+			   int line = uart_line_put(&cmdLine, bufWords[i], echo);
+
+			   // Line too long, rejected.
+			   if (line < 0)
 			   {
-				   print("\r\n");
+				   print("### Line too long, rejected\r\n");
+				   uart_line_clear(&cmdLine);
+			   }
 
+			   // Enter was detected.
+			   else if (line)
+			   {
 				   // Check password.
 				   if (gpio_root_get_waitPass())
 				   {
-					   gpio_root_check_pass((char *)userWord);
+					   gpio_root_check_pass(cmdLine.buf);
 				   }
 				   else
 				   {
 					   // Parse command.
-					   uart_parseCmd((char *)userWord);
+					   uart_parseCmd(cmdLine.buf);
 
 					   print("\r\n");
 				   }
 
 				   // Clean command buffer.
-				   uart_eraseBuffer(userWord, USERCOMMANDLENGTH);
-				   cmdBufferIdx = 0;
-			   }
-			   // Other chars were detected that delete the command buffer.
-			   else if (
-					   bufWords[i] == ASCII_CHAR_BS 	||
-					   bufWords[i] == ASCII_CHAR_CAN 	||
-					   bufWords[i] == ASCII_CHAR_EM 	||
-					   bufWords[i] == ASCII_CHAR_SUB 	||
-					   bufWords[i] == ASCII_CHAR_ESC 	||
-					   bufWords[i] == ASCII_CHAR_FS 	||
-					   bufWords[i] == ASCII_CHAR_DEL
-			   )
-			   {
-				   // Clean command buffer.
-				   uart_eraseBuffer(userWord, USERCOMMANDLENGTH);
-				   cmdBufferIdx = 0;
-
-				   print("\33[2K");
-				   print("\r\n");
-			   }
-			   else
-			   {
-				   //add character to the user vector
-				   userWord[cmdBufferIdx] = bufWords[i];
-				   cmdBufferIdx++;
-
-				   if (gpio_root_get_waitPass())
-				   {
-					   print("*");
-				   }
-				   else
-				   {
-					   print((const char*)&bufWords[i]);
-				   }
+				   uart_line_clear(&cmdLine);
 			   }
 		   }
 	   }
@@ -170,9 +159,11 @@ int main ()
 
    mprint("--- Initialize Frequency Measurement ---\r\n");
    fr_meas_init(&(sys.fr_meas));
+   fr_mon_init(&(sys.fr_mon));
 
    mprint("--- Initialize Sync Generation Logic ---\r\n");
    sync_gen_init(&(sys.sync_gen));
+   sync_align_init(&(sys.sync_align));
 
    mprint("--- Initialize Exec function catalog ---\r\n");
    exec_init(&(sys.exec));
@@ -182,6 +173,9 @@ int main ()
 
    mprint("--- Initialize Smart Buffer ---\r\n");
    smart_buffer_init(&(sys.smart_buffer));
+   smart_buffer_stream_init(&(sys.smart_buffer_stream));
+   smart_buffer_trig_init(&(sys.smart_buffer_trig));
+   smart_buffer_cal_init(&sys);
 
    mprint("--- Initialize Packer ---\r\n");
    packer_init(&(sys.packer_sw));
@@ -191,9 +185,12 @@ int main ()
 
    mprint("--- Initialize Sequencer ---\r\n");
    sequencer_init(&(sys.seq));
+   acq_init(&(sys.acq));
 
    mprint("--- Initialize Telemetry ---\r\n");
    telemetry_init(&(sys.telemetry), XPAR_SPI_TELEMETRY_DEVICE_ID, XPAR_GPIO_TELEMETRY_DEVICE_ID);
+   telemetry_scan_init(&(sys.telemetry_scan));
+   telemetry_stream_init(&sys);
 
    mprint("--- Initialize Bias Voltages ---\r\n");
    ldos_init(&(sys.biases), XPAR_SPI_LDO_DEVICE_ID, XPAR_GPIO_LDO_DEVICE_ID);
@@ -204,6 +201,9 @@ int main ()
    mprint("--- Initialize Voltage Switch ---\r\n");
    volt_sw_init(XPAR_SPI_VOLT_SW_DEVICE_ID, XPAR_GPIO_VOLT_SW_DEVICE_ID, &(sys.bias_sw), &(sys.gpio_sw));
 
+   mprint("--- Initialize Interlocks ---\r\n");
+   interlock_init(&sys);
+
    mprint("\r\n");
    mprint("--- ################# ---\r\n");
    mprint("--- Board Information ---\r\n");
@@ -250,77 +250,75 @@ int main ()
    /* ********************************************** */
    mprint("Accepting comands...\r\n");
    // Erase buffers.
-   uart_eraseBuffer(bufWords, USERCOMMANDLENGTH);
-   uart_eraseBuffer(userWord, USERCOMMANDLENGTH);
+   uart_eraseBuffer(bufWords, ETH_MAX_DATALENGTH);
+   uart_line_clear(&cmdLine);
 
    while (1)
    {
-	   nWords = uart_rcv(bufWords);
+	   nWords = uart_rcv(bufWords, ETH_MAX_DATALENGTH);
 	   if (nWords == 0)
 	   {
 		   nWords = eth_mdata_get(bufWords);
 	   }
 
+	   // An open flash programming session takes the input as data.
+	   if (flash_prog_active())
+	   {
+		   flash_prog_feed(bufWords, nWords);
+		   nWords = 0;
+	   }
+
 	   for (int iChar = 0; iChar<nWords; iChar++)
 	   {
-		   if (bufWords[iChar] == ASCII_CHAR_CR)
+		   int echo = (sys.generic_vars.echo.value == GENERIC_VARS_ECHO_ON) ? UART_ECHO_ON : UART_ECHO_OFF;
+
+		   int line = uart_line_put(&cmdLine, bufWords[iChar], echo);
+
+		   // Line too long, rejected. Answered like a failed command.
+		   if (line < 0)
 		   {
-			   if (sys.generic_vars.echo.value == GENERIC_VARS_ECHO_ON)
-			   {
-				   print("\r\n");
-			   }
+			   mprint("Done\r\n");
+			   io_sprintf(errStr, CMD_FAILED_PREFIX "### Line longer than %d chars, rejected\r\n", USERCOMMANDLENGTH - 1);
+			   mprint(errStr);
+			   uart_line_clear(&cmdLine);
+		   }
 
+		   // Whole command line.
+		   else if (line)
+		   {
 			   // Executing command...
 			   gpio_leds_change_state(&(sys.leds.leds_group.led1), &(sys.leds.state), GPIO_LEDS_LED_ON);
 
-			   // Execute command.
-			   status = excecute_interpret(&sys,(char *)userWord, errStr);
+			   // Execute command, or store it in the script being recorded.
+			   if (script_recording())
+			   {
+				   status = script_record_line(cmdLine.buf, errStr);
+			   }
+			   else
+			   {
+				   status = excecute_interpret(&sys, cmdLine.buf, errStr);
+				   perf_executed();
+			   }
 			   mprint("Done\r\n");
 			   if (status != 0)
 			   {
+				   mprint(CMD_FAILED_PREFIX);
 				   mprint(errStr);
 			   }
+			   perf_end(status);
 
 			   // Clean User Command Buffer.
-			   for	(int u=0; u<USERCOMMANDLENGTH; u++)
-			   {
-				   userWord[u] = 0;
-			   }
-			   userWordInd = 0;
+			   uart_line_clear(&cmdLine);
 
 			   gpio_leds_change_state(&(sys.leds.leds_group.led1), &(sys.leds.state), GPIO_LEDS_LED_OFF);
-		   }
-		   else if (	bufWords[iChar] == ASCII_CHAR_BS 	||
-				   bufWords[iChar] == ASCII_CHAR_CAN 	||
-				   bufWords[iChar] == ASCII_CHAR_EM 	||
-				   bufWords[iChar] == ASCII_CHAR_SUB 	||
-				   bufWords[iChar] == ASCII_CHAR_ESC 	||
-				   bufWords[iChar] == ASCII_CHAR_FS 	||
-				   bufWords[iChar] == ASCII_CHAR_DEL
-		   )
-		   {
-			   // Clean User Command Buffer.
-			   for	(int u=0; u<USERCOMMANDLENGTH; u++)
-			   {
-				   userWord[u] = 0;
-			   }
-			   userWordInd = 0;
 
-			   if ( (int)sys.generic_vars.echo.value == GENERIC_VARS_ECHO_ON) {
-				   print("\33[2K");
-				   print("\r\n");
-			   }
-		   }
-		   else
-		   {
-			   //add character to the user vector
-			   userWord[userWordInd] = bufWords[iChar];
-			   if ( (int)sys.generic_vars.echo.value == GENERIC_VARS_ECHO_ON) {
-				   print((const char *) &(userWord[userWordInd]));
+			   // Data can follow flash_prog in the same message.
+			   if (flash_prog_active())
+			   {
+				   flash_prog_feed(&bufWords[iChar+1], nWords-iChar-1);
+				   break;
 			   }
-			   userWordInd = userWordInd + 1;
 		   }
-
 	   }
 
 	   // Check if sequencer has finished.
@@ -332,6 +330,43 @@ int main ()
 		   // Stop packer.
 		   packer_change_sw_status(&(sys.packer_sw.start),PACKER_START_OFF);
 		   mprint("Read done\r\n");
+		   script_event(SCRIPT_EVENT_EOS);
+
+		   // Count synchronized starts.
+		   sync_align_eos(&sys);
+
+		   // Next frame of an acquisition run.
+		   acq_eos(&sys);
+
+		   // End of sequence can trigger the smart buffer.
+		   smart_buffer_trig_event(&(sys.smart_buffer_trig), SMART_BUFFER_TRIG_SRC_SEQ);
+	   }
+
+	   // Background telemetry, one source per call. Interlocks check new values.
+	   if (telemetry_scan_poll(&(sys.telemetry_scan), &(sys.telemetry)))
+	   {
+		   interlock_check(&sys);
+	   }
+
+	   // Clock drift monitor.
+	   fr_mon_poll(&(sys.fr_mon), &(sys.fr_meas));
+
+	   // Periodic telemetry frame, if subscribed.
+	   telemetry_stream_poll(&sys);
+
+	   // Cancel a stalled flash programming session.
+	   flash_prog_poll();
+
+	   // Acquisition run: clean, end of exposure.
+	   acq_poll(&sys);
+
+	   // Next step of the running script.
+	   script_poll(&sys);
+
+	   // Check if triggered capture has to be stopped.
+	   if (smart_buffer_trig_poll(&(sys.smart_buffer_trig), &(sys.smart_buffer)))
+	   {
+		   mprint("Trigger capture done\r\n");
 	   }
 
 	   // Check if transfer has finished.
@@ -339,7 +374,15 @@ int main ()
 	   {
 		   smart_buffer_change_status(&(sys.smart_buffer.capture_start), SMART_BUFFER_CAPTURE_STOP);
 		   smart_buffer_change_status(&(sys.smart_buffer.transfer_start), SMART_BUFFER_TRNASFER_STOP);
-		   mprint("Transfer done\r\n");
+
+		   // When streaming, the next block is started right away and only the
+		   // end of the stream is reported. Calibration transfers report their own.
+		   if (	!smart_buffer_stream_next(&(sys.smart_buffer_stream), &(sys.smart_buffer)) &&
+				!smart_buffer_cal_eot(&sys) )
+		   {
+			   mprint("Transfer done\r\n");
+			   script_event(SCRIPT_EVENT_EOT);
+		   }
 	   }
 
    }
@@ -7,26 +7,29 @@
 
 #include "master_sel.h"
 
+#define MASTER_SEL_DESC(field, reg, name, value, min, max, flags) \
+	{ name, MASTER_SEL_##reg##_REG_OFFSET, MASTER_SEL_##reg##_REG_MASK, value, min, max, flags },
+
+static const regmap_desc_t master_sel_desc[] = { MASTER_SEL_REGS(MASTER_SEL_DESC) };
+
+static regmap_t master_sel_map = {
+	.base_addr 	= XPAR_MASTER_SEL_0_BASEADDR,
+	.desc 		= master_sel_desc,
+	.nregs 		= REGMAP_NREGS(master_sel_desc),
+};
+
 void master_sel_init(master_sel_t *master_sel)
 {
-	// Init register structure.
-	master_sel->sel.value 				= 0;
-	master_sel->sel.min 				= MASTER_SEL_IS_SLAVE;
-	master_sel->sel.max 				= MASTER_SEL_IS_MASTER;
-	master_sel->sel.reg_offset 			= MASTER_SEL_MST_SEL_REG_OFFSET;
-	master_sel->sel.reg_mask 			= MASTER_SEL_MST_SEL_REG_MASK;
-	strcpy(master_sel->sel.name,"isSlave");
-
-	// Update value from hardware.
-	master_sel_update_reg(&(master_sel->sel));
+	// Init register structure and update value from hardware.
+	regmap_init(&master_sel_map, (regmap_reg_t *) master_sel);
 }
 
 int master_sel_update_reg(master_sel_status_t *reg)
 {
-	volatile uint32_t value = MASTER_SEL_mReadReg(XPAR_MASTER_SEL_0_BASEADDR, reg->reg_offset);
-	reg->value = value & reg->reg_mask;
-
-	return 0;
+	return regmap_update(&master_sel_map, reg);
 }
 
-
+const char *master_sel_reg_name(const master_sel_status_t *reg)
+{
+	return regmap_name(&master_sel_map, reg);
+}
@@ -0,0 +1,258 @@
+/*
+ * perf.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include "xparameters.h"
+#include "xil_io.h"
+
+#include "perf.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+#ifdef XPAR_TMRCTR_0_BASEADDR
+// AXI timer 0, counter 0, free running up.
+#define PERF_TMR_TCSR0				(XPAR_TMRCTR_0_BASEADDR + 0x0)
+#define PERF_TMR_TLR0				(XPAR_TMRCTR_0_BASEADDR + 0x4)
+#define PERF_TMR_TCR0				(XPAR_TMRCTR_0_BASEADDR + 0x8)
+#define PERF_TMR_ARHT				0x10
+#define PERF_TMR_LOAD				0x20
+#define PERF_TMR_ENT				0x80
+#define PERF_TICKS_PER_US			(XPAR_TMRCTR_0_CLOCK_FREQ_HZ / 1000000)
+#endif
+
+// Stages of the command being timed.
+#define PERF_IDLE					0
+#define PERF_PARSING				1
+#define PERF_PARSED					2
+#define PERF_EXECUTED				3
+
+typedef struct {
+	perf_type_t types[PERF_NTYPES];
+	int ntypes;
+
+	// Command being timed.
+	uint8_t stage;
+	char name[PERF_NAME_LENGTH];
+	uint32_t t_start;
+	uint32_t t_parsed;
+	uint32_t t_executed;
+} perf_state_t;
+
+static perf_state_t perf;
+
+uint32_t perf_ticks(void)
+{
+#ifdef XPAR_TMRCTR_0_BASEADDR
+	return Xil_In32(PERF_TMR_TCR0);
+#else
+	return tget_ms();
+#endif
+}
+
+// Unsigned difference, so wraps are fine.
+uint32_t perf_us(uint32_t t0, uint32_t t1)
+{
+#ifdef XPAR_TMRCTR_0_BASEADDR
+	return (t1 - t0) / PERF_TICKS_PER_US;
+#else
+	return (t1 - t0) * 1000;
+#endif
+}
+
+uint32_t perf_resolution(void)
+{
+#ifdef XPAR_TMRCTR_0_BASEADDR
+	return 1;
+#else
+	return 1000;
+#endif
+}
+
+void perf_init(void)
+{
+#ifdef XPAR_TMRCTR_0_BASEADDR
+	Xil_Out32(PERF_TMR_TCSR0, 0);
+	Xil_Out32(PERF_TMR_TLR0, 0);
+	Xil_Out32(PERF_TMR_TCSR0, PERF_TMR_LOAD);
+	Xil_Out32(PERF_TMR_TCSR0, PERF_TMR_ENT | PERF_TMR_ARHT);
+#endif
+
+	perf_reset();
+}
+
+void perf_reset(void)
+{
+	memset(&perf, 0, sizeof(perf));
+
+	// Always there, so failed commands have a place.
+	strcpy(perf.types[0].name, "other");
+	perf.ntypes = 1;
+}
+
+void perf_start(void)
+{
+	perf.stage 		= PERF_PARSING;
+	perf.t_start 	= perf_ticks();
+}
+
+void perf_parsed(const char *type)
+{
+	if (perf.stage != PERF_PARSING)
+	{
+		return;
+	}
+
+	perf.t_parsed 	= perf_ticks();
+	perf.stage 		= PERF_PARSED;
+	strncpy(perf.name, (type != NULL) ? type : "", PERF_NAME_LENGTH - 1);
+	perf.name[PERF_NAME_LENGTH - 1] = '\0';
+}
+
+void perf_executed(void)
+{
+	if (perf.stage != PERF_PARSED)
+	{
+		perf.stage = PERF_IDLE;
+		return;
+	}
+
+	perf.t_executed = perf_ticks();
+	perf.stage 		= PERF_EXECUTED;
+}
+
+// Type named name. New types only for commands that worked.
+static perf_type_t *perf_type(const char *name, int status)
+{
+	for (int i=1; i<perf.ntypes; i++)
+	{
+		if (strcmp(perf.types[i].name, name) == 0)
+		{
+			return &perf.types[i];
+		}
+	}
+
+	if (status != 0 || name[0] == '\0' || perf.ntypes == PERF_NTYPES)
+	{
+		return &perf.types[0];
+	}
+
+	perf_type_t *t = &perf.types[perf.ntypes++];
+	strcpy(t->name, name);
+
+	return t;
+}
+
+static int perf_bucket(uint32_t us)
+{
+	int b = 0;
+
+	while (us != 0 && b < PERF_NBUCKETS - 1)
+	{
+		us >>= 1;
+		b++;
+	}
+
+	return b;
+}
+
+void perf_end(int status)
+{
+	if (perf.stage != PERF_EXECUTED)
+	{
+		perf.stage = PERF_IDLE;
+		return;
+	}
+	perf.stage = PERF_IDLE;
+
+	uint32_t t_end 	= perf_ticks();
+	uint32_t parse 	= perf_us(perf.t_start, perf.t_parsed);
+	uint32_t exec 	= perf_us(perf.t_parsed, perf.t_executed);
+	uint32_t output = perf_us(perf.t_executed, t_end);
+	uint32_t total 	= perf_us(perf.t_start, t_end);
+
+	perf_type_t *t = perf_type(perf.name, status);
+
+	if (t->count == 0 || total < t->min) t->min = total;
+	if (t->count == 0 || total > t->max) t->max = total;
+	t->count++;
+	t->sum_parse 	+= parse;
+	t->sum_exec 	+= exec;
+	t->sum_output 	+= output;
+	t->hist[perf_bucket(total)]++;
+}
+
+int perf_ntypes(void)
+{
+	return perf.ntypes;
+}
+
+// Upper bound of the bucket holding the pct percentile.
+static uint32_t perf_percentile(perf_type_t *t, uint32_t pct)
+{
+	uint32_t target = (t->count*pct + 99) / 100;
+	uint32_t acc = 0;
+
+	for (int b=0; b<PERF_NBUCKETS; b++)
+	{
+		acc += t->hist[b];
+		if (acc >= target)
+		{
+			uint32_t upper = (b == 0) ? 0 : (1u << b) - 1;
+			if (upper < t->min) upper = t->min;
+			if (upper > t->max || b == PERF_NBUCKETS - 1) upper = t->max;
+			return upper;
+		}
+	}
+
+	return t->max;
+}
+
+int perf_get(int i, char *name, perf_stats_t *stats)
+{
+	if (i < 0 || i >= perf.ntypes)
+	{
+		return -1;
+	}
+
+	perf_type_t *t = &perf.types[i];
+
+	strncpy(name, t->name, PERF_NAME_LENGTH);
+	memset(stats, 0, sizeof(perf_stats_t));
+	stats->count = t->count;
+	if (t->count == 0)
+	{
+		return 0;
+	}
+	stats->min 		= t->min;
+	stats->p50 		= perf_percentile(t, 50);
+	stats->p99 		= perf_percentile(t, 99);
+	stats->max 		= t->max;
+	stats->parse 	= (uint32_t) (t->sum_parse / t->count);
+	stats->exec 	= (uint32_t) (t->sum_exec / t->count);
+	stats->output 	= (uint32_t) (t->sum_output / t->count);
+
+	return 0;
+}
+
+void perf_print(void)
+{
+	char str[160];
+	char name[PERF_NAME_LENGTH];
+	perf_stats_t s;
+
+	mprint("### Command latency (us) ###\r\n");
+	io_sprintf(str, "Resolution %u us\r\n", perf_resolution());
+	mprint(str);
+	for (int i=0; i<perf.ntypes; i++)
+	{
+		perf_get(i, name, &s);
+		io_sprintf(str, "%s : count %u, min %u, p50 %u, p99 %u, max %u, parse %u, exec %u, output %u\r\n",
+				name, s.count, s.min, s.p50, s.p99, s.max, s.parse, s.exec, s.output);
+		mprint(str);
+	}
+}
@@ -0,0 +1,172 @@
+/*
+ * profile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "profile.h"
+#include "snapshot.h"
+#include "flash.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+// Header and blob.
+static uint8_t profile_buffer[PROFILE_HEADER_LENGTH + SNAPSHOT_BUFFER_LENGTH];
+
+static uint32_t profile_slot_addr(int slot)
+{
+	return FLASH_PROFILE_ADDR + slot*BYTE_PER_SUBSECTOR;
+}
+
+// Reads the header of a slot. Returns -1 if the slot is free.
+static int profile_read_header(int slot, profile_header_t *hdr)
+{
+	uint8_t buf[PROFILE_HEADER_LENGTH];
+
+	if (flash_readBuffer(profile_slot_addr(slot), buf, PROFILE_HEADER_LENGTH) != XST_SUCCESS)
+	{
+		return -1;
+	}
+
+	hdr->magic 		= io_get_u32(buf);
+	hdr->version 	= io_get_u16(buf + 4);
+	memcpy(hdr->name, buf + 8, PROFILE_NAME_LENGTH);
+	hdr->name[PROFILE_NAME_LENGTH-1] = '\0';
+	hdr->length 	= io_get_u32(buf + 24);
+	hdr->crc 		= io_get_u32(buf + 28);
+
+	if (hdr->magic != PROFILE_MAGIC || hdr->length > SNAPSHOT_BUFFER_LENGTH)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+// Slot holding the profile, -1 if there is none.
+static int profile_find(const char *name)
+{
+	profile_header_t hdr;
+
+	for (int slot=0; slot<FLASH_PROFILE_NSLOTS; slot++)
+	{
+		if (profile_read_header(slot, &hdr) == 0 && strcmp(hdr.name, name) == 0)
+		{
+			return slot;
+		}
+	}
+
+	return -1;
+}
+
+int profile_save(system_state_t *sys, const char *name)
+{
+	profile_header_t hdr;
+	uint32_t length, crc;
+	int slot;
+
+	if (strlen(name) >= PROFILE_NAME_LENGTH)
+	{
+		return -1;
+	}
+
+	// Same name, or first free slot.
+	slot = profile_find(name);
+	for (int i=0; slot<0 && i<FLASH_PROFILE_NSLOTS; i++)
+	{
+		if (profile_read_header(i, &hdr) != 0)
+		{
+			slot = i;
+		}
+	}
+	if (slot < 0)
+	{
+		return -1;
+	}
+
+	uint8_t *blob = profile_buffer + PROFILE_HEADER_LENGTH;
+	if (snapshot_build(sys, blob, SNAPSHOT_BUFFER_LENGTH, &length) != 0)
+	{
+		return -1;
+	}
+	crc = io_crc32(0, blob, length);
+
+	memset(profile_buffer, 0, PROFILE_HEADER_LENGTH);
+	io_put_u32(profile_buffer, PROFILE_MAGIC);
+	io_put_u16(profile_buffer + 4, PROFILE_VERSION);
+	strcpy((char *) profile_buffer + 8, name);
+	io_put_u32(profile_buffer + 24, length);
+	io_put_u32(profile_buffer + 28, crc);
+
+	uint32_t addr = profile_slot_addr(slot);
+	if (	flash_eraseBlock(addr, BYTE_PER_SUBSECTOR) != XST_SUCCESS ||
+			flash_programBuffer(addr, profile_buffer, PROFILE_HEADER_LENGTH + length) != XST_SUCCESS ||
+			flash_crc(addr + PROFILE_HEADER_LENGTH, length, &crc) != XST_SUCCESS ||
+			crc != io_get_u32(profile_buffer + 28) )
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+int profile_load(system_state_t *sys, const char *name)
+{
+	profile_header_t hdr;
+	char str[100];
+
+	uint32_t t0 = tget_ms();
+	int slot = profile_find(name);
+	if (slot < 0 || profile_read_header(slot, &hdr) != 0)
+	{
+		return -1;
+	}
+
+	uint8_t *blob = profile_buffer + PROFILE_HEADER_LENGTH;
+	if (flash_readBuffer(profile_slot_addr(slot) + PROFILE_HEADER_LENGTH, blob, hdr.length) != XST_SUCCESS)
+	{
+		return -1;
+	}
+	if (io_crc32(0, blob, hdr.length) != hdr.crc)
+	{
+		return -1;
+	}
+
+	int status = snapshot_apply(sys, blob, hdr.length);
+
+	io_sprintf(str, "### Profile %s applied in %u ms\r\n", hdr.name, tget_ms() - t0);
+	mprint(str);
+
+	return status;
+}
+
+int profile_delete(const char *name)
+{
+	int slot = profile_find(name);
+	if (slot < 0)
+	{
+		return -1;
+	}
+
+	return (flash_eraseBlock(profile_slot_addr(slot), BYTE_PER_SUBSECTOR) == XST_SUCCESS) ? 0 : -1;
+}
+
+void profile_list(void)
+{
+	profile_header_t hdr;
+	char str[100];
+
+	mprint("### Profiles ###\r\n");
+	for (int slot=0; slot<FLASH_PROFILE_NSLOTS; slot++)
+	{
+		if (profile_read_header(slot, &hdr) == 0)
+		{
+			io_sprintf(str, "%d : %s, %u bytes, v%u\r\n", slot, hdr.name, hdr.length, hdr.version);
+			mprint(str);
+		}
+	}
+}
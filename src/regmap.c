@@ -0,0 +1,87 @@
+/*
+ * regmap.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include "xil_io.h"
+
+#include "regmap.h"
+
+void regmap_init(regmap_t *map, regmap_reg_t *regs)
+{
+	const regmap_desc_t *desc = map->desc;
+
+	map->regs = regs;
+	for (int i=0; i<map->nregs; i++)
+	{
+		regs[i].value = desc[i].value;
+	}
+
+	regmap_write_all(map);
+}
+
+void regmap_write_all(const regmap_t *map)
+{
+	for (int i=0; i<map->nregs; i++)
+	{
+		regmap_reg_t *reg = &(map->regs[i]);
+
+		if (map->desc[i].flags & REGMAP_RO)
+		{
+			regmap_update(map, reg);
+		}
+		else
+		{
+			Xil_Out32(map->base_addr + map->desc[i].reg_offset, reg->value);
+		}
+	}
+}
+
+int regmap_set(const regmap_t *map, regmap_reg_t *reg, uint32_t value)
+{
+	if (reg < map->regs || reg >= map->regs + map->nregs)
+	{
+		return -1;
+	}
+
+	const regmap_desc_t *desc = &(map->desc[reg - map->regs]);
+
+	if (desc->flags & REGMAP_RO)
+	{
+		return -1;
+	}
+
+	if (value < desc->min || value > desc->max)
+	{
+		return -1;
+	}
+	reg->value = value;
+
+	Xil_Out32(map->base_addr + desc->reg_offset, reg->value);
+
+	return 0;
+}
+
+int regmap_update(const regmap_t *map, regmap_reg_t *reg)
+{
+	const regmap_desc_t *desc = &(map->desc[reg - map->regs]);
+
+	volatile uint32_t value = Xil_In32(map->base_addr + desc->reg_offset);
+	reg->value = value & desc->reg_mask;
+
+	return 0;
+}
+
+const char *regmap_name(const regmap_t *map, const regmap_reg_t *reg)
+{
+	if (reg < map->regs || reg >= map->regs + map->nregs)
+	{
+		return NULL;
+	}
+
+	return map->desc[reg - map->regs].name;
+}
@@ -0,0 +1,395 @@
+/*
+ * script.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "script.h"
+#include "excecute.h"
+#include "uart.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+static script_state_t script;
+
+// Splits a copy of line in words. Returns the number of words.
+static int script_split(const char *line, char *copy, char *words[USERNUMBWORDS + 1])
+{
+	char *token;
+	char *rest;
+	int n = 0;
+
+	strcpy(copy, line);
+	rest = copy;
+	while ( (token = strtok_r(rest, " ", &rest)) && n <= USERNUMBWORDS )
+	{
+		words[n++] = token;
+	}
+
+	return n;
+}
+
+static script_t *script_find(const char *name)
+{
+	for (int i=0; i<SCRIPT_NSCRIPTS; i++)
+	{
+		if (script.scripts[i].nlines > 0 && strcmp(script.scripts[i].name, name) == 0)
+		{
+			return &script.scripts[i];
+		}
+	}
+
+	return NULL;
+}
+
+int script_record_start(const char *name)
+{
+	script_t *s = script_find(name);
+
+	if (strlen(name) >= SCRIPT_NAME_LENGTH || (s != NULL && s == script.run))
+	{
+		return -1;
+	}
+
+	strcpy(script.pending.name, name);
+	script.pending.nlines 	= 0;
+	script.rec_depth 		= 0;
+	script.recording 		= 1;
+
+	return 0;
+}
+
+int script_recording(void)
+{
+	return script.recording;
+}
+
+// Stores the pending script over the one with the same name, or in a free slot.
+static int script_store(void)
+{
+	script_t *s = script_find(script.pending.name);
+
+	for (int i=0; s == NULL && i<SCRIPT_NSCRIPTS; i++)
+	{
+		if (script.scripts[i].nlines == 0)
+		{
+			s = &script.scripts[i];
+		}
+	}
+	if (s == NULL)
+	{
+		return -1;
+	}
+
+	memcpy(s, &script.pending, sizeof(script_t));
+
+	return 0;
+}
+
+int script_record_line(const char *line, char *errStr)
+{
+	char copy[USERCOMMANDLENGTH];
+	char *words[USERNUMBWORDS + 1];
+	script_t *p = &script.pending;
+
+	if (strlen(line) >= SCRIPT_LINE_LENGTH)
+	{
+		io_sprintf(errStr, "### Script line longer than %d characters\r\n", SCRIPT_LINE_LENGTH - 1);
+		return -1;
+	}
+
+	int n = script_split(line, copy, words);
+	if (n == 0)
+	{
+		return 0;
+	}
+	if (n > USERNUMBWORDS)
+	{
+		io_sprintf(errStr, "### Script line with more than %d words\r\n", USERNUMBWORDS);
+		return -1;
+	}
+
+	if (strcmp(words[0], "end") == 0 && n == 1)
+	{
+		script.recording = 0;
+		if (script.rec_depth != 0)
+		{
+			io_sprintf(errStr, "### Script %s discarded: loop without endloop\r\n", p->name);
+			return -1;
+		}
+		if (p->nlines == 0 || script_store() != 0)
+		{
+			io_sprintf(errStr, "### Script %s discarded: empty or no free slot\r\n", p->name);
+			return -1;
+		}
+		return 0;
+	}
+
+	// Loops are checked here so the script can not fail on them when running.
+	if (strcmp(words[0], "loop") == 0)
+	{
+		if (n != 2 || str2num(words[1]) == 0 || script.rec_depth == SCRIPT_MAX_DEPTH)
+		{
+			io_sprintf(errStr, "### Usage: loop <n>, at most %d deep\r\n", SCRIPT_MAX_DEPTH);
+			return -1;
+		}
+		script.rec_depth++;
+	}
+	else if (strcmp(words[0], "endloop") == 0)
+	{
+		if (script.rec_depth == 0)
+		{
+			io_sprintf(errStr, "### endloop without loop\r\n");
+			return -1;
+		}
+		script.rec_depth--;
+	}
+	else if (strcmp(words[0], "wait") == 0)
+	{
+		if (n < 2 || n > 3 || (n == 3 && strcmp(words[1], "eos") != 0 && strcmp(words[1], "eot") != 0))
+		{
+			io_sprintf(errStr, "### Usage: wait <ms> | wait eos|eot [timeout]\r\n");
+			return -1;
+		}
+	}
+
+	if (p->nlines == SCRIPT_MAX_LINES)
+	{
+		io_sprintf(errStr, "### Script longer than %d lines\r\n", SCRIPT_MAX_LINES);
+		return -1;
+	}
+	strcpy(p->lines[p->nlines++], line);
+
+	return 0;
+}
+
+int script_delete(const char *name)
+{
+	script_t *s = script_find(name);
+
+	if (s == NULL || s == script.run)
+	{
+		return -1;
+	}
+	s->nlines = 0;
+
+	return 0;
+}
+
+void script_list(void)
+{
+	char str[100];
+
+	mprint("### Scripts ###\r\n");
+	for (int i=0; i<SCRIPT_NSCRIPTS; i++)
+	{
+		script_t *s = &script.scripts[i];
+		if (s->nlines > 0)
+		{
+			io_sprintf(str, "%s : %u lines%s\r\n", s->name, s->nlines, (s == script.run) ? ", running" : "");
+			mprint(str);
+			for (uint32_t j=0; j<s->nlines; j++)
+			{
+				io_sprintf(str, "  %s\r\n", s->lines[j]);
+				mprint(str);
+			}
+		}
+	}
+}
+
+int script_run(const char *name, const char *arg1, const char *arg2)
+{
+	script_t *s = script_find(name);
+
+	if (s == NULL || script.run != NULL || script.recording)
+	{
+		return -1;
+	}
+
+	strncpy(script.args[0], (arg1 != NULL) ? arg1 : "", USERWORDLENTHG - 1);
+	strncpy(script.args[1], (arg2 != NULL) ? arg2 : "", USERWORDLENTHG - 1);
+	script.pc 		= 0;
+	script.depth 	= 0;
+	script.events 	= 0;
+	script.waiting 	= 0;
+	script.t0 		= tget_ms();
+	script.run 		= s;
+
+	return 0;
+}
+
+static void script_end(const char *how)
+{
+	char str[100];
+
+	io_sprintf(str, "Script %s %s at line %u after %u ms\r\n",
+			script.run->name, (char *) how, script.pc, tget_ms() - script.t0);
+	mprint(str);
+	script.run = NULL;
+}
+
+void script_stop(void)
+{
+	if (script.run != NULL)
+	{
+		script_end("stopped");
+	}
+}
+
+int script_running(void)
+{
+	return script.run != NULL;
+}
+
+void script_event(uint32_t event)
+{
+	script.events |= event;
+}
+
+// Replaces $i, $1 and $2. Returns -1 if the result does not fit.
+static int script_substitute(const char *line, char *out)
+{
+	char num[12];
+	uint32_t n = 0;
+
+	for (const char *c = line; *c != '\0'; c++)
+	{
+		const char *val = NULL;
+
+		if (c[0] == '$' && c[1] == 'i')
+		{
+			io_sprintf(num, "%u", (script.depth > 0) ? script.loops[script.depth-1].index : 0);
+			val = num;
+		}
+		else if (c[0] == '$' && c[1] >= '1' && c[1] < '1' + SCRIPT_NARGS)
+		{
+			val = script.args[c[1] - '1'];
+		}
+
+		if (val != NULL)
+		{
+			uint32_t len = strlen(val);
+			if (n + len >= USERCOMMANDLENGTH)
+			{
+				return -1;
+			}
+			strcpy(out + n, val);
+			n += len;
+			c++;
+		}
+		else
+		{
+			if (n + 1 >= USERCOMMANDLENGTH)
+			{
+				return -1;
+			}
+			out[n++] = *c;
+		}
+	}
+	out[n] = '\0';
+
+	return 0;
+}
+
+void script_poll(system_state_t *sys)
+{
+	char copy[USERCOMMANDLENGTH];
+	char *words[USERNUMBWORDS + 1];
+	char errStr[256];
+
+	if (script.run == NULL)
+	{
+		return;
+	}
+
+	if (script.waiting)
+	{
+		uint32_t elapsed = tget_ms() - script.wait_t0;
+
+		if (script.wait_events == 0)
+		{
+			if (elapsed < script.wait_ms)
+			{
+				return;
+			}
+		}
+		else if (script.events & script.wait_events)
+		{
+			script.events &= ~script.wait_events;
+		}
+		else if (script.wait_ms > 0 && elapsed >= script.wait_ms)
+		{
+			script_end("timed out");
+			return;
+		}
+		else
+		{
+			return;
+		}
+		script.waiting = 0;
+	}
+
+	if (script.pc == script.run->nlines)
+	{
+		script_end("done");
+		return;
+	}
+
+	const char *line = script.run->lines[script.pc++];
+	int n = script_split(line, copy, words);
+
+	if (strcmp(words[0], "loop") == 0)
+	{
+		script_loop_t *l = &script.loops[script.depth++];
+		l->start = script.pc;
+		l->count = str2num(words[1]);
+		l->index = 0;
+	}
+	else if (strcmp(words[0], "endloop") == 0)
+	{
+		script_loop_t *l = &script.loops[script.depth-1];
+		if (++l->index < l->count)
+		{
+			script.pc = l->start;
+		}
+		else
+		{
+			script.depth--;
+		}
+	}
+	else if (strcmp(words[0], "wait") == 0)
+	{
+		script.wait_t0 		= tget_ms();
+		script.waiting 		= 1;
+		if (strcmp(words[1], "eos") == 0 || strcmp(words[1], "eot") == 0)
+		{
+			script.wait_events 	= (words[1][2] == 's') ? SCRIPT_EVENT_EOS : SCRIPT_EVENT_EOT;
+			script.wait_ms 		= (n == 3) ? str2num(words[2]) : 0;
+		}
+		else
+		{
+			script.wait_events 	= 0;
+			script.wait_ms 		= str2num(words[1]);
+		}
+	}
+	else
+	{
+		if (script_substitute(line, copy) != 0)
+		{
+			script_end("stopped, line too long,");
+			return;
+		}
+
+		// Only events caused by this command count for the next wait.
+		script.events = 0;
+		if (excecute_interpret(sys, copy, errStr) != 0)
+		{
+			mprint(errStr);
+			script_end("failed");
+		}
+	}
+}
@@ -24,13 +24,13 @@ int sequencer_init(seq_t *seq)
 	seq->sw_group.stop.min = 0;
 	seq->sw_group.stop.max = 1;
 	seq->sw_group.stop.reg_offset = SEQUENCER_STOP_SEQUENCE_OFFSET;
-	strcpy(seq->sw_group.stop.name,"seqStart");
+	seq->sw_group.stop.name = "seqStart";
 
 	seq->sw_group.stop_src.status = SEQUENCER_STOP_SRC_INTERNAL;
 	seq->sw_group.stop_src.min = SEQUENCER_STOP_SRC_INTERNAL;
 	seq->sw_group.stop_src.max = SEQUENCER_STOP_SRC_EXTERNAL;
 	seq->sw_group.stop_src.reg_offset = SEQUENCER_STOP_SRC_OFFSET;
-	strcpy(seq->sw_group.stop_src.name,"seqStartSrc");
+	seq->sw_group.stop_src.name = "seqStartSrc";
 
 	// Write values to hardware.
 	seq_change_sw_status(&(seq->sw_group.stop), seq->sw_group.stop.status);
@@ -38,7 +38,7 @@ int sequencer_init(seq_t *seq)
 
 	//initialize sequencer
 	seq->sequencer.size = SEQUENCER_MEMORY_SIZE;
-	strcpy(seq->sequencer.name,"sequencer");
+	seq->sequencer.name = "sequencer";
 
 	//bring default sequencer to RAM
 	int status = 0;
@@ -71,7 +71,7 @@ int sequencer_reset_program(seq_t *seq)
 
 	//load sequencer to variable
 	unsigned int seqInd = DEFAULT_SEQUENCER;
-	strcpy(seq->sequencer.name,seqComment[seqInd]);
+	seq->sequencer.name = seqComment[seqInd];
 
 	uint32_t *program = (uint32_t *) seqPointer[seqInd];
 	for (int i=0; i<seqSize[seqInd];i++)
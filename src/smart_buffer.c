@@ -10,210 +10,45 @@
 
 #include "smart_buffer.h"
 #include "io_func.h"
+#include "interrupt.h"
 
-void smart_buffer_init(smart_buffer_group_status_t *smart_buffer)
-{
+#define SMART_BUFFER_DESC(field, reg, name, value, min, max, flags) \
+	{ name, SMART_BUFFER_##reg##_REG_OFFSET, SMART_BUFFER_##reg##_REG_MASK, value, min, max, flags },
+
+static const regmap_desc_t smart_buffer_desc[] = { SMART_BUFFER_REGS(SMART_BUFFER_DESC) };
 
-	smart_buffer->cha_sel.value 				= SMART_BUFFER_CHX_SEL_CHA;
-	smart_buffer->cha_sel.min 					= SMART_BUFFER_CHX_SEL_CHA;
-	smart_buffer->cha_sel.max 					= SMART_BUFFER_CHX_SEL_CHD;
-	smart_buffer->cha_sel.reg_offset 			= SMART_BUFFER_CHA_SEL_REG_OFFSET;
-	smart_buffer->cha_sel.reg_mask 				= SMART_BUFFER_CHA_SEL_REG_MASK;
-	strcpy(smart_buffer->cha_sel.name,"bufASel");
-
-	smart_buffer->chb_sel.value 				= SMART_BUFFER_CHX_SEL_CHB;
-	smart_buffer->chb_sel.min 					= SMART_BUFFER_CHX_SEL_CHA;
-	smart_buffer->chb_sel.max 					= SMART_BUFFER_CHX_SEL_CHD;
-	smart_buffer->chb_sel.reg_offset 			= SMART_BUFFER_CHB_SEL_REG_OFFSET;
-	smart_buffer->chb_sel.reg_mask 				= SMART_BUFFER_CHB_SEL_REG_MASK;
-	strcpy(smart_buffer->chb_sel.name,"bufBSel");
-
-	smart_buffer->chc_sel.value 				= SMART_BUFFER_CHX_SEL_CHC;
-	smart_buffer->chc_sel.min 					= SMART_BUFFER_CHX_SEL_CHA;
-	smart_buffer->chc_sel.max 					= SMART_BUFFER_CHX_SEL_CHD;
-	smart_buffer->chc_sel.reg_offset 			= SMART_BUFFER_CHC_SEL_REG_OFFSET;
-	smart_buffer->chc_sel.reg_mask 				= SMART_BUFFER_CHC_SEL_REG_MASK;
-	strcpy(smart_buffer->chc_sel.name,"bufCSel");
-
-	smart_buffer->chd_sel.value 				= SMART_BUFFER_CHX_SEL_CHD;
-	smart_buffer->chd_sel.min 					= SMART_BUFFER_CHX_SEL_CHA;
-	smart_buffer->chd_sel.max 					= SMART_BUFFER_CHX_SEL_CHD;
-	smart_buffer->chd_sel.reg_offset 			= SMART_BUFFER_CHD_SEL_REG_OFFSET;
-	smart_buffer->chd_sel.reg_mask 				= SMART_BUFFER_CHD_SEL_REG_MASK;
-	strcpy(smart_buffer->chd_sel.name,"bufDSel");
-
-	smart_buffer->cha_nsamp.value 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->cha_nsamp.min 				= SMART_BUFFER_NSAMP_MIN;
-	smart_buffer->cha_nsamp.max 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->cha_nsamp.reg_offset 			= SMART_BUFFER_CHA_NSAMP_REG_OFFSET;
-	smart_buffer->cha_nsamp.reg_mask 			= SMART_BUFFER_CHA_NSAMP_REG_MASK;
-	strcpy(smart_buffer->cha_nsamp.name,"bufASamp");
-
-	smart_buffer->chb_nsamp.value 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->chb_nsamp.min 				= SMART_BUFFER_NSAMP_MIN;
-	smart_buffer->chb_nsamp.max 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->chb_nsamp.reg_offset 			= SMART_BUFFER_CHB_NSAMP_REG_OFFSET;
-	smart_buffer->chb_nsamp.reg_mask 			= SMART_BUFFER_CHB_NSAMP_REG_MASK;
-	strcpy(smart_buffer->chb_nsamp.name,"bufBSamp");
-
-	smart_buffer->chc_nsamp.value 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->chc_nsamp.min 				= SMART_BUFFER_NSAMP_MIN;
-	smart_buffer->chc_nsamp.max 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->chc_nsamp.reg_offset 			= SMART_BUFFER_CHC_NSAMP_REG_OFFSET;
-	smart_buffer->chc_nsamp.reg_mask 			= SMART_BUFFER_CHC_NSAMP_REG_MASK;
-	strcpy(smart_buffer->chc_nsamp.name,"bufCSamp");
-
-	smart_buffer->chd_nsamp.value 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->chd_nsamp.min 				= SMART_BUFFER_NSAMP_MIN;
-	smart_buffer->chd_nsamp.max 				= SMART_BUFFER_NSAMP_MAX;
-	smart_buffer->chd_nsamp.reg_offset 			= SMART_BUFFER_CHD_NSAMP_REG_OFFSET;
-	smart_buffer->chd_nsamp.reg_mask 			= SMART_BUFFER_CHD_NSAMP_REG_MASK;
-	strcpy(smart_buffer->chd_nsamp.name,"bufDSamp");
-
-	smart_buffer->ch_mode.value 				= SMART_BUFFER_CH_MODE_SINGLE;
-	smart_buffer->ch_mode.min 					= SMART_BUFFER_CH_MODE_SINGLE;
-	smart_buffer->ch_mode.max 					= SMART_BUFFER_CH_MODE_QUAD;
-	smart_buffer->ch_mode.reg_offset 			= SMART_BUFFER_CH_MODE_REG_OFFSET;
-	smart_buffer->ch_mode.reg_mask 				= SMART_BUFFER_CH_MODE_REG_MASK;
-	strcpy(smart_buffer->ch_mode.name,"bufChMode");
-
-	smart_buffer->dataa_mode.value 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->dataa_mode.min 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->dataa_mode.max 				= SMART_BUFFER_DATAX_MODE_NSAMP;
-	smart_buffer->dataa_mode.reg_offset 		= SMART_BUFFER_DATAA_MODE_REG_OFFSET;
-	smart_buffer->dataa_mode.reg_mask 			= SMART_BUFFER_DATAA_MODE_REG_MASK;
-	strcpy(smart_buffer->dataa_mode.name,"bufAMode");
-
-	smart_buffer->datab_mode.value 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->datab_mode.min 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->datab_mode.max 				= SMART_BUFFER_DATAX_MODE_NSAMP;
-	smart_buffer->datab_mode.reg_offset 		= SMART_BUFFER_DATAB_MODE_REG_OFFSET;
-	smart_buffer->datab_mode.reg_mask 			= SMART_BUFFER_DATAB_MODE_REG_MASK;
-	strcpy(smart_buffer->datab_mode.name,"bufBMode");
-
-	smart_buffer->datac_mode.value 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->datac_mode.min 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->datac_mode.max 				= SMART_BUFFER_DATAX_MODE_NSAMP;
-	smart_buffer->datac_mode.reg_offset 		= SMART_BUFFER_DATAC_MODE_REG_OFFSET;
-	smart_buffer->datac_mode.reg_mask 			= SMART_BUFFER_DATAC_MODE_REG_MASK;
-	strcpy(smart_buffer->datac_mode.name,"bufCMode");
-
-	smart_buffer->datad_mode.value 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->datad_mode.min 				= SMART_BUFFER_DATAX_MODE_FULL;
-	smart_buffer->datad_mode.max 				= SMART_BUFFER_DATAX_MODE_NSAMP;
-	smart_buffer->datad_mode.reg_offset 		= SMART_BUFFER_DATAD_MODE_REG_OFFSET;
-	smart_buffer->datad_mode.reg_mask 			= SMART_BUFFER_DATAD_MODE_REG_MASK;
-	strcpy(smart_buffer->datad_mode.name,"bufDMode");
-
-	smart_buffer->capture_mode.value 			= SMART_BUFFER_CAPTURE_MODE_SINGLE;
-	smart_buffer->capture_mode.min 				= SMART_BUFFER_CAPTURE_MODE_SINGLE;
-	smart_buffer->capture_mode.max 				= SMART_BUFFER_CAPTURE_MODE_CONTINUOUS;
-	smart_buffer->capture_mode.reg_offset 		= SMART_BUFFER_CAPTURE_MODE_REG_OFFSET;
-	smart_buffer->capture_mode.reg_mask 		= SMART_BUFFER_CAPTURE_MODE_REG_MASK;
-	strcpy(smart_buffer->capture_mode.name,"bufCapMode");
-
-	smart_buffer->capture_en_src.value 			= SMART_BUFFER_CAPTURE_EN_SRC_INTERNAL;
-	smart_buffer->capture_en_src.min 			= SMART_BUFFER_CAPTURE_EN_SRC_EXTERNAL;
-	smart_buffer->capture_en_src.max 			= SMART_BUFFER_CAPTURE_EN_SRC_INTERNAL;
-	smart_buffer->capture_en_src.reg_offset 	= SMART_BUFFER_CAPTURE_EN_SRC_REG_OFFSET;
-	smart_buffer->capture_en_src.reg_mask 		= SMART_BUFFER_CAPTURE_EN_SRC_REG_MASK;
-	strcpy(smart_buffer->capture_en_src.name,"bufCapSrc");
-
-	smart_buffer->capture_start.value 			= SMART_BUFFER_CAPTURE_STOP;
-	smart_buffer->capture_start.min 			= SMART_BUFFER_CAPTURE_STOP;
-	smart_buffer->capture_start.max 			= SMART_BUFFER_CAPTURE_START;
-	smart_buffer->capture_start.reg_offset 		= SMART_BUFFER_CAPTURE_START_REG_OFFSET;
-	smart_buffer->capture_start.reg_mask 		= SMART_BUFFER_CAPTURE_START_REG_MASK;
-	strcpy(smart_buffer->capture_start.name,"bufCapStart");
-
-	smart_buffer->capture_end.value 			= 0;
-	smart_buffer->capture_end.min 				= SMART_BUFFER_CAPTURE_RUNNING;
-	smart_buffer->capture_end.max 				= SMART_BUFFER_CAPTURE_FINISHED;
-	smart_buffer->capture_end.reg_offset 		= SMART_BUFFER_CAPTURE_END_REG_OFFSET;
-	smart_buffer->capture_end.reg_mask 			= SMART_BUFFER_CAPTURE_END_REG_MASK;
-	strcpy(smart_buffer->capture_end.name,"bufCapEnd");
-
-	smart_buffer->speed_ctrl.value 				= 1000;
-	smart_buffer->speed_ctrl.min 				= SMART_BUFFER_SPEED_CTRL_MIN;
-	smart_buffer->speed_ctrl.max 				= SMART_BUFFER_SPEED_CTRL_MAX;
-	smart_buffer->speed_ctrl.reg_offset 		= SMART_BUFFER_SPEED_CTRL_REG_OFFSET;
-	smart_buffer->speed_ctrl.reg_mask 			= SMART_BUFFER_SPEED_CTRL_REG_MASK;
-	strcpy(smart_buffer->speed_ctrl.name,"bufSpeed");
-
-	smart_buffer->transfer_start.value 			= SMART_BUFFER_TRNASFER_STOP;
-	smart_buffer->transfer_start.min 			= SMART_BUFFER_TRNASFER_STOP;
-	smart_buffer->transfer_start.max 			= SMART_BUFFER_TRANSFER_START;
-	smart_buffer->transfer_start.reg_offset 	= SMART_BUFFER_TRANSFER_START_REG_OFFSET;
-	smart_buffer->transfer_start.reg_mask 		= SMART_BUFFER_TRANSFER_START_REG_MASK;
-	strcpy(smart_buffer->transfer_start.name,"bufTraStart");
-
-	smart_buffer->transfer_end.value 			= 0;
-	smart_buffer->transfer_end.min 				= SMART_BUFFER_TRANSFER_RUNNING;
-	smart_buffer->transfer_end.max 				= SMART_BUFFER_TRANSFER_FINISHED;
-	smart_buffer->transfer_end.reg_offset 		= SMART_BUFFER_TRANSFER_END_REG_OFFSET;
-	smart_buffer->transfer_end.reg_mask 		= SMART_BUFFER_TRANSFER_END_REG_MASK;
-	strcpy(smart_buffer->transfer_end.name,"bufTraEnd");
-
-	smart_buffer->reset.value 					= SMART_BUFFER_RESET_OFF;
-	smart_buffer->reset.min 					= SMART_BUFFER_RESET_OFF;
-	smart_buffer->reset.max 					= SMART_BUFFER_RESET_ON;
-	smart_buffer->reset.reg_offset 				= SMART_BUFFER_RESET_REG_OFFSET;
-	smart_buffer->reset.reg_mask 				= SMART_BUFFER_RESET_REG_MASK;
-	strcpy(smart_buffer->reset.name,"bufReset");
-
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->cha_sel.reg_offset, 		smart_buffer->cha_sel.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->chb_sel.reg_offset, 		smart_buffer->chb_sel.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->chc_sel.reg_offset, 		smart_buffer->chc_sel.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->chd_sel.reg_offset, 		smart_buffer->chd_sel.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->cha_nsamp.reg_offset, 		smart_buffer->cha_nsamp.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->chb_nsamp.reg_offset, 		smart_buffer->chb_nsamp.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->chc_nsamp.reg_offset, 		smart_buffer->chc_nsamp.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->chd_nsamp.reg_offset, 		smart_buffer->chd_nsamp.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->ch_mode.reg_offset, 		smart_buffer->ch_mode.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->dataa_mode.reg_offset, 	smart_buffer->dataa_mode.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->datab_mode.reg_offset, 	smart_buffer->datab_mode.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->datac_mode.reg_offset,		smart_buffer->datac_mode.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->datad_mode.reg_offset, 	smart_buffer->datad_mode.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->capture_mode.reg_offset, 	smart_buffer->capture_mode.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->capture_en_src.reg_offset, smart_buffer->capture_en_src.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->capture_start.reg_offset, 	smart_buffer->capture_start.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->speed_ctrl.reg_offset, 	smart_buffer->speed_ctrl.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->transfer_start.reg_offset, smart_buffer->transfer_start.value);
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->reset.reg_offset, 			smart_buffer->reset.value);
-
-	// Read actual value of capture_end and transfer_end registers.
-	volatile uint32_t value;
-	value = SMART_BUFFER_mReadReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->capture_end.reg_offset);
-	smart_buffer->capture_end.value = (uint16_t)value;
-	value = SMART_BUFFER_mReadReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->transfer_end.reg_offset);
-	smart_buffer->transfer_end.value = (uint16_t)value;
+static regmap_t smart_buffer_map = {
+	.base_addr 	= XPAR_SMART_BUFFER_BASEADDR,
+	.desc 		= smart_buffer_desc,
+	.nregs 		= REGMAP_NREGS(smart_buffer_desc),
+};
 
+void smart_buffer_init(smart_buffer_group_status_t *smart_buffer)
+{
+	// Defaults to hardware, capture_end and transfer_end read back.
+	regmap_init(&smart_buffer_map, (regmap_reg_t *) smart_buffer);
 }
 
 int smart_buffer_change_status(smart_buffer_status_t *reg, uint16_t value)
 {
-	if (value >= reg->min && value <= reg->max)
-	{
-		reg->value = value;
-	} else {
-		return -1;
-	}
-
-	SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, reg->reg_offset,(uint32_t) reg->value);
+	return regmap_set(&smart_buffer_map, reg, value);
+}
 
-	return 0;
+const char *smart_buffer_reg_name(const smart_buffer_status_t *reg)
+{
+	return regmap_name(&smart_buffer_map, reg);
 }
 
 int smart_buffer_eoc(smart_buffer_group_status_t *smart_buffer)
 {
-	volatile uint32_t end = SMART_BUFFER_mReadReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->capture_end.reg_offset);
+	volatile uint32_t end = SMART_BUFFER_mReadReg(XPAR_SMART_BUFFER_BASEADDR, SMART_BUFFER_CAPTURE_END_REG_OFFSET);
 
 	// Check if the capture has finished.
 	if(end)
 	{
 		// If it finished, STOP capture unit.
 		smart_buffer->capture_start.value = SMART_BUFFER_CAPTURE_STOP;
-		SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->capture_start.reg_offset, smart_buffer->capture_start.value);
+		SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, SMART_BUFFER_CAPTURE_START_REG_OFFSET, smart_buffer->capture_start.value);
 		return 1;
 	}
 	else
@@ -225,14 +60,14 @@ int smart_buffer_eoc(smart_buffer_group_status_t *smart_buffer)
 
 int smart_buffer_eot(smart_buffer_group_status_t *smart_buffer)
 {
-	volatile uint32_t end = SMART_BUFFER_mReadReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->transfer_end.reg_offset);
+	volatile uint32_t end = SMART_BUFFER_mReadReg(XPAR_SMART_BUFFER_BASEADDR, SMART_BUFFER_TRANSFER_END_REG_OFFSET);
 
 	// Check if the transfer has finished.
 	if(end)
 	{
 		// If it finished, STOP transfer unit.
 		smart_buffer->transfer_start.value = SMART_BUFFER_TRNASFER_STOP;
-		SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, smart_buffer->transfer_start.reg_offset, smart_buffer->transfer_start.value);
+		SMART_BUFFER_mWriteReg(XPAR_SMART_BUFFER_BASEADDR, SMART_BUFFER_TRANSFER_START_REG_OFFSET, smart_buffer->transfer_start.value);
 		return 1;
 	}
 	else
@@ -242,3 +77,247 @@ int smart_buffer_eot(smart_buffer_group_status_t *smart_buffer)
 	}
 
 }
+
+void smart_buffer_stream_init(smart_buffer_stream_t *stream)
+{
+	stream->vars.enable.value 	= SMART_BUFFER_STREAM_OFF;
+	stream->vars.enable.min 	= SMART_BUFFER_STREAM_OFF;
+	stream->vars.enable.max 	= SMART_BUFFER_STREAM_ON;
+	stream->vars.enable.name = "bufStream";
+
+	stream->vars.nblocks.value 	= SMART_BUFFER_STREAM_BLOCKS_MIN;
+	stream->vars.nblocks.min 	= SMART_BUFFER_STREAM_BLOCKS_MIN;
+	stream->vars.nblocks.max 	= SMART_BUFFER_STREAM_BLOCKS_MAX;
+	stream->vars.nblocks.name = "bufStrmBlocks";
+
+	stream->vars.count.value 	= 0;
+	stream->vars.count.min 		= 0;
+	stream->vars.count.max 		= 0;
+	stream->vars.count.name = "bufStrmCount";
+
+	stream->running = 0;
+}
+
+static void smart_buffer_stream_arm(smart_buffer_group_status_t *smart_buffer)
+{
+	// Transfer waits for the capture to finish, so both can be started together.
+	smart_buffer_change_status(&(smart_buffer->capture_start), SMART_BUFFER_CAPTURE_START);
+	smart_buffer_change_status(&(smart_buffer->transfer_start), SMART_BUFFER_TRANSFER_START);
+}
+
+int smart_buffer_stream_change_status(smart_buffer_stream_t *stream, smart_buffer_var_t *var, smart_buffer_group_status_t *smart_buffer, uint16_t value)
+{
+	if (value >= var->min && value <= var->max)
+	{
+		var->value = value;
+	} else {
+		return -1;
+	}
+
+	if (var == &(stream->vars.enable))
+	{
+		if (value == SMART_BUFFER_STREAM_ON && !stream->running)
+		{
+			// A continuous capture never ends by itself.
+			if (smart_buffer->capture_mode.value != SMART_BUFFER_CAPTURE_MODE_SINGLE)
+			{
+				var->value = SMART_BUFFER_STREAM_OFF;
+				return -1;
+			}
+
+			stream->vars.count.value = 0;
+			stream->running = 1;
+			smart_buffer_stream_arm(smart_buffer);
+		}
+		// When switched off, the block in progress ends normally in the main loop.
+	}
+
+	return 0;
+}
+
+int smart_buffer_stream_next(smart_buffer_stream_t *stream, smart_buffer_group_status_t *smart_buffer)
+{
+	// Not streaming: nothing to do.
+	if (!stream->running)
+	{
+		return 0;
+	}
+
+	stream->vars.count.value++;
+
+	// Check if the stream has to go on.
+	if ( 	(stream->vars.enable.value == SMART_BUFFER_STREAM_ON) &&
+			( 	(stream->vars.nblocks.value == 0) ||
+				(stream->vars.count.value < stream->vars.nblocks.value) ) )
+	{
+		smart_buffer_stream_arm(smart_buffer);
+		return 1;
+	}
+
+	// Stream finished.
+	stream->vars.enable.value = SMART_BUFFER_STREAM_OFF;
+	stream->running = 0;
+
+	return 0;
+}
+
+void smart_buffer_trig_init(smart_buffer_trig_t *trig)
+{
+	trig->vars.arm.value 		= SMART_BUFFER_TRIG_DISARM;
+	trig->vars.arm.min 			= SMART_BUFFER_TRIG_DISARM;
+	trig->vars.arm.max 			= SMART_BUFFER_TRIG_ARM;
+	trig->vars.arm.name = "bufTrigArm";
+
+	trig->vars.src.value 		= SMART_BUFFER_TRIG_SRC_SOFT;
+	trig->vars.src.min 			= SMART_BUFFER_TRIG_SRC_SOFT;
+	trig->vars.src.max 			= SMART_BUFFER_TRIG_SRC_SEQ;
+	trig->vars.src.name = "bufTrigSrc";
+
+	trig->vars.post.value 		= 0;
+	trig->vars.post.min 		= 0;
+	trig->vars.post.max 		= SMART_BUFFER_TRIG_TIME_MAX;
+	trig->vars.post.name = "bufTrigPost";
+
+	trig->vars.trig.value 		= 0;
+	trig->vars.trig.min 		= 0;
+	trig->vars.trig.max 		= 1;
+	trig->vars.trig.name = "bufTrig";
+
+	// Read only variables.
+	trig->vars.state.value 		= SMART_BUFFER_TRIG_STATE_IDLE;
+	trig->vars.state.min 		= 0;
+	trig->vars.state.max 		= 0;
+	trig->vars.state.name = "bufTrigState";
+
+	trig->vars.pre_act.value 	= 0;
+	trig->vars.pre_act.min 		= 0;
+	trig->vars.pre_act.max 		= 0;
+	trig->vars.pre_act.name = "bufTrigPre";
+
+	trig->vars.post_act.value 	= 0;
+	trig->vars.post_act.min 	= 0;
+	trig->vars.post_act.max 	= 0;
+	trig->vars.post_act.name = "bufTrigPostAct";
+
+	trig->arm_tick 		= 0;
+	trig->trig_tick 	= 0;
+	trig->capture_mode 	= SMART_BUFFER_CAPTURE_MODE_SINGLE;
+}
+
+static uint16_t smart_buffer_trig_elapsed(uint32_t t0, uint32_t t1)
+{
+	uint32_t dt = t1 - t0;
+	if (dt > SMART_BUFFER_TRIG_TIME_MAX)
+	{
+		dt = SMART_BUFFER_TRIG_TIME_MAX;
+	}
+	return (uint16_t)dt;
+}
+
+int smart_buffer_trig_change_status(smart_buffer_trig_t *trig, smart_buffer_var_t *var, smart_buffer_group_status_t *smart_buffer, uint16_t value)
+{
+	// Results cannot be written.
+	if (	var == &(trig->vars.state) 		||
+			var == &(trig->vars.pre_act) 	||
+			var == &(trig->vars.post_act) )
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+
+	// Arm/disarm.
+	if (var == &(trig->vars.arm))
+	{
+		if (value == SMART_BUFFER_TRIG_ARM)
+		{
+			// Buffer busy with another capture.
+			if (	trig->vars.state.value == SMART_BUFFER_TRIG_STATE_ARMED 	||
+					trig->vars.state.value == SMART_BUFFER_TRIG_STATE_TRIGGERED ||
+					smart_buffer->capture_start.value == SMART_BUFFER_CAPTURE_START )
+			{
+				return -1;
+			}
+
+			// Start a continuous capture. Previous mode is restored when done.
+			trig->capture_mode = smart_buffer->capture_mode.value;
+			smart_buffer_change_status(&(smart_buffer->capture_mode), SMART_BUFFER_CAPTURE_MODE_CONTINUOUS);
+			smart_buffer_change_status(&(smart_buffer->capture_start), SMART_BUFFER_CAPTURE_START);
+
+			trig->arm_tick 				= tget_ms();
+			trig->vars.pre_act.value 	= 0;
+			trig->vars.post_act.value 	= 0;
+			trig->vars.state.value 		= SMART_BUFFER_TRIG_STATE_ARMED;
+		}
+		else if (trig->vars.state.value == SMART_BUFFER_TRIG_STATE_ARMED ||
+				 trig->vars.state.value == SMART_BUFFER_TRIG_STATE_TRIGGERED)
+		{
+			// Disarm: drop the capture.
+			smart_buffer_change_status(&(smart_buffer->capture_start), SMART_BUFFER_CAPTURE_STOP);
+			smart_buffer_change_status(&(smart_buffer->reset), SMART_BUFFER_RESET_ON);
+			smart_buffer_change_status(&(smart_buffer->reset), SMART_BUFFER_RESET_OFF);
+			smart_buffer_change_status(&(smart_buffer->capture_mode), trig->capture_mode);
+
+			trig->vars.state.value = SMART_BUFFER_TRIG_STATE_IDLE;
+		}
+		var->value = value;
+		return 0;
+	}
+
+	// Software trigger.
+	if (var == &(trig->vars.trig))
+	{
+		if (value)
+		{
+			return smart_buffer_trig_event(trig, SMART_BUFFER_TRIG_SRC_SOFT);
+		}
+		return 0;
+	}
+
+	var->value = value;
+
+	return 0;
+}
+
+int smart_buffer_trig_event(smart_buffer_trig_t *trig, uint16_t src)
+{
+	// Only trigger when armed and for the selected source.
+	if (trig->vars.state.value != SMART_BUFFER_TRIG_STATE_ARMED || trig->vars.src.value != src)
+	{
+		return -1;
+	}
+
+	trig->trig_tick 			= tget_ms();
+	trig->vars.pre_act.value 	= smart_buffer_trig_elapsed(trig->arm_tick, trig->trig_tick);
+	trig->vars.state.value 		= SMART_BUFFER_TRIG_STATE_TRIGGERED;
+
+	return 0;
+}
+
+int smart_buffer_trig_poll(smart_buffer_trig_t *trig, smart_buffer_group_status_t *smart_buffer)
+{
+	if (trig->vars.state.value != SMART_BUFFER_TRIG_STATE_TRIGGERED)
+	{
+		return 0;
+	}
+
+	uint32_t now = tget_ms();
+	if ((now - trig->trig_tick) < trig->vars.post.value)
+	{
+		return 0;
+	}
+
+	// Post-trigger time elapsed: stop capture and send data.
+	smart_buffer_change_status(&(smart_buffer->capture_start), SMART_BUFFER_CAPTURE_STOP);
+	smart_buffer_change_status(&(smart_buffer->transfer_start), SMART_BUFFER_TRANSFER_START);
+	smart_buffer_change_status(&(smart_buffer->capture_mode), trig->capture_mode);
+
+	trig->vars.post_act.value 	= smart_buffer_trig_elapsed(trig->trig_tick, now);
+	trig->vars.arm.value 		= SMART_BUFFER_TRIG_DISARM;
+	trig->vars.state.value 		= SMART_BUFFER_TRIG_STATE_DONE;
+
+	return 1;
+}
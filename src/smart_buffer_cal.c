@@ -0,0 +1,269 @@
+/*
+ * smart_buffer_cal.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <xil_printf.h>
+#include "xil_io.h"
+
+#include "smart_buffer_cal.h"
+#include "io_func.h"
+
+void smart_buffer_cal_init(system_state_t *sys)
+{
+	smart_buffer_cal_t *cal = &(sys->smart_buffer_cal);
+	flash_params_t params;
+
+	cal->vars.start.value 	= 0;
+	cal->vars.start.min 	= 0;
+	cal->vars.start.max 	= 1;
+	cal->vars.start.name = "bufCalStart";
+
+	cal->vars.result.value 	= 0;
+	cal->vars.result.min 	= 0;
+	cal->vars.result.max 	= 1;
+	cal->vars.result.name = "bufCalRes";
+
+	// Read only variables.
+	cal->vars.speed.value 	= 0;
+	cal->vars.speed.min 	= 0;
+	cal->vars.speed.max 	= 0;
+	cal->vars.speed.name = "bufCalSpeed";
+
+	cal->vars.state.value 	= SMART_BUFFER_CAL_STATE_IDLE;
+	cal->vars.state.min 	= 0;
+	cal->vars.state.max 	= 0;
+	cal->vars.state.name = "bufCalState";
+
+	cal->speed_ok 	= -1;
+	cal->speed_bad 	= -1;
+
+	// Restore calibrated speed, if any.
+	if (flash_readParams(&params) == XST_SUCCESS)
+	{
+		smart_buffer_change_status(&(sys->smart_buffer.speed_ctrl), params.buf_speed);
+	}
+}
+
+static void smart_buffer_cal_step(system_state_t *sys, uint16_t speed)
+{
+	smart_buffer_group_status_t *sb = &(sys->smart_buffer);
+
+	sys->smart_buffer_cal.vars.speed.value = speed;
+	smart_buffer_change_status(&(sb->speed_ctrl), speed);
+
+	// Transfer waits for the capture to finish.
+	smart_buffer_change_status(&(sb->capture_start), SMART_BUFFER_CAPTURE_START);
+	smart_buffer_change_status(&(sb->transfer_start), SMART_BUFFER_TRANSFER_START);
+
+	sys->smart_buffer_cal.vars.state.value = SMART_BUFFER_CAL_STATE_TRANSFER;
+}
+
+static void smart_buffer_cal_restore(system_state_t *sys, uint16_t speed)
+{
+	smart_buffer_cal_t *cal = &(sys->smart_buffer_cal);
+	smart_buffer_group_status_t *sb = &(sys->smart_buffer);
+
+	// Drop anything left in the buffer.
+	smart_buffer_change_status(&(sb->capture_start), SMART_BUFFER_CAPTURE_STOP);
+	smart_buffer_change_status(&(sb->transfer_start), SMART_BUFFER_TRNASFER_STOP);
+	smart_buffer_change_status(&(sb->reset), SMART_BUFFER_RESET_ON);
+	smart_buffer_change_status(&(sb->reset), SMART_BUFFER_RESET_OFF);
+
+	smart_buffer_change_status(&(sb->cha_sel), 			cal->cha_sel);
+	smart_buffer_change_status(&(sb->cha_nsamp), 		cal->cha_nsamp);
+	smart_buffer_change_status(&(sb->ch_mode), 			cal->ch_mode);
+	smart_buffer_change_status(&(sb->dataa_mode), 		cal->dataa_mode);
+	smart_buffer_change_status(&(sb->capture_mode), 	cal->capture_mode);
+	smart_buffer_change_status(&(sb->capture_en_src), 	cal->capture_en_src);
+	smart_buffer_change_status(&(sb->speed_ctrl), 		speed);
+
+	packer_change_sw_status(&(sys->packer_sw.start), 	cal->pack_start);
+	packer_change_sw_status(&(sys->packer_sw.source), 	cal->pack_source);
+
+	adc_change_sw_status(&(sys->gpio_adc.sw_group.cha_test_pattern), &(sys->gpio_adc.state), cal->test_pattern);
+}
+
+static void smart_buffer_cal_finish(system_state_t *sys)
+{
+	smart_buffer_cal_t *cal = &(sys->smart_buffer_cal);
+	char str[50];
+
+	cal->vars.start.value = 0;
+
+	if (cal->speed_ok < 0)
+	{
+		// Not even the slowest speed works: keep the previous value.
+		smart_buffer_cal_restore(sys, cal->speed_ctrl);
+		cal->vars.state.value = SMART_BUFFER_CAL_STATE_FAILED;
+		mprint("bufCal failed\r\n");
+		return;
+	}
+
+	smart_buffer_cal_restore(sys, (uint16_t)cal->speed_ok);
+
+	// Store result.
+	flash_params_t params;
+	params.buf_speed 	= (uint16_t)cal->speed_ok;
+	params.reserved 	= 0;
+	if (flash_writeParams(&params) != XST_SUCCESS)
+	{
+		mprint("bufCal could not store result in flash\r\n");
+	}
+
+	cal->vars.state.value = SMART_BUFFER_CAL_STATE_DONE;
+	io_sprintf(str, "bufCal done speed %d\r\n", cal->speed_ok);
+	mprint(str);
+}
+
+/*
+ * Next speed to test, or -1 when the search is over.
+ */
+static int32_t smart_buffer_cal_next(smart_buffer_cal_t *cal)
+{
+	// Only good results so far: go faster.
+	if (cal->speed_bad < 0)
+	{
+		return (cal->speed_ok > 0) ? cal->speed_ok/2 : -1;
+	}
+
+	// Only bad results so far: go slower.
+	if (cal->speed_ok < 0)
+	{
+		if (cal->speed_bad >= SMART_BUFFER_SPEED_CTRL_MAX)
+		{
+			return -1;
+		}
+		int32_t next = 2*cal->speed_bad + 1;
+		return (next > SMART_BUFFER_SPEED_CTRL_MAX) ? SMART_BUFFER_SPEED_CTRL_MAX : next;
+	}
+
+	// Bisection between the fastest good and the slowest bad.
+	if (cal->speed_ok - cal->speed_bad <= 1)
+	{
+		return -1;
+	}
+	return (cal->speed_ok + cal->speed_bad)/2;
+}
+
+int smart_buffer_cal_change_status(system_state_t *sys, smart_buffer_var_t *var, uint16_t value)
+{
+	smart_buffer_cal_t *cal = &(sys->smart_buffer_cal);
+	smart_buffer_group_status_t *sb = &(sys->smart_buffer);
+
+	// Results cannot be written.
+	if (var == &(cal->vars.speed) || var == &(cal->vars.state))
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+
+	int running = 	(cal->vars.state.value == SMART_BUFFER_CAL_STATE_TRANSFER) ||
+					(cal->vars.state.value == SMART_BUFFER_CAL_STATE_WAIT);
+
+	// Start/abort.
+	if (var == &(cal->vars.start))
+	{
+		if (value)
+		{
+			// Buffer busy.
+			if (running || sb->capture_start.value == SMART_BUFFER_CAPTURE_START)
+			{
+				return -1;
+			}
+
+			// Save configuration.
+			cal->cha_sel 		= sb->cha_sel.value;
+			cal->cha_nsamp 		= sb->cha_nsamp.value;
+			cal->ch_mode 		= sb->ch_mode.value;
+			cal->dataa_mode 	= sb->dataa_mode.value;
+			cal->capture_mode 	= sb->capture_mode.value;
+			cal->capture_en_src = sb->capture_en_src.value;
+			cal->speed_ctrl 	= sb->speed_ctrl.value;
+			cal->pack_source 	= sys->packer_sw.source.value;
+			cal->pack_start 	= sys->packer_sw.start.value;
+			cal->test_pattern 	= sys->gpio_adc.sw_group.cha_test_pattern.status;
+
+			// Known data on channel A, single NSAMP capture, sent by the packer.
+			adc_change_sw_status(&(sys->gpio_adc.sw_group.cha_test_pattern), &(sys->gpio_adc.state), ADC_TEST_ON);
+			smart_buffer_change_status(&(sb->cha_sel), 			SMART_BUFFER_CHX_SEL_CHA);
+			smart_buffer_change_status(&(sb->cha_nsamp), 		SMART_BUFFER_CAL_NSAMP);
+			smart_buffer_change_status(&(sb->ch_mode), 			SMART_BUFFER_CH_MODE_SINGLE);
+			smart_buffer_change_status(&(sb->dataa_mode), 		SMART_BUFFER_DATAX_MODE_NSAMP);
+			smart_buffer_change_status(&(sb->capture_mode), 	SMART_BUFFER_CAPTURE_MODE_SINGLE);
+			smart_buffer_change_status(&(sb->capture_en_src), 	SMART_BUFFER_CAPTURE_EN_SRC_INTERNAL);
+			packer_change_sw_status(&(sys->packer_sw.source), 	PACKER_TRSRC_RAW_SB);
+			packer_change_sw_status(&(sys->packer_sw.start), 	PACKER_START_ON);
+
+			// Start from the current speed.
+			cal->speed_ok 			= -1;
+			cal->speed_bad 			= -1;
+			cal->vars.start.value 	= 1;
+			smart_buffer_cal_step(sys, sb->speed_ctrl.value);
+		}
+		else if (running)
+		{
+			smart_buffer_cal_restore(sys, cal->speed_ctrl);
+			cal->vars.start.value 	= 0;
+			cal->vars.state.value 	= SMART_BUFFER_CAL_STATE_IDLE;
+		}
+		return 0;
+	}
+
+	// Host verdict.
+	if (var == &(cal->vars.result))
+	{
+		if (cal->vars.state.value != SMART_BUFFER_CAL_STATE_WAIT)
+		{
+			return -1;
+		}
+
+		var->value = value;
+		if (value)
+		{
+			cal->speed_ok = cal->vars.speed.value;
+		}
+		else
+		{
+			cal->speed_bad = cal->vars.speed.value;
+		}
+
+		int32_t next = smart_buffer_cal_next(cal);
+		if (next < 0)
+		{
+			smart_buffer_cal_finish(sys);
+		}
+		else
+		{
+			smart_buffer_cal_step(sys, (uint16_t)next);
+		}
+		return 0;
+	}
+
+	return -1;
+}
+
+int smart_buffer_cal_eot(system_state_t *sys)
+{
+	smart_buffer_cal_t *cal = &(sys->smart_buffer_cal);
+	char str[50];
+
+	if (cal->vars.state.value != SMART_BUFFER_CAL_STATE_TRANSFER)
+	{
+		return 0;
+	}
+
+	cal->vars.state.value = SMART_BUFFER_CAL_STATE_WAIT;
+
+	io_sprintf(str, "bufCal speed %d packets %d\r\n", cal->vars.speed.value, SMART_BUFFER_CAL_NSAMP);
+	mprint(str);
+
+	return 1;
+}
@@ -0,0 +1,580 @@
+/*
+ * snapshot.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <xil_printf.h>
+
+#include "snapshot.h"
+#include "io_func.h"
+#include "perf.h"
+
+static uint8_t snapshot_buffer[SNAPSHOT_BUFFER_LENGTH];
+
+// Writer state.
+typedef struct {
+	uint8_t *buf;
+	uint32_t size;
+	uint32_t idx;
+	uint16_t nsections;
+	uint32_t section;
+	int overflow;
+} snapshot_writer_t;
+
+static void snapshot_put_u8(snapshot_writer_t *w, uint8_t val)
+{
+	if (w->idx + 1 > w->size)
+	{
+		w->overflow = 1;
+		return;
+	}
+	w->buf[w->idx++] = val;
+}
+
+static void snapshot_put_u16(snapshot_writer_t *w, uint16_t val)
+{
+	if (w->idx + 2 > w->size)
+	{
+		w->overflow = 1;
+		return;
+	}
+	io_put_u16(w->buf + w->idx, val);
+	w->idx += 2;
+}
+
+static void snapshot_put_u32(snapshot_writer_t *w, uint32_t val)
+{
+	if (w->idx + 4 > w->size)
+	{
+		w->overflow = 1;
+		return;
+	}
+	io_put_u32(w->buf + w->idx, val);
+	w->idx += 4;
+}
+
+static void snapshot_put_f32(snapshot_writer_t *w, float val)
+{
+	union {
+		float f;
+		uint32_t u;
+	} conv;
+
+	conv.f = val;
+	snapshot_put_u32(w, conv.u);
+}
+
+static void snapshot_section(snapshot_writer_t *w, uint8_t id, uint8_t type, uint16_t count)
+{
+	snapshot_put_u8(w, id);
+	snapshot_put_u8(w, type);
+	snapshot_put_u16(w, count);
+	w->nsections++;
+}
+
+int snapshot_build(system_state_t *sys, uint8_t *buf, uint32_t size, uint32_t *length)
+{
+	snapshot_writer_t w;
+	int i, n;
+
+	w.buf 		= buf;
+	w.size 		= size;
+	w.idx 		= SNAPSHOT_HEADER_LENGTH;
+	w.nsections = 0;
+	w.overflow 	= 0;
+
+	if (size < SNAPSHOT_HEADER_LENGTH)
+	{
+		return -1;
+	}
+
+	// Clocks' voltages.
+	clk_status_t *clk = (clk_status_t *) &(sys->clks);
+	n = sizeof(clk_group_status_t)/sizeof(clk_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_CLOCKS, SNAPSHOT_TYPE_F32, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_f32(&w, (clk+i)->value);
+	}
+
+	// Clocks' switches.
+	clk_sw_status_t *clk_sw = (clk_sw_status_t *) &(sys->clk_sw.sw_group);
+	n = sizeof(clk_sw_group_status_t)/sizeof(clk_sw_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_CLK_SW, SNAPSHOT_TYPE_U8, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u8(&w, (clk_sw+i)->status);
+	}
+
+	// Bias voltages.
+	bias_status_t *bias = (bias_status_t *) &(sys->biases);
+	n = sizeof(bias_group_status_t)/sizeof(bias_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_BIASES, SNAPSHOT_TYPE_F32, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_f32(&w, (bias+i)->value);
+	}
+
+	// Bias switches.
+	bias_sw_status_t *bias_sw = (bias_sw_status_t *) &(sys->bias_sw.sw_group);
+	n = sizeof(bias_sw_group_status_t)/sizeof(bias_sw_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_BIAS_SW, SNAPSHOT_TYPE_U8, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u8(&w, (bias_sw+i)->status);
+	}
+
+	// Packer.
+	packer_sw_status_t *packer_sw = (packer_sw_status_t *) &(sys->packer_sw);
+	n = sizeof(packer_sw_group_status_t)/sizeof(packer_sw_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_PACKER, SNAPSHOT_TYPE_U8, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u8(&w, (packer_sw+i)->value);
+	}
+
+	// ADC.
+	adc_sw_status_t *adc_sw = (adc_sw_status_t *) &(sys->gpio_adc.sw_group);
+	n = sizeof(adc_sw_group_status_t)/sizeof(adc_sw_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_ADC, SNAPSHOT_TYPE_U8, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u8(&w, (adc_sw+i)->status);
+	}
+
+	// Sequencer switches.
+	seq_sw_status_t *seq_sw = (seq_sw_status_t *) &(sys->seq.sw_group);
+	n = sizeof(seq_sw_group_status_t)/sizeof(seq_sw_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_SEQ_SW, SNAPSHOT_TYPE_U8, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u8(&w, (seq_sw+i)->status);
+	}
+
+	// Correlated Double Sampling. The alias goes first, a mixed one holds
+	// channel A's value and the channels written after it restore the rest.
+	cds_var_status_t *cds_var = (cds_var_status_t *) &(sys->cds);
+	n = sizeof(cds_t)/sizeof(cds_var_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_CDS, SNAPSHOT_TYPE_U16, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u16(&w, (cds_var+i)->value);
+	}
+
+	// Generic variables.
+	generic_var_t *generic_var = (generic_var_t *) &(sys->generic_vars);
+	n = sizeof(generic_vars_t)/sizeof(generic_var_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_GENERIC, SNAPSHOT_TYPE_F32, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_f32(&w, (generic_var+i)->value);
+	}
+
+	// Leds.
+	led_status_t *leds_var = (led_status_t *) &(sys->leds);
+	n = sizeof(led_group_status_t)/sizeof(led_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_LEDS, SNAPSHOT_TYPE_U8, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u8(&w, (leds_var+i)->status);
+	}
+
+	// Smart buffer.
+	smart_buffer_status_t *smart_buffer_var = (smart_buffer_status_t *) &(sys->smart_buffer);
+	n = sizeof(smart_buffer_group_status_t)/sizeof(smart_buffer_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_SMART_BUFFER, SNAPSHOT_TYPE_U16, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u16(&w, (smart_buffer_var+i)->value);
+	}
+
+	// Ethernet.
+	eth_status_t *eth_var = (eth_status_t *) &(sys->eth);
+	n = sizeof(eth_t)/sizeof(eth_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_ETH, SNAPSHOT_TYPE_U32, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u32(&w, (eth_var+i)->val);
+	}
+
+	// Master Selection Logic.
+	master_sel_status_t *master_sel_var = (master_sel_status_t *) &(sys->master_sel);
+	n = sizeof(master_sel_t)/sizeof(master_sel_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_MASTER_SEL, SNAPSHOT_TYPE_U16, n);
+	for (i=0; i<n; i++)
+	{
+		// Update value from hardware.
+		master_sel_update_reg(master_sel_var+i);
+		snapshot_put_u16(&w, (master_sel_var+i)->value);
+	}
+
+	// Sync Generation.
+	sync_gen_status_t *sync_gen_var = (sync_gen_status_t *) &(sys->sync_gen);
+	n = sizeof(sync_gen_t)/sizeof(sync_gen_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_SYNC_GEN, SNAPSHOT_TYPE_U16, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u16(&w, (sync_gen_var+i)->value);
+	}
+
+	// Frequency Measurement.
+	fr_meas_status_t *fr_meas_var = (fr_meas_status_t *) &(sys->fr_meas);
+	n = sizeof(fr_meas_t)/sizeof(fr_meas_status_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_FR_MEAS, SNAPSHOT_TYPE_U32, n);
+	for (i=0; i<n; i++)
+	{
+		// Update value from hardware.
+		fr_meas_update_reg(fr_meas_var+i);
+		snapshot_put_u32(&w, (fr_meas_var+i)->value);
+	}
+
+	// Sequencer program (trailing zeros are not sent).
+	n = sys->seq.sequencer.size;
+	while ( (n > 0) && (sys->seq.sequencer.program[n-1] == 0) )
+	{
+		n--;
+	}
+	snapshot_section(&w, SNAPSHOT_SECTION_SEQ_PROGRAM, SNAPSHOT_TYPE_U32, n);
+	for (i=0; i<n; i++)
+	{
+		snapshot_put_u32(&w, sys->seq.sequencer.program[i]);
+	}
+
+	// Telemetry.
+	float tel_values[TELEMETRY_NSOURCES];
+	int tel_status[TELEMETRY_NSOURCES];
+	telemetry_scan_read_all(&(sys->telemetry_scan), &(sys->telemetry), tel_values, tel_status);
+	n = sizeof(telemetry_group_t)/sizeof(telemetry_source_t);
+	snapshot_section(&w, SNAPSHOT_SECTION_TELEMETRY, SNAPSHOT_TYPE_F32, n);
+	for (i=0; i<n; i++)
+	{
+		if (tel_status[i] == 0)
+		{
+			snapshot_put_f32(&w, tel_values[i]);
+		}
+		else
+		{
+			// Quiet NaN.
+			snapshot_put_u32(&w, 0x7FC00000);
+		}
+	}
+
+	// Command latency.
+	char perf_name[PERF_NAME_LENGTH];
+	perf_stats_t perf_stats;
+	n = perf_ntypes();
+	snapshot_section(&w, SNAPSHOT_SECTION_PERF, SNAPSHOT_TYPE_U32, n*PERF_SNAPSHOT_VALUES);
+	for (i=0; i<n; i++)
+	{
+		perf_get(i, perf_name, &perf_stats);
+		for (int j=0; j<PERF_NAME_LENGTH; j++)
+		{
+			snapshot_put_u8(&w, perf_name[j]);
+		}
+		snapshot_put_u32(&w, perf_stats.count);
+		snapshot_put_u32(&w, perf_stats.min);
+		snapshot_put_u32(&w, perf_stats.p50);
+		snapshot_put_u32(&w, perf_stats.p99);
+		snapshot_put_u32(&w, perf_stats.max);
+		snapshot_put_u32(&w, perf_stats.parse);
+		snapshot_put_u32(&w, perf_stats.exec);
+		snapshot_put_u32(&w, perf_stats.output);
+	}
+
+	if (w.overflow)
+	{
+		return -1;
+	}
+
+	// Fill header.
+	uint32_t l = w.idx;
+	uint32_t crc = io_crc32(0, buf + SNAPSHOT_HEADER_LENGTH, l - SNAPSHOT_HEADER_LENGTH);
+	uint16_t nsections = w.nsections;
+
+	w.idx = 0;
+	snapshot_put_u32(&w, SNAPSHOT_MAGIC);
+	snapshot_put_u16(&w, SNAPSHOT_VERSION);
+	snapshot_put_u16(&w, nsections);
+	snapshot_put_u32(&w, l);
+	snapshot_put_u32(&w, crc);
+
+	*length = l;
+
+	return 0;
+}
+
+int snapshot_send(system_state_t *sys)
+{
+	uint32_t length;
+
+	if (snapshot_build(sys, snapshot_buffer, SNAPSHOT_BUFFER_LENGTH, &length) != 0)
+	{
+		return -1;
+	}
+
+	io_put_bin("Snapshot", snapshot_buffer, length);
+
+	return 0;
+}
+
+static float snapshot_get_f32(const uint8_t *p)
+{
+	union {
+		float f;
+		uint32_t u;
+	} conv;
+
+	conv.u = io_get_u32(p);
+	return conv.f;
+}
+
+static int snapshot_type_size(uint8_t type)
+{
+	switch (type)
+	{
+	case SNAPSHOT_TYPE_U8:	return 1;
+	case SNAPSHOT_TYPE_U16:	return 2;
+	case SNAPSHOT_TYPE_U32:	return 4;
+	case SNAPSHOT_TYPE_F32:	return 4;
+	default:				return 0;
+	}
+}
+
+// Type each applied section is written with by snapshot_build.
+static const uint8_t snapshot_apply_types[] = {
+	[SNAPSHOT_SECTION_CLOCKS] 		= SNAPSHOT_TYPE_F32,
+	[SNAPSHOT_SECTION_CLK_SW] 		= SNAPSHOT_TYPE_U8,
+	[SNAPSHOT_SECTION_BIASES] 		= SNAPSHOT_TYPE_F32,
+	[SNAPSHOT_SECTION_BIAS_SW] 		= SNAPSHOT_TYPE_U8,
+	[SNAPSHOT_SECTION_PACKER] 		= SNAPSHOT_TYPE_U8,
+	[SNAPSHOT_SECTION_ADC] 			= SNAPSHOT_TYPE_U8,
+	[SNAPSHOT_SECTION_SEQ_SW] 		= SNAPSHOT_TYPE_U8,
+	[SNAPSHOT_SECTION_CDS] 			= SNAPSHOT_TYPE_U16,
+	[SNAPSHOT_SECTION_SMART_BUFFER] = SNAPSHOT_TYPE_U16,
+	[SNAPSHOT_SECTION_SYNC_GEN] 	= SNAPSHOT_TYPE_U16,
+	[SNAPSHOT_SECTION_FR_MEAS] 		= SNAPSHOT_TYPE_U32,
+	[SNAPSHOT_SECTION_SEQ_PROGRAM] 	= SNAPSHOT_TYPE_U32,
+};
+
+// Applies one section. Values past the end of the group are ignored.
+static int snapshot_apply_section(system_state_t *sys, uint8_t id, uint8_t type, const uint8_t *p, int count)
+{
+	int size = snapshot_type_size(type);
+	int status = 0;
+	int i, n;
+
+	// Not applied, or written with another type by a different version.
+	if (id >= sizeof(snapshot_apply_types) || snapshot_apply_types[id] != type)
+	{
+		return 0;
+	}
+
+	switch (id)
+	{
+	case SNAPSHOT_SECTION_CLOCKS:
+	{
+		clk_status_t *clk = (clk_status_t *) &(sys->clks);
+		n = sizeof(clk_group_status_t)/sizeof(clk_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			float v = snapshot_get_f32(p + i*size);
+			if ((clk+i)->value != v)
+			{
+				status |= dac_set_voltage(clk+i, v);
+			}
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_CLK_SW:
+	{
+		clk_sw_status_t *clk_sw = (clk_sw_status_t *) &(sys->clk_sw.sw_group);
+		n = sizeof(clk_sw_group_status_t)/sizeof(clk_sw_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			status |= dac_change_switch_status(clk_sw+i, &(sys->clk_sw.state), p[i]);
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_BIASES:
+	{
+		bias_status_t *bias = (bias_status_t *) &(sys->biases);
+		n = sizeof(bias_group_status_t)/sizeof(bias_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			float v = snapshot_get_f32(p + i*size);
+			if ((bias+i)->value != v)
+			{
+				status |= ldos_set_voltage(bias+i, v);
+			}
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_BIAS_SW:
+	{
+		bias_sw_status_t *bias_sw = (bias_sw_status_t *) &(sys->bias_sw.sw_group);
+		n = sizeof(bias_sw_group_status_t)/sizeof(bias_sw_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			status |= volt_sw_state_set(bias_sw+i, &(sys->bias_sw.state), p[i]);
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_PACKER:
+		// Source only, start is an action.
+		if (count > 0)
+		{
+			status |= packer_change_sw_status(&(sys->packer_sw.source), p[0]);
+		}
+		break;
+
+	case SNAPSHOT_SECTION_ADC:
+	{
+		adc_sw_status_t *adc_sw = (adc_sw_status_t *) &(sys->gpio_adc.sw_group);
+		n = sizeof(adc_sw_group_status_t)/sizeof(adc_sw_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			status |= adc_change_sw_status(adc_sw+i, &(sys->gpio_adc.state), p[i]);
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_SEQ_SW:
+		// Start source only, the sequencer is not started.
+		if (count > 1)
+		{
+			status |= seq_change_sw_status(&(sys->seq.sw_group.stop_src), p[1]);
+		}
+		break;
+
+	case SNAPSHOT_SECTION_CDS:
+	{
+		cds_var_status_t *cds_var = (cds_var_status_t *) &(sys->cds);
+		n = sizeof(cds_t)/sizeof(cds_var_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			status |= cds_core_change_var_value(&(sys->cds), cds_var+i, io_get_u16(p + i*size));
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_SMART_BUFFER:
+	{
+		smart_buffer_status_t *smart_buffer_var = (smart_buffer_status_t *) &(sys->smart_buffer);
+		n = sizeof(smart_buffer_group_status_t)/sizeof(smart_buffer_status_t);
+		for (i=0; i<n && i<count; i++)
+		{
+			smart_buffer_status_t *reg = smart_buffer_var+i;
+
+			// Actions and end flags are not configuration.
+			if (	reg == &(sys->smart_buffer.capture_start) 	||
+					reg == &(sys->smart_buffer.capture_end) 	||
+					reg == &(sys->smart_buffer.transfer_start) 	||
+					reg == &(sys->smart_buffer.transfer_end) 	||
+					reg == &(sys->smart_buffer.reset) )
+			{
+				continue;
+			}
+			status |= smart_buffer_change_status(reg, io_get_u16(p + i*size));
+		}
+		break;
+	}
+
+	case SNAPSHOT_SECTION_SYNC_GEN:
+		// Delay only, stop is an action.
+		if (count > 1)
+		{
+			status |= sync_gen_change_status(&(sys->sync_gen.delay), io_get_u16(p + size));
+		}
+		break;
+
+	case SNAPSHOT_SECTION_FR_MEAS:
+		// Measured frequency is read only.
+		if (count > 0)
+		{
+			status |= fr_meas_change_status(&(sys->fr_meas.fclk), io_get_u32(p));
+		}
+		break;
+
+	case SNAPSHOT_SECTION_SEQ_PROGRAM:
+		if (count > SEQUENCER_MEMORY_SIZE)
+		{
+			return -1;
+		}
+		sequencer_clear_program(&(sys->seq));
+		for (i=0; i<count; i++)
+		{
+			sys->seq.sequencer.program[i] = io_get_u32(p + i*size);
+		}
+		status |= sequencer_load_program(&(sys->seq.sequencer));
+		break;
+
+	default:
+		break;
+	}
+
+	return (status != 0) ? -1 : 0;
+}
+
+int snapshot_apply(system_state_t *sys, const uint8_t *blob, uint32_t length)
+{
+	if (length < SNAPSHOT_HEADER_LENGTH)
+	{
+		return -1;
+	}
+
+	uint32_t magic 		= io_get_u32(blob);
+	uint16_t version 	= io_get_u16(blob + 4);
+	uint16_t nsections 	= io_get_u16(blob + 6);
+	uint32_t l 			= io_get_u32(blob + 8);
+	uint32_t crc 		= io_get_u32(blob + 12);
+
+	if (	magic != SNAPSHOT_MAGIC 		||
+			version > SNAPSHOT_VERSION 		||
+			l > length 						||
+			l < SNAPSHOT_HEADER_LENGTH 		||
+			io_crc32(0, blob + SNAPSHOT_HEADER_LENGTH, l - SNAPSHOT_HEADER_LENGTH) != crc )
+	{
+		return -1;
+	}
+
+	// Check the whole blob before touching the hardware.
+	uint32_t idx = SNAPSHOT_HEADER_LENGTH;
+	for (int s=0; s<nsections; s++)
+	{
+		if (idx + SNAPSHOT_SECTION_HEADER_LENGTH > l)
+		{
+			return -1;
+		}
+		int size = snapshot_type_size(blob[idx+1]);
+		uint32_t count = io_get_u16(blob + idx + 2);
+		idx += SNAPSHOT_SECTION_HEADER_LENGTH;
+		if (size == 0 || idx + count*size > l)
+		{
+			return -1;
+		}
+		idx += count*size;
+	}
+
+	int status = 0;
+	idx = SNAPSHOT_HEADER_LENGTH;
+	for (int s=0; s<nsections; s++)
+	{
+		uint8_t id 		= blob[idx];
+		uint8_t type 	= blob[idx+1];
+		uint16_t count 	= io_get_u16(blob + idx + 2);
+		idx += SNAPSHOT_SECTION_HEADER_LENGTH;
+
+		status |= snapshot_apply_section(sys, id, type, blob + idx, count);
+		idx += count*snapshot_type_size(type);
+	}
+
+	return status;
+}
@@ -0,0 +1,217 @@
+/*
+ * spi_trace.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "spi_trace.h"
+#include "perf.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+typedef struct {
+	XSpi *spi[SPI_TRACE_NDEVS];
+
+	spi_trace_count_t total[SPI_TRACE_NDEVS];
+	spi_trace_count_t cmd[SPI_TRACE_NDEVS];
+	spi_trace_count_t last[SPI_TRACE_NDEVS];
+
+	// Circular buffer.
+	uint8_t running;
+	spi_trace_entry_t entries[SPI_TRACE_LENGTH];
+	uint32_t idx;
+	uint32_t n;
+} spi_trace_state_t;
+
+static spi_trace_state_t spi_trace;
+
+static const char * const spi_trace_names[SPI_TRACE_NDEVS] = {
+	"dac", "ldo", "telemetry", "volt_sw", "flash"
+};
+
+static uint8_t spi_trace_buffer[SPI_TRACE_HEADER_LENGTH + SPI_TRACE_LENGTH*SPI_TRACE_ENTRY_LENGTH];
+
+void spi_trace_register(XSpi *spi, int dev)
+{
+	if (dev >= 0 && dev < SPI_TRACE_NDEVS)
+	{
+		spi_trace.spi[dev] = spi;
+	}
+}
+
+// Device of a registered instance, -1 if not registered.
+static int spi_trace_dev(XSpi *spi)
+{
+	for (int i=0; i<SPI_TRACE_NDEVS; i++)
+	{
+		if (spi_trace.spi[i] == spi)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+void spi_trace_record(int dev, uint8_t op, uint32_t length, uint32_t data, uint32_t us)
+{
+	spi_trace_count_t *c[2];
+
+	if (dev < 0 || dev >= SPI_TRACE_NDEVS)
+	{
+		return;
+	}
+
+	c[0] = &spi_trace.total[dev];
+	c[1] = &spi_trace.cmd[dev];
+	for (int i=0; i<2; i++)
+	{
+		if ((op & ~SPI_TRACE_OP_ERROR) == SPI_TRACE_OP_TRANSFER)
+		{
+			c[i]->transfers++;
+			c[i]->bytes += length;
+			c[i]->us 	+= us;
+		}
+		else
+		{
+			c[i]->selects++;
+		}
+		if (op & SPI_TRACE_OP_ERROR)
+		{
+			c[i]->errors++;
+		}
+	}
+
+	if (spi_trace.running)
+	{
+		spi_trace_entry_t *e = &spi_trace.entries[spi_trace.idx];
+		e->tstamp 	= tget_ms();
+		e->dev 		= dev;
+		e->op 		= op;
+		e->length 	= (length > 0xFFFF) ? 0xFFFF : length;
+		e->us 		= us;
+		e->data 	= data;
+		spi_trace.idx = (spi_trace.idx + 1) % SPI_TRACE_LENGTH;
+		if (spi_trace.n < SPI_TRACE_LENGTH)
+		{
+			spi_trace.n++;
+		}
+	}
+}
+
+int spi_trace_transfer(XSpi *spi, u8 *send, u8 *recv, unsigned int n)
+{
+	uint32_t data = 0;
+	int ret;
+
+	// Send buffer is overwritten when recv is the same buffer.
+	for (unsigned int i=0; i<n && i<4; i++)
+	{
+		data |= (uint32_t) send[i] << (8*i);
+	}
+
+	uint32_t t0 = perf_ticks();
+	ret = XSpi_Transfer(spi, send, recv, n);
+	uint32_t us = perf_us(t0, perf_ticks());
+
+	spi_trace_record(spi_trace_dev(spi), SPI_TRACE_OP_TRANSFER | ((ret != XST_SUCCESS) ? SPI_TRACE_OP_ERROR : 0), n, data, us);
+
+	return ret;
+}
+
+int spi_trace_select(XSpi *spi, u32 mask)
+{
+	int ret = XSpi_SetSlaveSelect(spi, mask);
+
+	spi_trace_record(spi_trace_dev(spi), SPI_TRACE_OP_SELECT | ((ret != XST_SUCCESS) ? SPI_TRACE_OP_ERROR : 0), mask, 0, 0);
+
+	return ret;
+}
+
+void spi_trace_command(void)
+{
+	memcpy(spi_trace.last, spi_trace.cmd, sizeof(spi_trace.last));
+	memset(spi_trace.cmd, 0, sizeof(spi_trace.cmd));
+}
+
+void spi_trace_start(void)
+{
+	spi_trace.running = 1;
+}
+
+void spi_trace_stop(void)
+{
+	spi_trace.running = 0;
+}
+
+void spi_trace_reset(void)
+{
+	memset(spi_trace.total, 0, sizeof(spi_trace.total));
+	memset(spi_trace.cmd, 0, sizeof(spi_trace.cmd));
+	memset(spi_trace.last, 0, sizeof(spi_trace.last));
+	spi_trace.idx 	= 0;
+	spi_trace.n 	= 0;
+}
+
+int spi_trace_get(int dev, int last, spi_trace_count_t *count)
+{
+	if (dev < 0 || dev >= SPI_TRACE_NDEVS)
+	{
+		return -1;
+	}
+
+	*count = last ? spi_trace.last[dev] : spi_trace.total[dev];
+
+	return 0;
+}
+
+void spi_trace_print(void)
+{
+	char str[200];
+	spi_trace_count_t t, l;
+
+	mprint("### SPI traffic (total / last command) ###\r\n");
+	for (int i=0; i<SPI_TRACE_NDEVS; i++)
+	{
+		spi_trace_get(i, 0, &t);
+		spi_trace_get(i, 1, &l);
+		io_sprintf(str, "%s : transfers %u/%u, selects %u/%u, bytes %u/%u, us %u/%u, errors %u/%u\r\n",
+				spi_trace_names[i], t.transfers, l.transfers, t.selects, l.selects,
+				t.bytes, l.bytes, t.us, l.us, t.errors, l.errors);
+		mprint(str);
+	}
+	io_sprintf(str, "Trace %s, %u entries\r\n", spi_trace.running ? "running" : "stopped", spi_trace.n);
+	mprint(str);
+}
+
+void spi_trace_send(void)
+{
+	uint32_t n = spi_trace.n;
+	uint32_t first = (spi_trace.idx + SPI_TRACE_LENGTH - n) % SPI_TRACE_LENGTH;
+	uint8_t *p = spi_trace_buffer + SPI_TRACE_HEADER_LENGTH;
+
+	for (uint32_t i=0; i<n; i++)
+	{
+		spi_trace_entry_t *e = &spi_trace.entries[(first + i) % SPI_TRACE_LENGTH];
+		io_put_u32(p, e->tstamp);
+		p[4] = e->dev;
+		p[5] = e->op;
+		io_put_u16(p + 6, e->length);
+		io_put_u32(p + 8, e->us);
+		io_put_u32(p + 12, e->data);
+		p += SPI_TRACE_ENTRY_LENGTH;
+	}
+
+	uint8_t *h = spi_trace_buffer;
+	io_put_u32(h, SPI_TRACE_MAGIC);
+	io_put_u16(h + 4, SPI_TRACE_VERSION);
+	io_put_u16(h + 6, n);
+	io_put_u32(h + 8, tget_ms());
+	io_put_u32(h + 12, io_crc32(0, spi_trace_buffer + SPI_TRACE_HEADER_LENGTH, n*SPI_TRACE_ENTRY_LENGTH));
+
+	io_put_bin("SPI trace", spi_trace_buffer, SPI_TRACE_HEADER_LENGTH + n*SPI_TRACE_ENTRY_LENGTH);
+}
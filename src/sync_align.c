@@ -0,0 +1,203 @@
+/*
+ * sync_align.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "sync_align.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+static void sync_align_var_init(sync_align_var_t *var, const char *name, uint32_t value, uint32_t min, uint32_t max)
+{
+	var->value 	= value;
+	var->min 	= min;
+	var->max 	= max;
+	var->name = name;
+}
+
+void sync_align_init(sync_align_t *sync_align)
+{
+	sync_align_group_status_t *v = &(sync_align->vars);
+
+	sync_align_var_init(&(v->arm), 		"syncArm", 		SYNC_ALIGN_OFF, SYNC_ALIGN_OFF, SYNC_ALIGN_ON);
+	sync_align_var_init(&(v->go), 		"syncGo", 		SYNC_ALIGN_OFF, SYNC_ALIGN_OFF, SYNC_ALIGN_ON);
+	sync_align_var_init(&(v->cal), 		"syncCal", 		SYNC_ALIGN_OFF, SYNC_ALIGN_OFF, SYNC_ALIGN_ON);
+	sync_align_var_init(&(v->freq), 	"syncFreq", 	0, 0, FR_MEAS_FMEAS_MAX);
+	sync_align_var_init(&(v->cable), 	"syncCable", 	0, 0, SYNC_ALIGN_NS_MAX);
+	sync_align_var_init(&(v->ref), 		"syncRef", 		0, 0, SYNC_ALIGN_NS_MAX);
+
+	// Read only variables.
+	sync_align_var_init(&(v->link), 	"syncLink", 	SYNC_ALIGN_OFF, 0, 0);
+	sync_align_var_init(&(v->starts), 	"syncStarts", 	0, 0, 0);
+
+	sync_align->period_ps 	= 0;
+	sync_align->residual_ps = 0;
+	sync_align->wait_min 	= 0xFFFFFFFF;
+	sync_align->wait_max 	= 0;
+}
+
+// Sequencer waits for the sync line.
+static void sync_align_arm(system_state_t *sys)
+{
+	sync_align_t *s = &(sys->sync_align);
+
+	packer_change_sw_status(&(sys->packer_sw.start), PACKER_START_ON);
+	seq_change_sw_status(&(sys->seq.sw_group.stop_src), SEQUENCER_STOP_SRC_EXTERNAL);
+	seq_change_sw_status(&(sys->seq.sw_group.stop), SEQUENCER_START);
+
+	s->vars.arm.value 	= SYNC_ALIGN_ON;
+	s->t_arm 			= tget_ms();
+}
+
+static void sync_align_disarm(system_state_t *sys)
+{
+	seq_change_sw_status(&(sys->seq.sw_group.stop), SEQUENCER_STOP);
+	seq_change_sw_status(&(sys->seq.sw_group.stop_src), SEQUENCER_STOP_SRC_INTERNAL);
+	packer_change_sw_status(&(sys->packer_sw.start), PACKER_START_OFF);
+
+	sys->sync_align.vars.arm.value = SYNC_ALIGN_OFF;
+}
+
+// Measures the sync clock and sets the delay. Returns -1 without a usable clock.
+static int sync_align_calibrate(system_state_t *sys)
+{
+	sync_align_t *s = &(sys->sync_align);
+	uint32_t fmeas, freq = s->vars.freq.value;
+
+	s->vars.link.value = SYNC_ALIGN_OFF;
+
+	fr_meas_update_reg(&(sys->fr_meas.fmeas));
+	fmeas = sys->fr_meas.fmeas.value;
+	if (fmeas == 0)
+	{
+		return -1;
+	}
+	if (freq > 0 && (fmeas*100 < freq*(100 - SYNC_ALIGN_FREQ_TOL) || fmeas*100 > freq*(100 + SYNC_ALIGN_FREQ_TOL)))
+	{
+		return -1;
+	}
+	s->vars.link.value = SYNC_ALIGN_ON;
+
+	if (s->vars.ref.value < s->vars.cable.value)
+	{
+		return -1;
+	}
+
+	// fmeas is in kHz.
+	uint32_t period_ps = 1000000000 / fmeas;
+	uint32_t skew_ps = (s->vars.ref.value - s->vars.cable.value) * 1000;
+	uint32_t delay = (skew_ps + period_ps/2) / period_ps;
+	if (delay > SYNC_GEN_DELAY_MAX)
+	{
+		return -1;
+	}
+
+	s->period_ps 	= period_ps;
+	s->residual_ps 	= (int32_t) skew_ps - (int32_t) (delay*period_ps);
+
+	return sync_gen_change_status(&(sys->sync_gen.delay), delay);
+}
+
+int sync_align_change_status(system_state_t *sys, sync_align_var_t *var, uint32_t value)
+{
+	sync_align_t *s = &(sys->sync_align);
+
+	// Read only.
+	if (var == &(s->vars.link) || var == &(s->vars.starts))
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+
+	if (var == &(s->vars.arm))
+	{
+		if (value == SYNC_ALIGN_ON)
+		{
+			sync_align_arm(sys);
+		}
+		else if (var->value == SYNC_ALIGN_ON)
+		{
+			sync_align_disarm(sys);
+		}
+		return 0;
+	}
+
+	// Only the master drives the sync line.
+	if (var == &(s->vars.go))
+	{
+		master_sel_update_reg(&(sys->master_sel.sel));
+		if (value == SYNC_ALIGN_ON)
+		{
+			if (sys->master_sel.sel.value != MASTER_SEL_IS_MASTER)
+			{
+				return -1;
+			}
+			sync_align_arm(sys);
+			sync_gen_change_status(&(sys->sync_gen.stop), SYNC_GEN_START);
+		}
+		return 0;
+	}
+
+	if (var == &(s->vars.cal))
+	{
+		return (value == SYNC_ALIGN_ON) ? sync_align_calibrate(sys) : 0;
+	}
+
+	var->value = value;
+
+	return 0;
+}
+
+void sync_align_eos(system_state_t *sys)
+{
+	sync_align_t *s = &(sys->sync_align);
+
+	if (s->vars.arm.value != SYNC_ALIGN_ON)
+	{
+		return;
+	}
+
+	uint32_t wait = tget_ms() - s->t_arm;
+	if (wait < s->wait_min) s->wait_min = wait;
+	if (wait > s->wait_max) s->wait_max = wait;
+
+	// The sequencer already went back to internal start.
+	s->vars.arm.value = SYNC_ALIGN_OFF;
+	s->vars.starts.value++;
+}
+
+void sync_align_print(system_state_t *sys)
+{
+	sync_align_t *s = &(sys->sync_align);
+	char str[100];
+
+	master_sel_update_reg(&(sys->master_sel.sel));
+	fr_meas_update_reg(&(sys->fr_meas.fmeas));
+
+	mprint("### Sync ###\r\n");
+	io_sprintf(str, "Role : %s\r\n", (sys->master_sel.sel.value == MASTER_SEL_IS_MASTER) ? "master" : "slave");
+	mprint(str);
+	io_sprintf(str, "Clock : %u kHz, link %s\r\n", sys->fr_meas.fmeas.value, s->vars.link.value ? "ok" : "not calibrated");
+	mprint(str);
+	io_sprintf(str, "Delay : %u cycles of %u ps for %d ns\r\n",
+			sys->sync_gen.delay.value, s->period_ps, (int32_t) (s->vars.ref.value - s->vars.cable.value));
+	mprint(str);
+	io_sprintf(str, "Skew : %d ps\r\n", s->residual_ps);
+	mprint(str);
+	io_sprintf(str, "Starts : %u%s\r\n", s->vars.starts.value, s->vars.arm.value ? ", armed" : "");
+	mprint(str);
+	if (s->vars.starts.value > 0)
+	{
+		io_sprintf(str, "Arm to end : %u - %u ms\r\n", s->wait_min, s->wait_max);
+		mprint(str);
+	}
+}
@@ -6,9 +6,12 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include <xspi.h>
 #include <xgpio.h>
 #include "telemetry.h"
+#include "interrupt.h"
+#include "spi_trace.h"
 
 // SPI driver variables.
 XSpi_Config	*spi_telemetry_cfg;
@@ -17,12 +20,87 @@ XSpi		spi_telemetry_i;
 // GPIO driver variables.
 XGpio gpio_telemetry_i;
 
+// SPI transfers done since boot.
+static uint32_t telemetry_transfers = 0;
+
+/*
+ * Sources in telemetry_group_t order. Names are the field names.
+ * X(field, description, mux_en, mux_ch, ad_ch, gain)
+ */
+#define TELEMETRY_GAIN_DIV		((float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN)
+#define TELEMETRY_SOURCES(X) \
+	X(swa, "Summing Well A", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH0, TELEMETRY_AD_CH0, 1) \
+	X(swb, "Summing Well B", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH1, TELEMETRY_AD_CH0, 1) \
+	X(oga, "Output Gate A", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH2, TELEMETRY_AD_CH0, 1) \
+	X(ogb, "Output Gate B", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH3, TELEMETRY_AD_CH0, 1) \
+	X(rga, "Reset Gate A", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH4, TELEMETRY_AD_CH0, 1) \
+	X(rgb, "Reset Gate B", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH5, TELEMETRY_AD_CH0, 1) \
+	X(dga, "Dedo Gordo A", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH6, TELEMETRY_AD_CH0, 1) \
+	X(dgb, "Dedo Gordo B", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH7, TELEMETRY_AD_CH0, 1) \
+	X(h1a, "H1A Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH0, TELEMETRY_AD_CH1, 1) \
+	X(h1b, "H1B Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH1, TELEMETRY_AD_CH1, 1) \
+	X(h2c, "H2C Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH2, TELEMETRY_AD_CH1, 1) \
+	X(v2c, "V2C Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH3, TELEMETRY_AD_CH1, 2) \
+	X(h3a, "H3A Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH4, TELEMETRY_AD_CH1, 1) \
+	X(h3b, "H3B Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH5, TELEMETRY_AD_CH1, 1) \
+	X(v1a, "V1A Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH6, TELEMETRY_AD_CH1, 2) \
+	X(v1b, "V1B Clock", TELEMETRY_MUX_EN0, TELEMETRY_MUX_CH7, TELEMETRY_AD_CH1, 2) \
+	X(v3a, "V3A Clock", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH0, TELEMETRY_AD_CH2, 2) \
+	X(v3b, "V3B Clock", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH1, TELEMETRY_AD_CH2, 2) \
+	X(tga, "TGA Offset", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH2, TELEMETRY_AD_CH2, 1) \
+	X(tgb, "TGB Offset", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH3, TELEMETRY_AD_CH2, 1) \
+	X(v_p2v5, "+2.5V Source", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH7, TELEMETRY_AD_CH2, 1) \
+	X(v_p1v0, "+1.0V Source", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH0, TELEMETRY_AD_CH3, 1) \
+	X(v_p4v2, "+4.2V Source", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH1, TELEMETRY_AD_CH3, 1) \
+	X(v_p1v8, "+1.8V Source", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH2, TELEMETRY_AD_CH3, 1) \
+	X(v_p5v0, "+5.0V Source", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH3, TELEMETRY_AD_CH3, 1) \
+	X(v_p2v5a, "+2.5V Source (A)", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH4, TELEMETRY_AD_CH3, 1) \
+	X(v_p3v3, "+v3.3V Source", TELEMETRY_MUX_EN1, TELEMETRY_MUX_CH5, TELEMETRY_AD_CH3, 1) \
+	X(v_m15v0, "-15.0V Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH2, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV) \
+	X(v_p12v0, "+12.0V Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH3, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV) \
+	X(v_p15v0, "+15.0V Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH4, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV) \
+	X(ccd_vdd, "CCD VDD Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH0, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV) \
+	X(ccd_vr, "CCD VR Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH1, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV) \
+	X(ccd_vsub, "CCD VSUB Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH5, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV) \
+	X(ccd_vdrain, "CCD VDRAIN Source", TELEMETRY_MUX_EN2, TELEMETRY_MUX_CH6, TELEMETRY_AD_CH4, TELEMETRY_GAIN_DIV)
+
+// Converts data back from AD7328 into volts. Fails if it is not from the
+// channel of the source.
+static int telemetry_convert(telemetry_source_t *source, uint16_t data, float *value)
+{
+	int ad_ch 	= ( (data >> TELEMETRY_DATA_CHID_OFFSET) 	& TELEMETRY_DATA_CHID_MASK );
+	int s 		= ( (data >> TELEMETRY_DATA_SIGN_OFFSET) 	& TELEMETRY_DATA_SIGN_MASK );
+	int conv	= ( (data >> TELEMETRY_DATA_VAL_OFFSET) 	& TELEMETRY_DATA_VAL_MASK );
+
+	// Check if it's a negative number.
+	if (s) {
+		conv = conv - TELEMETRY_AD_MAX_COUNT;
+	}
+
+	// Compute value.
+	float conv_f = conv;
+	if (ad_ch == source->ad_ch) {
+		conv_f = conv_f * source->gain;
+		conv_f = conv_f * (float)TELEMETRY_AD_MAX_VOLT;
+		conv_f = conv_f / (float)TELEMETRY_AD_MAX_COUNT;
+		*value = conv_f;
+	}
+	else {
+		return -1;
+	}
+
+	return 0;
+}
+
 int telemetry_init(telemetry_group_t *sources, uint32_t spi_device_id, uint32_t gpio_device_id)
 {
 	int ret;
 	uint32_t base_addr		= 0;
 	uint32_t control_val 	= 0;
 
+	// Count its traffic.
+	spi_trace_register(&spi_telemetry_i, SPI_TRACE_TELEMETRY);
+
 	// Init spi_ldo_i structure.
 	ret = XSpi_Initialize(&spi_telemetry_i, spi_device_id);
 	if (ret != XST_SUCCESS) {
@@ -85,244 +163,12 @@ int telemetry_init(telemetry_group_t *sources, uint32_t spi_device_id, uint32_t
 	 */
 	XGpio_DiscreteWrite(&gpio_telemetry_i, 1, 0);
 
-	// Initialize internal sources structure.
-	strcpy(sources->swa.name,"swa");
-	strcpy(sources->swa.description,"Summing Well A");
-	sources->swa.mux_en = TELEMETRY_MUX_EN0;
-	sources->swa.mux_ch = TELEMETRY_MUX_CH0;
-	sources->swa.ad_ch = TELEMETRY_AD_CH0;
-	sources->swa.gain = 1;
-
-	strcpy(sources->swb.name,"swb");
-	strcpy(sources->swb.description,"Summing Well B");
-	sources->swb.mux_en = TELEMETRY_MUX_EN0;
-	sources->swb.mux_ch = TELEMETRY_MUX_CH1;
-	sources->swb.ad_ch = TELEMETRY_AD_CH0;
-	sources->swb.gain = 1;
-
-	strcpy(sources->oga.name,"oga");
-	strcpy(sources->oga.description,"Output Gate A");
-	sources->oga.mux_en = TELEMETRY_MUX_EN0;
-	sources->oga.mux_ch = TELEMETRY_MUX_CH2;
-	sources->oga.ad_ch = TELEMETRY_AD_CH0;
-	sources->oga.gain = 1;
-
-	strcpy(sources->ogb.name,"ogb");
-	strcpy(sources->ogb.description,"Output Gate B");
-	sources->ogb.mux_en = TELEMETRY_MUX_EN0;
-	sources->ogb.mux_ch = TELEMETRY_MUX_CH3;
-	sources->ogb.ad_ch = TELEMETRY_AD_CH0;
-	sources->ogb.gain = 1;
-
-	strcpy(sources->rga.name,"rga");
-	strcpy(sources->rga.description,"Reset Gate A");
-	sources->rga.mux_en = TELEMETRY_MUX_EN0;
-	sources->rga.mux_ch = TELEMETRY_MUX_CH4;
-	sources->rga.ad_ch = TELEMETRY_AD_CH0;
-	sources->rga.gain = 1;
-
-	strcpy(sources->rgb.name,"rgb");
-	strcpy(sources->rgb.description,"Reset Gate B");
-	sources->rgb.mux_en = TELEMETRY_MUX_EN0;
-	sources->rgb.mux_ch = TELEMETRY_MUX_CH5;
-	sources->rgb.ad_ch = TELEMETRY_AD_CH0;
-	sources->rgb.gain = 1;
-
-	strcpy(sources->dga.name,"dga");
-	strcpy(sources->dga.description,"Dedo Gordo A");
-	sources->dga.mux_en = TELEMETRY_MUX_EN0;
-	sources->dga.mux_ch = TELEMETRY_MUX_CH6;
-	sources->dga.ad_ch = TELEMETRY_AD_CH0;
-	sources->dga.gain = 1;
-
-	strcpy(sources->dgb.name,"dgb");
-	strcpy(sources->dgb.description,"Dedo Gordo B");
-	sources->dgb.mux_en = TELEMETRY_MUX_EN0;
-	sources->dgb.mux_ch = TELEMETRY_MUX_CH7;
-	sources->dgb.ad_ch = TELEMETRY_AD_CH0;
-	sources->dgb.gain = 1;
-
-	strcpy(sources->h1a.name,"h1a");
-	strcpy(sources->h1a.description,"H1A Clock");
-	sources->h1a.mux_en = TELEMETRY_MUX_EN0;
-	sources->h1a.mux_ch = TELEMETRY_MUX_CH0;
-	sources->h1a.ad_ch = TELEMETRY_AD_CH1;
-	sources->h1a.gain = 1;
-
-	strcpy(sources->h1b.name,"h1b");
-	strcpy(sources->h1b.description,"H1B Clock");
-	sources->h1b.mux_en = TELEMETRY_MUX_EN0;
-	sources->h1b.mux_ch = TELEMETRY_MUX_CH1;
-	sources->h1b.ad_ch = TELEMETRY_AD_CH1;
-	sources->h1b.gain = 1;
-
-	strcpy(sources->h2c.name,"h2c");
-	strcpy(sources->h2c.description,"H2C Clock");
-	sources->h2c.mux_en = TELEMETRY_MUX_EN0;
-	sources->h2c.mux_ch = TELEMETRY_MUX_CH2;
-	sources->h2c.ad_ch = TELEMETRY_AD_CH1;
-	sources->h2c.gain = 1;
-
-	strcpy(sources->v2c.name,"v2c");
-	strcpy(sources->v2c.description,"V2C Clock");
-	sources->v2c.mux_en = TELEMETRY_MUX_EN0;
-	sources->v2c.mux_ch = TELEMETRY_MUX_CH3;
-	sources->v2c.ad_ch = TELEMETRY_AD_CH1;
-	sources->v2c.gain = 2;
-
-	strcpy(sources->h3a.name,"h3a");
-	strcpy(sources->h3a.description,"H3A Clock");
-	sources->h3a.mux_en = TELEMETRY_MUX_EN0;
-	sources->h3a.mux_ch = TELEMETRY_MUX_CH4;
-	sources->h3a.ad_ch = TELEMETRY_AD_CH1;
-	sources->h3a.gain = 1;
-
-	strcpy(sources->h3b.name,"h3b");
-	strcpy(sources->h3b.description,"H3B Clock");
-	sources->h3b.mux_en = TELEMETRY_MUX_EN0;
-	sources->h3b.mux_ch = TELEMETRY_MUX_CH5;
-	sources->h3b.ad_ch = TELEMETRY_AD_CH1;
-	sources->h3b.gain = 1;
-
-	strcpy(sources->v1a.name,"v1a");
-	strcpy(sources->v1a.description,"V1A Clock");
-	sources->v1a.mux_en = TELEMETRY_MUX_EN0;
-	sources->v1a.mux_ch = TELEMETRY_MUX_CH6;
-	sources->v1a.ad_ch = TELEMETRY_AD_CH1;
-	sources->v1a.gain = 2;
-
-	strcpy(sources->v1b.name,"v1b");
-	strcpy(sources->v1b.description,"V1B Clock");
-	sources->v1b.mux_en = TELEMETRY_MUX_EN0;
-	sources->v1b.mux_ch = TELEMETRY_MUX_CH7;
-	sources->v1b.ad_ch = TELEMETRY_AD_CH1;
-	sources->v1b.gain = 2;
-
-	strcpy(sources->v3a.name,"v3a");
-	strcpy(sources->v3a.description,"V3A Clock");
-	sources->v3a.mux_en = TELEMETRY_MUX_EN1;
-	sources->v3a.mux_ch = TELEMETRY_MUX_CH0;
-	sources->v3a.ad_ch = TELEMETRY_AD_CH2;
-	sources->v3a.gain = 2;
-
-	strcpy(sources->v3b.name,"v3b");
-	strcpy(sources->v3b.description,"V3B Clock");
-	sources->v3b.mux_en = TELEMETRY_MUX_EN1;
-	sources->v3b.mux_ch = TELEMETRY_MUX_CH1;
-	sources->v3b.ad_ch = TELEMETRY_AD_CH2;
-	sources->v3b.gain = 2;
-
-	strcpy(sources->tga.name,"tga");
-	strcpy(sources->tga.description,"TGA Offset");
-	sources->tga.mux_en = TELEMETRY_MUX_EN1;
-	sources->tga.mux_ch = TELEMETRY_MUX_CH2;
-	sources->tga.ad_ch = TELEMETRY_AD_CH2;
-	sources->tga.gain = 1;
-
-	strcpy(sources->tgb.name,"tgb");
-	strcpy(sources->tgb.description,"TGB Offset");
-	sources->tgb.mux_en = TELEMETRY_MUX_EN1;
-	sources->tgb.mux_ch = TELEMETRY_MUX_CH3;
-	sources->tgb.ad_ch = TELEMETRY_AD_CH2;
-	sources->tgb.gain = 1;
-
-	strcpy(sources->v_p2v5.name,"v_p2v5");
-	strcpy(sources->v_p2v5.description,"+2.5V Source");
-	sources->v_p2v5.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p2v5.mux_ch = TELEMETRY_MUX_CH7;
-	sources->v_p2v5.ad_ch = TELEMETRY_AD_CH2;
-	sources->v_p2v5.gain = 1;
-
-	strcpy(sources->v_p1v0.name,"v_p1v0");
-	strcpy(sources->v_p1v0.description,"+1.0V Source");
-	sources->v_p1v0.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p1v0.mux_ch = TELEMETRY_MUX_CH0;
-	sources->v_p1v0.ad_ch = TELEMETRY_AD_CH3;
-	sources->v_p1v0.gain = 1;
-
-	strcpy(sources->v_p4v2.name,"v_p4v2");
-	strcpy(sources->v_p4v2.description,"+4.2V Source");
-	sources->v_p4v2.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p4v2.mux_ch = TELEMETRY_MUX_CH1;
-	sources->v_p4v2.ad_ch = TELEMETRY_AD_CH3;
-	sources->v_p4v2.gain = 1;
-
-	strcpy(sources->v_p1v8.name,"v_p1v8");
-	strcpy(sources->v_p1v8.description,"+1.8V Source");
-	sources->v_p1v8.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p1v8.mux_ch = TELEMETRY_MUX_CH2;
-	sources->v_p1v8.ad_ch = TELEMETRY_AD_CH3;
-	sources->v_p1v8.gain = 1;
-
-	strcpy(sources->v_p5v0.name,"v_p5v0");
-	strcpy(sources->v_p5v0.description,"+5.0V Source");
-	sources->v_p5v0.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p5v0.mux_ch = TELEMETRY_MUX_CH3;
-	sources->v_p5v0.ad_ch = TELEMETRY_AD_CH3;
-	sources->v_p5v0.gain = 1;
-
-	strcpy(sources->v_p2v5a.name,"v_p2v5a");
-	strcpy(sources->v_p2v5a.description,"+2.5V Source (A)");
-	sources->v_p2v5a.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p2v5a.mux_ch = TELEMETRY_MUX_CH4;
-	sources->v_p2v5a.ad_ch = TELEMETRY_AD_CH3;
-	sources->v_p2v5a.gain = 1;
-
-	strcpy(sources->v_p3v3.name,"v_p3v3");
-	strcpy(sources->v_p3v3.description,"+v3.3V Source");
-	sources->v_p3v3.mux_en = TELEMETRY_MUX_EN1;
-	sources->v_p3v3.mux_ch = TELEMETRY_MUX_CH5;
-	sources->v_p3v3.ad_ch = TELEMETRY_AD_CH3;
-	sources->v_p3v3.gain = 1;
-
-	strcpy(sources->v_m15v0.name,"v_m15v0");
-	strcpy(sources->v_m15v0.description,"-15.0V Source");
-	sources->v_m15v0.mux_en = TELEMETRY_MUX_EN2;
-	sources->v_m15v0.mux_ch = TELEMETRY_MUX_CH2;
-	sources->v_m15v0.ad_ch = TELEMETRY_AD_CH4;
-	sources->v_m15v0.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
-
-	strcpy(sources->v_p12v0.name,"v_p12v0");
-	strcpy(sources->v_p12v0.description,"+12.0V Source");
-	sources->v_p12v0.mux_en = TELEMETRY_MUX_EN2;
-	sources->v_p12v0.mux_ch = TELEMETRY_MUX_CH3;
-	sources->v_p12v0.ad_ch = TELEMETRY_AD_CH4;
-	sources->v_p12v0.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
-
-	strcpy(sources->v_p15v0.name,"v_p15v0");
-	strcpy(sources->v_p15v0.description,"+15.0V Source");
-	sources->v_p15v0.mux_en = TELEMETRY_MUX_EN2;
-	sources->v_p15v0.mux_ch = TELEMETRY_MUX_CH4;
-	sources->v_p15v0.ad_ch = TELEMETRY_AD_CH4;
-	sources->v_p15v0.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
-
-	strcpy(sources->ccd_vdd.name,"ccd_vdd");
-	strcpy(sources->ccd_vdd.description,"CCD VDD Source");
-	sources->ccd_vdd.mux_en = TELEMETRY_MUX_EN2;
-	sources->ccd_vdd.mux_ch = TELEMETRY_MUX_CH0;
-	sources->ccd_vdd.ad_ch = TELEMETRY_AD_CH4;
-	sources->ccd_vdd.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
-
-	strcpy(sources->ccd_vr.name,"ccd_vr");
-	strcpy(sources->ccd_vr.description,"CCD VR Source");
-	sources->ccd_vr.mux_en = TELEMETRY_MUX_EN2;
-	sources->ccd_vr.mux_ch = TELEMETRY_MUX_CH1;
-	sources->ccd_vr.ad_ch = TELEMETRY_AD_CH4;
-	sources->ccd_vr.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
-
-	strcpy(sources->ccd_vsub.name,"ccd_vsub");
-	strcpy(sources->ccd_vsub.description,"CCD VSUB Source");
-	sources->ccd_vsub.mux_en = TELEMETRY_MUX_EN2;
-	sources->ccd_vsub.mux_ch = TELEMETRY_MUX_CH5;
-	sources->ccd_vsub.ad_ch = TELEMETRY_AD_CH4;
-	sources->ccd_vsub.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
-
-	strcpy(sources->ccd_vdrain.name,"ccd_vdrain");
-	strcpy(sources->ccd_vdrain.description,"CCD VDRAIN Source");
-	sources->ccd_vdrain.mux_en = TELEMETRY_MUX_EN2;
-	sources->ccd_vdrain.mux_ch = TELEMETRY_MUX_CH6;
-	sources->ccd_vdrain.ad_ch = TELEMETRY_AD_CH4;
-	sources->ccd_vdrain.gain = (float)TELEMETRY_GAIN_NUM/(float)TELEMETRY_GAIN_DEN;
+	// Initialize internal sources structure. Names and descriptions are
+	// constants, only pointers to them are stored.
+#define TELEMETRY_SOURCE_INIT(field, description, mux_en, mux_ch, ad_ch, gain) \
+	sources->field = (telemetry_source_t) { #field, description, mux_en, mux_ch, ad_ch, gain };
+	TELEMETRY_SOURCES(TELEMETRY_SOURCE_INIT)
+#undef TELEMETRY_SOURCE_INIT
 
 	return ret;
 }
@@ -342,7 +188,7 @@ int telemetry_read(telemetry_source_t *source, float *value)
 	// Set ADC to read value.
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_telemetry_i, 1);
+	ret = spi_trace_select(&spi_telemetry_i, 1);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
@@ -362,7 +208,8 @@ int telemetry_read(telemetry_source_t *source, float *value)
 				( TELEMETRY_SEQ_NOT 		<< TELEMETRY_SEQ_OFFSET		) |
 				( TELEMETRY_DOUT_TRI 		<< TELEMETRY_DOUT_OFFSET	);
 
-	ret = XSpi_Transfer(&spi_telemetry_i, buf, buf, 2);
+	ret = spi_trace_transfer(&spi_telemetry_i, buf, buf, 2);
+	telemetry_transfers++;
 
 	// If Transfer was successfully completed, go ahead.
 	if (ret != XST_SUCCESS ) {
@@ -377,32 +224,299 @@ int telemetry_read(telemetry_source_t *source, float *value)
 	buf[0] = ( TELEMETRY_CMD_NONE << TELEMETRY_CMD_OFFSET );
 	buf[1] = 0;
 
-	ret = XSpi_Transfer(&spi_telemetry_i, buf, buf, 2);
+	ret = spi_trace_transfer(&spi_telemetry_i, buf, buf, 2);
+	telemetry_transfers++;
 
 	uint16_t data = ( buf[0] << 8 | buf[1] );
-	int ad_ch 	= ( (data >> TELEMETRY_DATA_CHID_OFFSET) 	& TELEMETRY_DATA_CHID_MASK );
-	int s 		= ( (data >> TELEMETRY_DATA_SIGN_OFFSET) 	& TELEMETRY_DATA_SIGN_MASK );
-	int conv	= ( (data >> TELEMETRY_DATA_VAL_OFFSET) 	& TELEMETRY_DATA_VAL_MASK );
+	if (telemetry_convert(source, data, value) != 0) {
+		return -1;
+	}
 
-	// Check if it's a negative number.
-	if (s) {
-		conv = conv - TELEMETRY_AD_MAX_COUNT;
+	return ret;
+}
+
+int telemetry_read_all(telemetry_group_t *sources, float *values, int *status)
+{
+	int ret;
+	int i, k, n;
+	uint8_t buf[2];
+	uint8_t mux_en, mux_ch;
+
+	telemetry_source_t *src = (telemetry_source_t *) sources;
+
+	for (i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		status[i] = -1;
 	}
 
-	// Compute value.
-	float conv_f = conv;
-	if (ad_ch == source->ad_ch) {
-		conv_f = conv_f * source->gain;
-		conv_f = conv_f * (float)TELEMETRY_AD_MAX_VOLT;
-		conv_f = conv_f / (float)TELEMETRY_AD_MAX_COUNT;
-		*value = conv_f;
+	// Select slave for this device.
+	ret = spi_trace_select(&spi_telemetry_i, 1);
+	if (ret != XST_SUCCESS) {
+		return ret;
 	}
-	else {
+
+	// One sequence per mux enable.
+	for (mux_en = TELEMETRY_MUX_EN0; mux_en <= TELEMETRY_MUX_EN2; mux_en <<= 1)
+	{
+		// Channels used behind this mux.
+		uint8_t chmask = 0;
+		for (i=0; i<TELEMETRY_NSOURCES; i++)
+		{
+			if (src[i].mux_en == mux_en)
+			{
+				chmask |= (1 << src[i].ad_ch);
+			}
+		}
+		if (chmask == 0)
+		{
+			continue;
+		}
+
+		n = 0;
+		for (k=0; k<8; k++)
+		{
+			n += (chmask >> k) & 1;
+		}
+
+		// Write Sequence reg command.
+		// Packet format:
+		// BIT # || 15 |  14  | 13  |  12  |  11  |  10  |  9   |  8   |  7   |  6   |  5   | 4 | 3 | 2 | 1 | 0 ||
+		// 	 	 || W  |  RS1 | RS2 | VIN0 | VIN1 | VIN2 | VIN3 | VIN4 | VIN5 | VIN6 | VIN7 | 0 | 0 | 0 | 0 | 0 ||
+		uint16_t seq = 0;
+		for (k=0; k<8; k++)
+		{
+			if (chmask & (1 << k))
+			{
+				seq |= 1 << (TELEMETRY_SEQ_REG_VIN0_OFFSET - k);
+			}
+		}
+		buf[0] = ( TELEMETRY_CMD_WRITE_SEQ << TELEMETRY_CMD_OFFSET ) | (seq >> 8);
+		buf[1] = seq & 0xFF;
+
+		ret = spi_trace_transfer(&spi_telemetry_i, buf, buf, 2);
+		telemetry_transfers++;
+		if (ret != XST_SUCCESS ) {
+			return ret;
+		}
+
+		// Write Control reg command, converting the programmed sequence.
+		buf[0] = 	( TELEMETRY_CMD_WRITE_CTRL	<< TELEMETRY_CMD_OFFSET 	) |
+					( TELEMETRY_MODE_8_SINGLE	<< TELEMETRY_MODE_OFFSET 	);
+
+		buf[1] = 	( TELEMETRY_PMODE_NORMAL 	<< TELEMETRY_PMODE_OFFSET	) |
+					( TELEMETRY_CODING_TWOS 	<< TELEMETRY_CODING_OFFSET	) |
+					( TELEMETRY_REF_INT 		<< TELEMETRY_REF_OFFSET		) |
+					( TELEMETRY_SEQ_PRG 		<< TELEMETRY_SEQ_OFFSET		) |
+					( TELEMETRY_DOUT_TRI 		<< TELEMETRY_DOUT_OFFSET	);
+
+		ret = spi_trace_transfer(&spi_telemetry_i, buf, buf, 2);
+		telemetry_transfers++;
+		if (ret != XST_SUCCESS ) {
+			return ret;
+		}
+
+		// The sequencer keeps cycling over the channels, so the mux can be moved
+		// between conversions. Every result carries its channel id.
+		for (mux_ch = TELEMETRY_MUX_CH0; mux_ch <= TELEMETRY_MUX_CH7; mux_ch++)
+		{
+			int used = 0;
+			for (i=0; i<TELEMETRY_NSOURCES; i++)
+			{
+				used |= (src[i].mux_en == mux_en && src[i].mux_ch == mux_ch);
+			}
+			if (!used)
+			{
+				continue;
+			}
+
+			uint32_t pins;
+			pins = 	( mux_en	<< TELEMETRY_MUX_EN_OFFSET ) |
+					( mux_ch	<< TELEMETRY_MUX_CH_OFFSET );
+
+			XGpio_DiscreteWrite(&gpio_telemetry_i, 1, pins);
+
+			for (k=0; k<n; k++)
+			{
+				buf[0] = ( TELEMETRY_CMD_NONE << TELEMETRY_CMD_OFFSET );
+				buf[1] = 0;
+
+				ret = spi_trace_transfer(&spi_telemetry_i, buf, buf, 2);
+				telemetry_transfers++;
+				if (ret != XST_SUCCESS ) {
+					return ret;
+				}
+
+				uint16_t data = ( buf[0] << 8 | buf[1] );
+				int ad_ch = ( (data >> TELEMETRY_DATA_CHID_OFFSET) & TELEMETRY_DATA_CHID_MASK );
+				for (i=0; i<TELEMETRY_NSOURCES; i++)
+				{
+					if (src[i].mux_en == mux_en && src[i].mux_ch == mux_ch && src[i].ad_ch == ad_ch)
+					{
+						status[i] = telemetry_convert(&src[i], data, &values[i]);
+					}
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+uint32_t telemetry_get_transfers(void)
+{
+	return telemetry_transfers;
+}
+
+static void telemetry_scan_clear(telemetry_scan_t *scan)
+{
+	memset(scan->cache, 0, sizeof(scan->cache));
+	scan->idx = 0;
+	scan->vars.cycles.value = 0;
+}
+
+void telemetry_scan_init(telemetry_scan_t *scan)
+{
+	scan->vars.enable.value 	= TELEMETRY_SCAN_ON;
+	scan->vars.enable.min 		= TELEMETRY_SCAN_OFF;
+	scan->vars.enable.max 		= TELEMETRY_SCAN_ON;
+	scan->vars.enable.name = "telScan";
+
+	scan->vars.period.value 	= TELEMETRY_SCAN_PERIOD_DEFAULT;
+	scan->vars.period.min 		= TELEMETRY_SCAN_PERIOD_MIN;
+	scan->vars.period.max 		= TELEMETRY_SCAN_PERIOD_MAX;
+	scan->vars.period.name = "telScanPer";
+
+	scan->vars.cycles.value 	= 0;
+	scan->vars.cycles.min 		= 0;
+	scan->vars.cycles.max 		= 0;
+	scan->vars.cycles.name = "telScanCycles";
+
+	scan->last_tick = tget_ms();
+	telemetry_scan_clear(scan);
+}
+
+int telemetry_scan_change_status(telemetry_scan_t *scan, telemetry_var_t *var, uint16_t value)
+{
+	// Read only.
+	if (var == &(scan->vars.cycles))
+	{
 		return -1;
 	}
 
+	if (value >= var->min && value <= var->max)
+	{
+		// Starting again: old min/max and history are not valid anymore.
+		if (var == &(scan->vars.enable) && value == TELEMETRY_SCAN_ON && var->value == TELEMETRY_SCAN_OFF)
+		{
+			telemetry_scan_clear(scan);
+			scan->last_tick = tget_ms();
+		}
+		var->value = value;
+	} else {
+		return -1;
+	}
+
+	return 0;
+}
+
+int telemetry_scan_poll(telemetry_scan_t *scan, telemetry_group_t *sources)
+{
+	if (scan->vars.enable.value == TELEMETRY_SCAN_OFF)
+	{
+		return 0;
+	}
+
+	uint32_t now = tget_ms();
+	if ((now - scan->last_tick) < scan->vars.period.value)
+	{
+		return 0;
+	}
+	scan->last_tick = now;
+
+	telemetry_source_t *source = (telemetry_source_t *) sources + scan->idx;
+	telemetry_cache_t *cache = &(scan->cache[scan->idx]);
+	float value;
+
+	int ret = 0;
+
+	if (telemetry_read(source, &value) == 0)
+	{
+		ret = 1;
+		if (cache->nread == 0 || value < cache->min)
+		{
+			cache->min = value;
+		}
+		if (cache->nread == 0 || value > cache->max)
+		{
+			cache->max = value;
+		}
+		cache->value = value;
+		cache->tstamp = now;
+		scan->last = scan->idx;
+		cache->nread++;
+		cache->hist[cache->hist_idx] = value;
+		cache->hist_idx = (cache->hist_idx + 1) % TELEMETRY_HIST_LENGTH;
+	}
+	else
+	{
+		cache->nerr++;
+	}
+
+	// Next source.
+	scan->idx++;
+	if (scan->idx >= TELEMETRY_NSOURCES)
+	{
+		scan->idx = 0;
+		scan->vars.cycles.value++;
+	}
 
 	return ret;
 }
 
+telemetry_cache_t *telemetry_scan_get(telemetry_scan_t *scan, telemetry_group_t *sources, telemetry_source_t *source)
+{
+	int idx = source - (telemetry_source_t *) sources;
 
+	if (scan->vars.enable.value == TELEMETRY_SCAN_OFF || idx < 0 || idx >= TELEMETRY_NSOURCES)
+	{
+		return NULL;
+	}
+	if (scan->cache[idx].nread == 0)
+	{
+		return NULL;
+	}
+
+	return &(scan->cache[idx]);
+}
+
+int telemetry_scan_read(telemetry_scan_t *scan, telemetry_group_t *sources, telemetry_source_t *source, float *value)
+{
+	telemetry_cache_t *cache = telemetry_scan_get(scan, sources, source);
+
+	if (cache == NULL)
+	{
+		return telemetry_read(source, value);
+	}
+
+	*value = cache->value;
+	return 0;
+}
+
+int telemetry_scan_read_all(telemetry_scan_t *scan, telemetry_group_t *sources, float *values, int *status)
+{
+	int i;
+	telemetry_source_t *src = (telemetry_source_t *) sources;
+
+	// Nothing cached: one sequencer sweep.
+	if (scan->vars.enable.value == TELEMETRY_SCAN_OFF)
+	{
+		return telemetry_read_all(sources, values, status);
+	}
+
+	for (i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		status[i] = telemetry_scan_read(scan, sources, src+i, values+i);
+	}
+
+	return 0;
+}
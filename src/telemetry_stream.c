@@ -0,0 +1,163 @@
+/*
+ * telemetry_stream.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: lstefana
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "telemetry_stream.h"
+#include "io_func.h"
+#include "interrupt.h"
+
+static uint8_t telemetry_stream_buffer[TELEMETRY_STREAM_FRAME_LENGTH];
+
+void telemetry_stream_init(system_state_t *sys)
+{
+	telemetry_stream_t *stream = &(sys->telemetry_stream);
+
+	stream->vars.enable.value 	= TELEMETRY_STREAM_OFF;
+	stream->vars.enable.min 	= TELEMETRY_STREAM_OFF;
+	stream->vars.enable.max 	= TELEMETRY_STREAM_ON;
+	stream->vars.enable.name = "telStream";
+
+	stream->vars.period.value 	= TELEMETRY_STREAM_PERIOD_DEFAULT;
+	stream->vars.period.min 	= TELEMETRY_STREAM_PERIOD_MIN;
+	stream->vars.period.max 	= TELEMETRY_STREAM_PERIOD_MAX;
+	stream->vars.period.name = "telStrmPer";
+
+	// Read only variable.
+	stream->vars.count.value 	= 0;
+	stream->vars.count.min 		= 0;
+	stream->vars.count.max 		= 0;
+	stream->vars.count.name = "telStrmCount";
+
+	stream->last_tick 	= tget_ms();
+	stream->seq 		= 0;
+}
+
+int telemetry_stream_change_status(system_state_t *sys, telemetry_var_t *var, uint16_t value)
+{
+	telemetry_stream_t *stream = &(sys->telemetry_stream);
+
+	// Read only.
+	if (var == &(stream->vars.count))
+	{
+		return -1;
+	}
+
+	if (value < var->min || value > var->max)
+	{
+		return -1;
+	}
+
+	// First frame goes out right away.
+	if (var == &(stream->vars.enable) && value == TELEMETRY_STREAM_ON && var->value == TELEMETRY_STREAM_OFF)
+	{
+		stream->last_tick = tget_ms() - stream->vars.period.value;
+	}
+	var->value = value;
+
+	return 0;
+}
+
+static void telemetry_stream_build(system_state_t *sys, uint32_t now)
+{
+	telemetry_stream_t *stream = &(sys->telemetry_stream);
+	telemetry_source_t *src = (telemetry_source_t *) &(sys->telemetry);
+	uint8_t *p = telemetry_stream_buffer + TELEMETRY_STREAM_HEADER_LENGTH;
+	float values[TELEMETRY_NSOURCES];
+	int status[TELEMETRY_NSOURCES];
+	int i;
+
+	telemetry_scan_read_all(&(sys->telemetry_scan), &(sys->telemetry), values, status);
+
+	for (i=0; i<TELEMETRY_NSOURCES; i++)
+	{
+		union {
+			float f;
+			uint32_t u;
+		} conv;
+		uint32_t tstamp = now;
+
+		// Cached values keep the time they were read.
+		telemetry_cache_t *cache = telemetry_scan_get(&(sys->telemetry_scan), &(sys->telemetry), src+i);
+		if (cache != NULL)
+		{
+			tstamp = cache->tstamp;
+		}
+
+		if (status[i] == 0)
+		{
+			conv.f = values[i];
+		}
+		else
+		{
+			// Quiet NaN.
+			conv.u = 0x7FC00000;
+			tstamp = 0;
+		}
+
+		io_put_u32(p, tstamp);
+		io_put_u32(p + 4, conv.u);
+		p += TELEMETRY_STREAM_ENTRY_LENGTH;
+	}
+
+	// Header.
+	p = telemetry_stream_buffer;
+	io_put_u32(p, TELEMETRY_STREAM_MAGIC);
+	io_put_u16(p + 4, TELEMETRY_STREAM_VERSION);
+	io_put_u16(p + 6, TELEMETRY_NSOURCES);
+	io_put_u32(p + 8, stream->seq);
+	io_put_u32(p + 12, now);
+	io_put_u32(p + 16, io_crc32(0, 	telemetry_stream_buffer + TELEMETRY_STREAM_HEADER_LENGTH,
+													TELEMETRY_STREAM_FRAME_LENGTH - TELEMETRY_STREAM_HEADER_LENGTH));
+}
+
+int telemetry_stream_poll(system_state_t *sys)
+{
+	telemetry_stream_t *stream = &(sys->telemetry_stream);
+
+	// Previous frame, it goes out in the background over ethernet.
+	int pending = io_put_bin_poll();
+	if (pending < 0 && stream->vars.enable.value == TELEMETRY_STREAM_ON)
+	{
+		// Nobody reads the frames. Straight to the uart, mprint would wait on
+		// the same host.
+		stream->vars.enable.value = TELEMETRY_STREAM_OFF;
+		print("### Telemetry stream: frame not taken by the host, telStream off\r\n");
+	}
+
+	if (stream->vars.enable.value == TELEMETRY_STREAM_OFF)
+	{
+		return 0;
+	}
+
+	uint32_t now = tget_ms();
+	if ((now - stream->last_tick) < stream->vars.period.value)
+	{
+		return 0;
+	}
+	stream->last_tick = now;
+
+	// Still going out: this frame is skipped, the gap shows in seq.
+	if (pending > 0)
+	{
+		stream->seq++;
+		return 0;
+	}
+
+	telemetry_stream_build(sys, now);
+	if (io_put_bin_async("Telemetry", telemetry_stream_buffer, TELEMETRY_STREAM_FRAME_LENGTH) != 0)
+	{
+		stream->seq++;
+		return 0;
+	}
+
+	stream->seq++;
+	stream->vars.count.value++;
+
+	return 1;
+}
@@ -2,10 +2,41 @@
 #include <stdlib.h>
 
 #include "xuartlite.h"
+#include "xuartlite_l.h"
 
 #include "uart.h"
 #include "defines.h"
 #include "flash.h"
+#include "interrupt.h"
+#include "io_func.h"
+
+// Console, the UART opened by uart_init.
+#define UART_BASEADDR			STDOUT_BASEADDRESS
+
+// Its interrupt, if wired to the controller.
+#ifdef XPAR_INTC_0_UARTLITE_0_VEC_ID
+#define XINTC_INT_SRC_UART		XPAR_INTC_0_UARTLITE_0_VEC_ID
+#endif
+
+typedef struct {
+	// Rings. Indexes run free, the isr writes rx_head and tx_tail.
+	uint8_t rx[UART_RX_LENGTH];
+	volatile uint32_t rx_head;
+	volatile uint32_t rx_tail;
+	uint8_t tx[UART_TX_LENGTH];
+	volatile uint32_t tx_head;
+	volatile uint32_t tx_tail;
+
+	uint8_t irq;
+
+	// Counters.
+	volatile uint32_t rx_bytes;
+	volatile uint32_t rx_dropped;		// Rx ring full.
+	volatile uint32_t rx_overruns;		// Fifo full before the isr ran.
+	uint32_t tx_bytes;
+} uart_state_t;
+
+static uart_state_t uart_state;
 
 XUartLite Uart;
 
@@ -14,16 +45,202 @@ int uart_init(uint16_t device_id)
 	return XUartLite_Initialize(&Uart, device_id);
 }
 
+// Rx fifo into the rx ring.
+static void uart_rx_drain(void)
+{
+	uint32_t sr;
+
+	while ((sr = XUartLite_ReadReg(UART_BASEADDR, XUL_STATUS_REG_OFFSET)) & XUL_SR_RX_FIFO_VALID_DATA)
+	{
+		uint8_t c = XUartLite_ReadReg(UART_BASEADDR, XUL_RX_FIFO_OFFSET);
+
+		if (sr & XUL_SR_OVERRUN_ERROR)
+		{
+			uart_state.rx_overruns++;
+		}
+
+		if (uart_state.rx_head - uart_state.rx_tail < UART_RX_LENGTH)
+		{
+			uart_state.rx[uart_state.rx_head & (UART_RX_LENGTH - 1)] = c;
+			uart_state.rx_head++;
+			uart_state.rx_bytes++;
+		}
+		else
+		{
+			uart_state.rx_dropped++;
+		}
+	}
+}
+
+// Tx ring into the tx fifo.
+static void uart_tx_fill(void)
+{
+	while (	uart_state.tx_tail != uart_state.tx_head &&
+			!(XUartLite_ReadReg(UART_BASEADDR, XUL_STATUS_REG_OFFSET) & XUL_SR_TX_FIFO_FULL) )
+	{
+		XUartLite_WriteReg(UART_BASEADDR, XUL_TX_FIFO_OFFSET, uart_state.tx[uart_state.tx_tail & (UART_TX_LENGTH - 1)]);
+		uart_state.tx_tail++;
+	}
+}
+
+// Rx fifo not empty any more, or tx fifo empty.
+static void uart_isr(void *ref)
+{
+	uart_rx_drain();
+	uart_tx_fill();
+}
+
+int uart_irq_init(void)
+{
+#ifdef XINTC_INT_SRC_UART
+	int status = intc_connect(XINTC_INT_SRC_UART, (XInterruptHandler) uart_isr, NULL);
+	if (status != XST_SUCCESS)
+	{
+		return status;
+	}
+
+	XUartLite_WriteReg(UART_BASEADDR, XUL_CONTROL_REG_OFFSET, XUL_CR_ENABLE_INTR);
+	uart_state.irq = 1;
+	intc_enable(XINTC_INT_SRC_UART);
+
+	// Bytes already in the fifo raised no interrupt.
+	intc_disable(XINTC_INT_SRC_UART);
+	uart_rx_drain();
+	intc_enable(XINTC_INT_SRC_UART);
+
+	return XST_SUCCESS;
+#else
+	return XST_FAILURE;
+#endif
+}
+
+unsigned int uart_rcv(uint8_t *buf, unsigned int n)
+{
+	unsigned int i = 0;
+
+	if (!uart_state.irq)
+	{
+		uart_rx_drain();
+	}
+
+	while (i < n && uart_state.rx_tail != uart_state.rx_head)
+	{
+		buf[i++] = uart_state.rx[uart_state.rx_tail & (UART_RX_LENGTH - 1)];
+		uart_state.rx_tail++;
+	}
+
+	return i;
+}
+
+void uart_putc(uint8_t c)
+{
+	uart_state.tx_bytes++;
+
+	if (!uart_state.irq)
+	{
+		XUartLite_SendByte(UART_BASEADDR, c);
+		return;
+	}
+
+	// Room is made by the isr.
+	while (uart_state.tx_head - uart_state.tx_tail >= UART_TX_LENGTH);
+
+#ifdef XINTC_INT_SRC_UART
+	// The fifo is only refilled on the empty interrupt, so it is started here
+	// when idle. Isr off, so both do not write it at once.
+	intc_disable(XINTC_INT_SRC_UART);
+	uart_state.tx[uart_state.tx_head & (UART_TX_LENGTH - 1)] = c;
+	uart_state.tx_head++;
+	uart_tx_fill();
+	intc_enable(XINTC_INT_SRC_UART);
+#endif
+}
 
-unsigned int uart_rcv(uint8_t *buf)
+void uart_puts(const char *str)
 {
-	/*
-	 * Receive the buffer from the UartLite waiting til there's data by (block),
-	 * if the specified number of bytes was not received successfully, then
-	 * an error occurred.
-	 */
+	while (*str)
+	{
+		uart_putc((uint8_t) *str++);
+	}
+}
+
+// print and xil_printf write through here. Replaces the polled one of the BSP.
+void outbyte(char c)
+{
+	uart_putc((uint8_t) c);
+}
+
+void uart_line_clear(uart_line_t *line)
+{
+	line->buf[0] 	= '\0';
+	line->idx 		= 0;
+	line->dropped 	= 0;
+}
+
+int uart_line_put(uart_line_t *line, uint8_t c, int echo)
+{
+	// Enter: the line is complete, unless chars were dropped. A truncated
+	// command must not run.
+	if (c == ASCII_CHAR_CR)
+	{
+		if (echo != UART_ECHO_OFF)
+		{
+			uart_puts("\r\n");
+		}
+		return (line->dropped > 0) ? -1 : 1;
+	}
+
+	// Other chars delete the line.
+	if (	c == ASCII_CHAR_BS 	||
+			c == ASCII_CHAR_CAN ||
+			c == ASCII_CHAR_EM 	||
+			c == ASCII_CHAR_SUB ||
+			c == ASCII_CHAR_ESC ||
+			c == ASCII_CHAR_FS 	||
+			c == ASCII_CHAR_DEL )
+	{
+		uart_line_clear(line);
+		if (echo != UART_ECHO_OFF)
+		{
+			uart_puts("\33[2K");
+			uart_puts("\r\n");
+		}
+		return 0;
+	}
+
+	// Room for the terminator is kept.
+	if (line->idx >= USERCOMMANDLENGTH - 1)
+	{
+		line->dropped++;
+		return 0;
+	}
+	line->buf[line->idx++] 	= c;
+	line->buf[line->idx] 	= '\0';
 
-	return XUartLite_Recv(&Uart, buf, 1);
+	if (echo == UART_ECHO_ON)
+	{
+		uart_putc(c);
+	}
+	else if (echo == UART_ECHO_MASK)
+	{
+		uart_putc('*');
+	}
+
+	return 0;
+}
+
+void uart_print(void)
+{
+	char str[120];
+
+	mprint("### UART ###\r\n");
+	io_sprintf(str, "Mode %s, rx %u bytes (%u in ring), tx %u bytes (%u in ring)\r\n",
+			uart_state.irq ? "interrupt" : "polled",
+			uart_state.rx_bytes, uart_state.rx_head - uart_state.rx_tail,
+			uart_state.tx_bytes, uart_state.tx_head - uart_state.tx_tail);
+	mprint(str);
+	io_sprintf(str, "Rx dropped %u, fifo overruns %u\r\n", uart_state.rx_dropped, uart_state.rx_overruns);
+	mprint(str);
 }
 
 void uart_eraseBuffer(uint8_t *buf, unsigned int n)
@@ -106,6 +323,10 @@ void uart_parseCmd(char *buf)
 				uart_cmdRead(commandWord[1].word, commandWord[2].word);
 			}
 		}
+		else if (strcmp(commandWord[0].word, "bench") == 0)
+		{
+			uart_cmdBench(commandWord[1].word, commandWord[2].word);
+		}
 
 		break;
 
@@ -130,6 +351,7 @@ void uart_printMenu()
 	print("\r\nChose from the options below: \r\n");
 	print("read <addr> <n>\t\t: read \'n\' bytes starting at \'addr\'\r\n");
 	print("read <addr>\t\t: read one page containing \'addr\'\r\n");
+	print("bench <addr> <n>\t: time a read of \'n\' bytes starting at \'addr\'\r\n");
 	print("write byte <addr> <val>\t: write byte \'val\' at \'addr\'\r\n");
 	print("write word <addr> <val>\t: write word (16 bits) \'val\' at \'addr\'\r\n");
 	print("write qword <addr> <val>: write qword (32 bits) \'val\' at \'addr\'\r\n");
@@ -162,6 +384,15 @@ void uart_cmdRead(char *addr, char *nBytes)
 	flash_read(addrI, nBytesI);
 }
 
+void uart_cmdBench(char *addr, char *nBytes)
+{
+	// Convert to number.
+	uint32_t addrI = str2num(addr);
+	uint32_t nBytesI = str2num(nBytes);
+
+	flash_benchRead(addrI, nBytesI);
+}
+
 void uart_cmdReadByte(char *addr)
 {
 	// Convert to number.
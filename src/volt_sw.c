@@ -14,6 +14,7 @@
 #include <xgpio.h>
 #include "interrupt.h"
 #include "volt_sw.h"
+#include "spi_trace.h"
 
 /******************************************************************************/
 /************************ Variables Definitions *******************************/
@@ -40,6 +41,9 @@ int volt_sw_init(uint32_t spi_device_id, uint32_t gpio_device_id, bias_sw_t *bia
 	uint32_t base_addr		= 0;
 	uint32_t control_val 	= 0;
 
+	// Count its traffic.
+	spi_trace_register(&spi_volt_sw_i, SPI_TRACE_VOLT_SW);
+
 	// Init spi_volt_sw_i structure.
 	ret = XSpi_Initialize(&spi_volt_sw_i, spi_device_id);
 	if (ret != XST_SUCCESS) {
@@ -109,11 +113,11 @@ int volt_sw_init(uint32_t spi_device_id, uint32_t gpio_device_id, bias_sw_t *bia
 	// Init gpio state structure.
 	gpio_sw->sw_group.clr.status = 0;
 	gpio_sw->sw_group.clr.bit_position = GPIO_VOLT_SW_CLR;
-	strcpy(gpio_sw->sw_group.clr.name,"clr");
+	gpio_sw->sw_group.clr.name = "clr";
 
 	gpio_sw->sw_group.le_n.status = 1;
 	gpio_sw->sw_group.le_n.bit_position = GPIO_VOLT_SW_LE_N;
-	strcpy(gpio_sw->sw_group.le_n.name,"le_n");
+	gpio_sw->sw_group.le_n.name = "le_n";
 
 	gpio_sw->state = 0x2;
 
@@ -124,35 +128,35 @@ int volt_sw_init(uint32_t spi_device_id, uint32_t gpio_device_id, bias_sw_t *bia
 	// Init switch state structure.
 	bias_sw->sw_group.ccd_vdd_sw.status = 0;
 	bias_sw->sw_group.ccd_vdd_sw.bit_position = VOLT_SW_CCD_VDD_SWITCH;
-	strcpy(bias_sw->sw_group.ccd_vdd_sw.name,"vdd_sw");
+	bias_sw->sw_group.ccd_vdd_sw.name = "vdd_sw";
 
 	bias_sw->sw_group.ccd_vdrain_sw.status = 0;
 	bias_sw->sw_group.ccd_vdrain_sw.bit_position = VOLT_SW_CCD_VDRAIN_SWITCH;
-	strcpy(bias_sw->sw_group.ccd_vdrain_sw.name,"vdrain_sw");
+	bias_sw->sw_group.ccd_vdrain_sw.name = "vdrain_sw";
 
 	bias_sw->sw_group.ccd_vsub_sw.status = 0;
 	bias_sw->sw_group.ccd_vsub_sw.bit_position = VOLT_SW_CCD_VSUB_SWITCH;
-	strcpy(bias_sw->sw_group.ccd_vsub_sw.name,"vsub_sw");
+	bias_sw->sw_group.ccd_vsub_sw.name = "vsub_sw";
 
 	bias_sw->sw_group.vsub_load_sw.status = 0;
 	bias_sw->sw_group.vsub_load_sw.bit_position = VOLT_SW_VSUB_LOAD_SWITCH;
-	strcpy(bias_sw->sw_group.vsub_load_sw.name,"vsub_load_sw");
+	bias_sw->sw_group.vsub_load_sw.name = "vsub_load_sw";
 
 	bias_sw->sw_group.vsub_rdiv_sw.status = 0;
 	bias_sw->sw_group.vsub_rdiv_sw.bit_position = VOLT_SW_VSUB_RDIV_SWITCH;
-	strcpy(bias_sw->sw_group.vsub_rdiv_sw.name,"vsub_rdiv_sw");
+	bias_sw->sw_group.vsub_rdiv_sw.name = "vsub_rdiv_sw";
 
 	bias_sw->sw_group.ccd_vr_sw.status = 0;
 	bias_sw->sw_group.ccd_vr_sw.bit_position = VOLT_SW_CCD_VR_SWITCH;
-	strcpy(bias_sw->sw_group.ccd_vr_sw.name,"vr_sw");
+	bias_sw->sw_group.ccd_vr_sw.name = "vr_sw";
 
 	bias_sw->sw_group.p15v_sw.status = 0;
 	bias_sw->sw_group.p15v_sw.bit_position = VOLT_SW_P15V_SWITCH;
-	strcpy(bias_sw->sw_group.p15v_sw.name,"p15v_sw");
+	bias_sw->sw_group.p15v_sw.name = "p15v_sw";
 
 	bias_sw->sw_group.m15v_sw.status = 0;
 	bias_sw->sw_group.m15v_sw.bit_position = VOLT_SW_M15V_SWITCH;
-	strcpy(bias_sw->sw_group.m15v_sw.name,"m15v_sw");
+	bias_sw->sw_group.m15v_sw.name = "m15v_sw";
 
 	// Set values to hardware.
 	volt_sw_state_set(&(bias_sw->sw_group.ccd_vdd_sw)		, &(bias_sw->state), bias_sw->sw_group.ccd_vdd_sw.status);
@@ -237,13 +241,13 @@ int volt_sw_wr(uint16_t *state)
 	buf[1] = (*state & VOLT_SW_DATA_LOW_MASK);
 
 	// Select slave for this device.
-	ret = XSpi_SetSlaveSelect(&spi_volt_sw_i, 1);
+	ret = spi_trace_select(&spi_volt_sw_i, 1);
 	if (ret != XST_SUCCESS) {
 		return ret;
 	}
 
 	// Send data.
-	ret = XSpi_Transfer(&spi_volt_sw_i, buf, NULL, 2);
+	ret = spi_trace_transfer(&spi_volt_sw_i, buf, NULL, 2);
 
 	// Latch data to copy shift register into internal latch.
 	XGpio_DiscreteWrite(&gpio_volt_sw_i, 1, 0x0);